@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""
+Write the precision variants of an fp32 model next to it, for onnx_runner --variants.
+
+For models/<dir>/<stem>.onnx this writes, in the same directory:
+  <stem>_fp16.onnx          fp16 weights and compute, fp32 inputs/outputs kept
+  <stem>_int8_dynamic.onnx  int8 weights, activations quantized at run time
+  <stem>_int8_static.onnx   int8 QDQ weights and activations, calibrated ahead of time
+
+Inputs and outputs keep the original's names and types, so the runner feeds every
+variant the same tensors and compares its outputs with the original's. Static
+quantization calibrates on --calibration data (.npy with a leading sample
+dimension, like --input-file) or, without it, on random inputs in --float-range;
+real data gives a far better int8_static model.
+
+Usage:
+  python3 scripts/make_variants.py <onnx_path_relative_to_models> [--variants=fp16,int8_static]
+      [--calibration=NAME=PATH.npy ...] [--shape=DIM=N,...] [--push]
+  ./scripts/measure_model.sh <onnx_path_relative_to_models> --variants
+
+Needs onnx, onnxruntime and onnxconverter-common (requirements.txt).
+"""
+
+import argparse
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+import numpy as np
+
+MODELS_DIR = Path('./models')
+DEVICE_MODELS_DIR = '/data/local/tmp/models'
+
+# Same names as Config::MODEL_VARIANTS in src/config.hpp
+VARIANTS = ['fp16', 'int8_dynamic', 'int8_static']
+
+CALIBRATION_SAMPLES = 32
+
+# ONNX Runtime input types → NumPy
+NUMPY_TYPES = {
+    'tensor(float)': np.float32,
+    'tensor(double)': np.float64,
+    'tensor(float16)': np.float16,
+    'tensor(int8)': np.int8,
+    'tensor(uint8)': np.uint8,
+    'tensor(int16)': np.int16,
+    'tensor(uint16)': np.uint16,
+    'tensor(int32)': np.int32,
+    'tensor(uint32)': np.uint32,
+    'tensor(int64)': np.int64,
+    'tensor(uint64)': np.uint64,
+    'tensor(bool)': np.bool_,
+}
+
+
+def log(message: str):
+    print(f"[{time.strftime('%H:%M:%S')}] {message}", flush=True)
+
+
+def variant_path(model_path: Path, variant: str) -> Path:
+    return model_path.with_name(f"{model_path.stem}_{variant}{model_path.suffix}")
+
+
+def parse_shape(text: str) -> dict:
+    """'batch=8,seq=128' → {'batch': 8, 'seq': 128}, as the runner's --shape."""
+    dims = {}
+    for item in filter(None, text.split(',')):
+        name, value = item.split('=', 1)
+        dims[name] = int(value)
+    return dims
+
+
+class CalibrationReader:
+    """Feeds quantize_static one sample at a time, from files or random data."""
+
+    def __init__(self, model_path: Path, files: dict, samples: int, float_range: tuple, dims: dict, seed: int):
+        import onnxruntime as ort
+
+        session = ort.InferenceSession(str(model_path), providers=['CPUExecutionProvider'])
+        rng = np.random.default_rng(seed)
+        data = {}
+        for model_input in session.get_inputs():
+            if model_input.name in files:
+                data[model_input.name] = np.load(files[model_input.name], mmap_mode='r')
+                continue
+            dtype = NUMPY_TYPES.get(model_input.type)
+            if dtype is None:
+                raise ValueError(f"Input '{model_input.name}' has type {model_input.type}; pass --calibration for it")
+            # Symbolic or unknown dimensions take --shape values, else 1 (like the runner)
+            shape = [dim if isinstance(dim, int) and dim > 0 else dims.get(dim, 1) for dim in model_input.shape]
+            if np.issubdtype(dtype, np.floating):
+                values = rng.uniform(float_range[0], float_range[1], size=[samples] + shape)
+            elif dtype == np.bool_:
+                values = rng.integers(0, 2, size=[samples] + shape)
+            else:
+                values = rng.integers(0, 100, size=[samples] + shape)
+            data[model_input.name] = values.astype(dtype)
+
+        count = min(len(values) for values in data.values())
+        self.samples = [{name: np.asarray(values[i]) for name, values in data.items()} for i in range(count)]
+        self.position = 0
+
+    def get_next(self):
+        if self.position >= len(self.samples):
+            return None
+        self.position += 1
+        return self.samples[self.position - 1]
+
+    def rewind(self):
+        self.position = 0
+
+
+def make_fp16(model_path: Path, output_path: Path):
+    import onnx
+    from onnxconverter_common import float16
+
+    model = onnx.load(str(model_path))
+    # keep_io_types: the variant takes and returns the original's fp32 tensors
+    onnx.save(float16.convert_float_to_float16(model, keep_io_types=True), str(output_path))
+
+
+def make_int8_dynamic(model_path: Path, output_path: Path):
+    from onnxruntime.quantization import QuantType, quantize_dynamic
+
+    quantize_dynamic(str(model_path), str(output_path), weight_type=QuantType.QInt8)
+
+
+def make_int8_static(model_path: Path, output_path: Path, reader: CalibrationReader):
+    from onnxruntime.quantization import QuantFormat, QuantType, quantize_static
+    from onnxruntime.quantization.shape_inference import quant_pre_process
+
+    with tempfile.TemporaryDirectory() as tmp:
+        # Shape inference and graph cleanup make more nodes quantizable; optional
+        source = Path(tmp) / 'preprocessed.onnx'
+        try:
+            quant_pre_process(str(model_path), str(source))
+        except Exception as e:
+            log(f"  ⚠ Warning: Pre-processing failed ({e}), quantizing the model as is")
+            source = model_path
+        quantize_static(str(source), str(output_path), reader, quant_format=QuantFormat.QDQ,
+                        activation_type=QuantType.QUInt8, weight_type=QuantType.QInt8)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('model', help='fp32 .onnx model relative to models/')
+    parser.add_argument('--variants', default=','.join(VARIANTS),
+                        help=f"Comma-separated variants to write (default: {','.join(VARIANTS)})")
+    parser.add_argument('--calibration', action='append', default=[], metavar='NAME=PATH',
+                        help='Calibration data for input NAME (.npy, leading sample dimension; repeatable)')
+    parser.add_argument('--calibration-samples', type=int, default=CALIBRATION_SAMPLES,
+                        help=f"Random calibration samples without --calibration (default: {CALIBRATION_SAMPLES})")
+    parser.add_argument('--float-range', default='0:1', help='Range of random float calibration data (default: 0:1)')
+    parser.add_argument('--shape', default='', help='Values for dynamic dimensions, e.g. batch=1,seq=128')
+    parser.add_argument('--seed', type=int, default=0, help='Seed of the random calibration data')
+    parser.add_argument('--force', action='store_true', help='Overwrite existing variants')
+    parser.add_argument('--push', action='store_true', help=f"adb push the variants to {DEVICE_MODELS_DIR}")
+    args = parser.parse_args()
+
+    model_path = MODELS_DIR / args.model
+    if not model_path.is_file():
+        log(f"ERROR: Model file not found: {model_path}")
+        return 1
+    variants = [variant for variant in args.variants.split(',') if variant]
+    unknown = [variant for variant in variants if variant not in VARIANTS]
+    if unknown:
+        log(f"ERROR: Unknown variant(s): {', '.join(unknown)} (known: {', '.join(VARIANTS)})")
+        return 1
+
+    written = []
+    failed = False
+    for variant in variants:
+        output_path = variant_path(model_path, variant)
+        if output_path.exists() and not args.force:
+            log(f"  ℹ Keeping existing {output_path} (--force to rewrite)")
+            written.append(output_path)
+            continue
+        log(f"Writing {variant} variant: {output_path}")
+        try:
+            if variant == 'fp16':
+                make_fp16(model_path, output_path)
+            elif variant == 'int8_dynamic':
+                make_int8_dynamic(model_path, output_path)
+            else:
+                files = dict(item.split('=', 1) for item in args.calibration)
+                low, high = (float(value) for value in args.float_range.split(':'))
+                reader = CalibrationReader(model_path, files, args.calibration_samples, (low, high),
+                                           parse_shape(args.shape), args.seed)
+                if not files:
+                    log(f"  ⚠ Warning: Calibrating on {len(reader.samples)} random samples; "
+                        f"pass --calibration for representative int8 ranges")
+                make_int8_static(model_path, output_path, reader)
+        except Exception as e:
+            log(f"  ✗ Failed to write {variant} variant: {e}")
+            failed = True
+            continue
+        log(f"  ✓ {output_path} ({output_path.stat().st_size / 1e6:.1f} MB)")
+        written.append(output_path)
+
+    if args.push:
+        for path in written:
+            device_path = f"{DEVICE_MODELS_DIR}/{path.relative_to(MODELS_DIR).as_posix()}"
+            subprocess.run(['adb', 'push', str(path), device_path], check=True, stdout=subprocess.DEVNULL)
+            log(f"  ✓ Pushed: {device_path}")
+
+    log(f"Benchmark the family with: ./scripts/measure_model.sh {args.model} --variants")
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
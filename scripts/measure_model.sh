@@ -8,14 +8,20 @@
 
 set -euo pipefail
 
-if [ $# -ne 1 ]; then
-  echo "Usage: $0 <onnx_path_relative_to_models>"
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <onnx_path_relative_to_models> [runner options...]"
   echo "Example: $0 model.onnx"
   echo "Example: $0 zi_t/model.onnx"
+  echo "Example: $0 model.onnx --cold-load"
+  echo "Example: $0 model.onnx --variants   # with its fp16 / int8 variants (scripts/make_variants.py)"
+  echo "Example: $0 zi_t            # batch: every model under models/zi_t in one process"
+  echo "Example: $0 manifest.txt    # batch: models listed in models/manifest.txt"
   exit 1
 fi
 
 ONNX_RELATIVE_PATH="$1"
+shift
+RUNNER_OPTIONS="$*"
 DEVICE_BIN="/data/local/tmp/onnx_runner"
 DEVICE_MODEL_PATH="/data/local/tmp/models/${ONNX_RELATIVE_PATH}"
 OUTPUT_DIR="./measurements"
@@ -29,8 +35,8 @@ log() {
     echo "[$(date '+%H:%M:%S')] $1"
 }
 
-# Check if model exists locally
-if [ ! -f "./models/${ONNX_RELATIVE_PATH}" ]; then
+# Check if model (or batch directory / manifest) exists locally
+if [ ! -e "./models/${ONNX_RELATIVE_PATH}" ]; then
     log "ERROR: Model file not found: ./models/${ONNX_RELATIVE_PATH}"
     exit 1
 fi
@@ -45,7 +51,7 @@ log "Starting 3-phase measurement for: ${ONNX_RELATIVE_PATH}"
 log "============================================================"
 
 # Verify model exists on device
-if ! adb shell "test -f ${DEVICE_MODEL_PATH}" 2>/dev/null; then
+if ! adb shell "test -e ${DEVICE_MODEL_PATH}" 2>/dev/null; then
     log "  ✗ Model not found on device: ${DEVICE_MODEL_PATH}"
     log "    Make sure model is pushed to device first"
     exit 1
@@ -54,7 +60,7 @@ fi
 # Run all three phases in a single program execution
 # This keeps caches warm across phases
 log "Running benchmark (warmup → silence → reset → measurement)..."
-BENCHMARK_OUTPUT=$(adb shell "cd /data/local/tmp && LD_LIBRARY_PATH=. ${DEVICE_BIN} ${ONNX_RELATIVE_PATH} ${WARMUP_DURATION} ${SILENT_DURATION} ${MEASUREMENT_DURATION}" 2>&1)
+BENCHMARK_OUTPUT=$(adb shell "cd /data/local/tmp && LD_LIBRARY_PATH=. ${DEVICE_BIN} ${ONNX_RELATIVE_PATH} ${WARMUP_DURATION} ${SILENT_DURATION} ${MEASUREMENT_DURATION} ${RUNNER_OPTIONS}" 2>&1)
 BENCHMARK_EXIT_CODE=$?
 
 # Print the output
@@ -74,19 +80,43 @@ if [ -z "$BENCHMARK_TIMESTAMP" ]; then
 fi
 
 # Collect battery statistics
-log "Collecting battery statistics..."
-if [ -n "$BENCHMARK_TIMESTAMP" ]; then
-    STATS_FILE="${OUTPUT_DIR}/${SAFE_FILENAME}_${BENCHMARK_TIMESTAMP}_batterystats.txt"
+# Sweeps reset batterystats once per configuration, so the binary dumps each
+# window itself and reports the files as BATTERYSTATS_FILE=<device path>
+# With --batterystats=off the runner's fuel-gauge columns are the only energy source
+DEVICE_STATS_FILES=$(echo "$BENCHMARK_OUTPUT" | grep "BATTERYSTATS_FILE=" | cut -d'=' -f2 | tr -d '\r' || true)
+
+if echo "$BENCHMARK_OUTPUT" | grep -q "BATTERYSTATS_DISABLED=1"; then
+    log "Skipping battery statistics (energy from the in-process fuel gauge)"
+elif [ -n "$DEVICE_STATS_FILES" ]; then
+    log "Collecting battery statistics..."
+    while IFS= read -r device_stats_file; do
+        [ -z "$device_stats_file" ] && continue
+        STATS_FILE="${OUTPUT_DIR}/$(basename "$device_stats_file")"
+        if adb pull "$device_stats_file" "$STATS_FILE" > /dev/null 2>&1; then
+            log "  ✓ Battery statistics saved to: $STATS_FILE"
+        else
+            log "  ⚠ Warning: Could not pull battery statistics: $device_stats_file"
+        fi
+    done <<< "$DEVICE_STATS_FILES"
 else
-    STATS_FILE="${OUTPUT_DIR}/${SAFE_FILENAME}_batterystats.txt"
+    log "Collecting battery statistics..."
+    if [ -n "$BENCHMARK_TIMESTAMP" ]; then
+        STATS_FILE="${OUTPUT_DIR}/${SAFE_FILENAME}_${BENCHMARK_TIMESTAMP}_batterystats.txt"
+    else
+        STATS_FILE="${OUTPUT_DIR}/${SAFE_FILENAME}_batterystats.txt"
+    fi
+    adb shell dumpsys batterystats > "$STATS_FILE"
+    log "  ✓ Battery statistics saved to: $STATS_FILE"
 fi
-adb shell dumpsys batterystats > "$STATS_FILE"
-log "  ✓ Battery statistics saved to: $STATS_FILE"
 
 # Collect performance metrics CSV file
 log "Collecting performance metrics..."
-# Find the performance file using the timestamp
-DEVICE_PERF_FILE=$(adb shell "ls -t /data/local/tmp/measurements/${SAFE_FILENAME}_${BENCHMARK_TIMESTAMP}_performance.csv 2>/dev/null | head -1" | tr -d '\r')
+# The binary reports the performance file (batch runs name it after the directory or manifest)
+DEVICE_PERF_FILE=$(echo "$BENCHMARK_OUTPUT" | grep "PERFORMANCE_FILE=" | cut -d'=' -f2 | tr -d '\r\n ' || true)
+if [ -z "$DEVICE_PERF_FILE" ]; then
+    # Fall back to finding the performance file using the timestamp
+    DEVICE_PERF_FILE=$(adb shell "ls -t /data/local/tmp/measurements/${SAFE_FILENAME}_${BENCHMARK_TIMESTAMP}_performance.csv 2>/dev/null | head -1" | tr -d '\r')
+fi
 
 if [ -n "$DEVICE_PERF_FILE" ]; then
     # Extract just the filename
@@ -103,6 +133,21 @@ else
     log "  ⚠ Warning: No performance metrics file found on device"
 fi
 
+# Collect additional result files (node placement, ...) reported as RESULT_FILE=<device path>
+DEVICE_RESULT_FILES=$(echo "$BENCHMARK_OUTPUT" | grep "RESULT_FILE=" | cut -d'=' -f2 | tr -d '\r' || true)
+if [ -n "$DEVICE_RESULT_FILES" ]; then
+    log "Collecting additional result files..."
+    while IFS= read -r device_result_file; do
+        [ -z "$device_result_file" ] && continue
+        LOCAL_RESULT_FILE="${OUTPUT_DIR}/$(basename "$device_result_file")"
+        if adb pull "$device_result_file" "$LOCAL_RESULT_FILE" > /dev/null 2>&1; then
+            log "  ✓ Saved: $LOCAL_RESULT_FILE"
+        else
+            log "  ⚠ Warning: Could not pull $device_result_file"
+        fi
+    done <<< "$DEVICE_RESULT_FILES"
+fi
+
 log "============================================================"
 log "Measurement complete for: ${ONNX_RELATIVE_PATH}"
 
@@ -12,9 +12,93 @@ Output columns:
 - voltage_list: List of voltage samples in mV
 - avg_power: Average power consumption in Watts
 - energy: Energy per single inference in Watt-hours
+- samples_per_inference: Batch size of one inference (leading input dimension)
+- energy_per_sample: Energy per sample (energy / samples_per_inference) in Watt-hours
+- energy_source: 'fuel_gauge' (sampled in-process by onnx_runner, preferred),
+  'rapl' (the same on a Linux host, from the RAPL package counters) or
+  'batterystats'; current_list / voltage_list are empty for sampled rows
+- us_per_sample, samples_per_second: Per-sample latency and throughput
 - iterations: Number of inference iterations
 - usperinf: Microseconds per inference
 - totaltimesec: Total measurement time in seconds
+- load_mode, intra_op_threads, inter_op_threads, execution_mode,
+  allow_spinning, graph_optimization_level, mem_pattern, cpu_arena, shared_arena,
+  session_config_entries, cpu_mask, execution_provider, nnapi_flags,
+  provider_node_counts, dim_overrides, input_shapes, dataset_samples, config_index:
+  Session and input configuration of the row
+- top_op_types: Op types with the largest share of kernel time (--profile)
+- model_source, model_load_method, optimized_model_saved: How the model was loaded
+  (original or optimized-model cache; file, buffer or mmap)
+- model_variant: Precision variant of the row with --variants (fp32, fp16,
+  int8_dynamic, int8_static; see scripts/make_variants.py); such rows are also
+  compared side by side in reports/variant_comparison_*.csv
+- model_hash, device_model, soc, build_fingerprint, ort_version: What the row
+  ran on (FNV-1a hash of the model file, Android device and SoC, OS build, ONNX
+  Runtime version); scripts/regression.py keys its baselines by them
+- setup_ms, file_read_ms, session_create_ms, input_prep_ms, first_run_ms,
+  model_load_ms, session_init_ms: Startup breakdown in milliseconds (means per
+  load in cold-load mode; the last two only with --startup-profile)
+- session_reused: 1 if the session came from the runner's session cache (--serve,
+  --session-cache); the startup breakdown is then 0
+- setup_saved_ms, session_cache_entries, session_cache_kb, session_cache_hits,
+  session_cache_misses, session_cache_evictions, session_cache_saved_ms: Build
+  time the row's reused session saved, and the cache after the row's setup (warm
+  sessions, their resident kB, activity and load time saved so far); empty
+  without a session cache
+- ci_metric, ci_target, ci_mean, ci_low, ci_high, ci_relative_half_width,
+  ci_batches, ci_reached: With --ci-target, the 95% confidence interval of mean
+  latency (us) or energy per inference (mJ) over batch means, and whether the
+  window ended because it was within ±ci_target of the mean (1) or on the
+  measurement_seconds cap (0); empty otherwise
+- validation_reference, validation_max_abs_error, validation_mean_abs_error,
+  validation_min_cosine, validation_worst_output, validation_passed: With
+  --validate, the error of the outputs against the CPU fp32 reference over the
+  compared samples (the smallest per-output cosine similarity and its output),
+  and whether it is within --max-abs-error / --min-cosine; empty otherwise
+- interference, interference_load, interference_baseline_window: With --co-run
+  / --stress, the background load of the row ('alone' for the comparison window
+  run without it), the load the co-runners achieved during measurement, and the
+  config_index of the row's 'alone' window; empty otherwise
+- interference_p50_ratio, interference_p99_ratio, interference_energy_ratio:
+  Latency percentiles and whole-device energy per inference under load divided
+  by those of the 'alone' window (empty without one)
+- warmup_iterations, warmup_elapsed_ms: Length of the warmup phase;
+  warmup_converged, warmup_converged_iterations, warmup_cv: with
+  --adaptive-warmup, whether latency settled before the cap, after how many
+  runs, and the latency CV of the last window (empty with a fixed warmup)
+- target_rate_hz, busy_fraction, missed_deadlines, queue_delay_*_us: Open-loop
+  pacing (--target-rate); energy is then the energy per frame at that rate,
+  idle time included. Empty (None) in closed-loop windows except busy_fraction
+- prep_mode, prep_passes, prep_mean_us, prep_stall_mean_us, e2e_latency_*_us:
+  Input preparation before every run (--prep=serial|pipelined, 'none' = inputs
+  prepared once at setup): mean preparation time, mean wait of a run for its
+  inputs (pipelined only), and latency from the start of a frame's preparation
+  to the end of its run. The latency_* columns then hold the time per iteration
+  (1 / throughput); empty without --prep
+- rss_*_kb, vm_hwm_kb: Process memory (VmRSS at setup/warmup boundaries, sampled
+  mean/peak during measurement, VmHWM of the window) in kB
+- allocations_per_run, allocated_bytes_per_run: Heap allocations per inference
+  (binaries built with COUNT_ALLOCATIONS=1 only)
+- perf_ipc, perf_*_per_inference, perf_cache_mpki: Hardware counters during the
+  measurement window (--perf-counters); perf_cluster_cycles / perf_cluster_ipc
+  split them per CPU cluster ("<cpu mask>:<value>;...")
+- perf_task_clock_ms, perf_context_switches, perf_cpu_migrations: Software
+  counters of all threads during the window
+- cluster_freq_mhz, throttled_fraction, temp_start_c, temp_max_c: Mean CPU
+  frequency per cluster, share of samples with a cpufreq policy capped below its
+  maximum, and the hottest thermal zone at the start / peak of the measurement
+  window (--telemetry)
+- power_samples, power_mean_w, power_peak_w, current_mean_ma, voltage_mean_mv,
+  window_energy_j, energy_per_inference_mj: In-process fuel-gauge (or RAPL)
+  sampling of the measurement window; rail_energy_j: per-rail energy from the
+  on-device power monitor or the host's RAPL domains ("<rail>:<J>;..."), where
+  there are any
+- iteration_log_dropped: Iterations missing from the _iterations.bin file of the
+  row (--iteration-log; see load_iteration_log)
+- stats_reset_epoch_ms, measurement_start_epoch_ms, measurement_end_epoch_ms:
+  Wall-clock window of the row (batterystats reset and measurement bounds)
+- latency_*_us: Per-inference latency statistics (mean, stddev, min, p50, p90,
+  p99, p999, max) in microseconds, when present in the performance CSV
 """
 
 import os
@@ -22,35 +106,261 @@ import re
 import sys
 from pathlib import Path
 from typing import Dict, List, Optional, Tuple
+import numpy as np
 import pandas as pd
 
 # Configuration
 MEASUREMENTS_DIR = "./measurements"
 REPORTS_DIR = "./reports"
 
-
-def parse_performance_csv(csv_path: Path) -> Optional[Dict]:
+# Session configuration columns written by onnx_runner (copied through as-is)
+CONFIG_COLUMNS = [
+    'load_mode',
+    'intra_op_threads',
+    'inter_op_threads',
+    'execution_mode',
+    'allow_spinning',
+    'graph_optimization_level',
+    'mem_pattern',
+    'cpu_arena',
+    'shared_arena',
+    'session_config_entries',
+    'cpu_mask',
+    'execution_provider',
+    'workers',
+    'worker_sessions',
+    'nnapi_flags',
+    'provider_node_counts',
+    'top_op_types',
+    'perf_cluster_cycles',
+    'perf_cluster_ipc',
+    'cluster_freq_mhz',
+    'rail_energy_j',
+    'dim_overrides',
+    'input_shapes',
+    'dataset_samples',
+    'model_source',
+    'model_load_method',
+    'optimized_model_saved',
+    'model_variant',
+    'model_hash',
+    'device_model',
+    'soc',
+    'build_fingerprint',
+    'ort_version',
+    'prep_mode',
+    'config_index',
+    'ci_metric',
+    'validation_reference',
+    'validation_worst_output',
+    'interference',
+    'interference_load',
+    'interference_baseline_window',
+    'stats_reset_epoch_ms',
+    'measurement_start_epoch_ms',
+    'measurement_end_epoch_ms',
+]
+
+# Per-sample columns written by onnx_runner for batched inputs (copied through as-is)
+SAMPLE_COLUMNS = [
+    'us_per_sample',
+    'samples_per_second',
+]
+
+# Startup breakdown columns written by onnx_runner (empty when not collected)
+STARTUP_COLUMNS = [
+    'setup_ms',
+    'file_read_ms',
+    'session_create_ms',
+    'input_prep_ms',
+    'first_run_ms',
+    'model_load_ms',
+    'session_init_ms',
+    'session_reused',
+]
+
+# Confidence-interval columns written by onnx_runner (--ci-target only)
+CI_COLUMNS = [
+    'ci_target',
+    'ci_mean',
+    'ci_low',
+    'ci_high',
+    'ci_relative_half_width',
+    'ci_batches',
+    'ci_reached',
+]
+
+# Output validation columns written by onnx_runner (--validate only)
+VALIDATION_COLUMNS = [
+    'validation_max_abs_error',
+    'validation_mean_abs_error',
+    'validation_min_cosine',
+    'validation_passed',
+]
+
+# Interference columns written by onnx_runner (--co-run / --stress only)
+INTERFERENCE_COLUMNS = [
+    'interference_p50_ratio',
+    'interference_p99_ratio',
+    'interference_energy_ratio',
+]
+
+# Warmup columns written by onnx_runner (convergence only with --adaptive-warmup)
+WARMUP_COLUMNS = [
+    'warmup_iterations',
+    'warmup_elapsed_ms',
+    'warmup_converged',
+    'warmup_converged_iterations',
+    'warmup_cv',
+]
+
+# Session cache columns written by onnx_runner (--serve, --session-cache; empty otherwise)
+SESSION_CACHE_COLUMNS = [
+    'setup_saved_ms',
+    'session_cache_entries',
+    'session_cache_kb',
+    'session_cache_hits',
+    'session_cache_misses',
+    'session_cache_evictions',
+    'session_cache_saved_ms',
+]
+
+# Open-loop pacing columns written by onnx_runner (empty in closed-loop windows)
+PACING_COLUMNS = [
+    'target_rate_hz',
+    'busy_fraction',
+    'missed_deadlines',
+    'queue_delay_mean_us',
+    'queue_delay_p50_us',
+    'queue_delay_p99_us',
+    'queue_delay_max_us',
+]
+
+# Input preparation columns written by onnx_runner (--prep only)
+PREP_COLUMNS = [
+    'prep_passes',
+    'prep_mean_us',
+    'prep_stall_mean_us',
+    'e2e_latency_mean_us',
+    'e2e_latency_p50_us',
+    'e2e_latency_p99_us',
+]
+
+# Memory columns written by onnx_runner (empty when unavailable; allocations only
+# in binaries built with COUNT_ALLOCATIONS=1)
+MEMORY_COLUMNS = [
+    'rss_before_setup_kb',
+    'rss_after_setup_kb',
+    'rss_after_warmup_kb',
+    'rss_measurement_mean_kb',
+    'rss_measurement_peak_kb',
+    'vm_hwm_kb',
+    'allocations_per_run',
+    'allocated_bytes_per_run',
+]
+
+# Performance counter columns written by onnx_runner (--perf-counters; hardware
+# counts are empty when the PMU or perf_event_paranoid refused them)
+PERF_COLUMNS = [
+    'perf_ipc',
+    'perf_cycles_per_inference',
+    'perf_instructions_per_inference',
+    'perf_cache_misses_per_inference',
+    'perf_branch_misses_per_inference',
+    'perf_cache_mpki',
+    'perf_task_clock_ms',
+    'perf_context_switches',
+    'perf_cpu_migrations',
+]
+
+# Device telemetry columns written by onnx_runner (--telemetry; empty when the
+# sysfs files are not readable)
+TELEMETRY_COLUMNS = [
+    'throttled_fraction',
+    'temp_start_c',
+    'temp_max_c',
+]
+
+# In-process fuel-gauge columns written by onnx_runner (empty when the battery's
+# current_now / voltage_now are not readable or --power-interval=0)
+POWER_COLUMNS = [
+    'power_samples',
+    'power_mean_w',
+    'power_peak_w',
+    'current_mean_ma',
+    'voltage_mean_mv',
+    'window_energy_j',
+    'energy_per_inference_mj',
+]
+
+# Iteration log columns written by onnx_runner (--iteration-log only)
+ITERATION_LOG_COLUMNS = [
+    'iteration_log_dropped',
+]
+
+# Record layout of _iterations.bin after its header (see IterationRecord in results_sink.hpp)
+ITERATION_RECORD_DTYPE = np.dtype([
+    ('start_ns', '<u8'),
+    ('latency', '<u4'),
+    ('worker', '<u2'),
+    ('flags', '<u2'),
+])
+ITERATION_LOG_MAGIC = b'ORITER1\0'
+
+# Latency distribution columns written by onnx_runner (copied through as-is)
+LATENCY_COLUMNS = [
+    'latency_mean_us',
+    'latency_stddev_us',
+    'latency_min_us',
+    'latency_p50_us',
+    'latency_p90_us',
+    'latency_p99_us',
+    'latency_p999_us',
+    'latency_max_us',
+]
+
+
+def parse_performance_csv(csv_path: Path) -> List[Dict]:
     """
     Parse performance CSV file and extract metrics.
 
-    Returns dict with: model, timestamp, iterations, us_per_inference, total_time_sec
+    Sweep runs write one row per configuration, so a list of dicts is returned,
+    each with: model, timestamp, iterations, us_per_inference, total_time_sec,
+    batterystats_file (empty for single-configuration runs), samples_per_inference
+    (1 for older files) and any optional configuration / per-sample / latency
+    distribution columns present in the file
     """
     try:
-        df = pd.read_csv(csv_path)
-        if df.empty:
-            return None
-
-        row = df.iloc[0]
-        return {
-            'model': row['model'],
-            'timestamp': row['timestamp'],
-            'iterations': int(row['measurement_iterations']),
-            'us_per_inference': float(row['us_per_inference']),
-            'total_time_sec': float(row['total_time_sec']),
-        }
+        df = pd.read_csv(csv_path, keep_default_na=False)
+        rows = []
+        for _, row in df.iterrows():
+            data = {
+                'model': row['model'],
+                'timestamp': row['timestamp'],
+                'iterations': int(row['measurement_iterations']),
+                'us_per_inference': float(row['us_per_inference']),
+                'total_time_sec': float(row['total_time_sec']),
+                'batterystats_file': str(row['batterystats_file']) if 'batterystats_file' in df.columns else '',
+                'samples_per_inference': int(row['samples_per_inference']) if 'samples_per_inference' in df.columns else 1,
+                'power_source': str(row['power_source']) if 'power_source' in df.columns else '',
+            }
+            for column in CONFIG_COLUMNS:
+                if column in df.columns:
+                    data[column] = row[column]
+            for column in SAMPLE_COLUMNS + LATENCY_COLUMNS:
+                if column in df.columns:
+                    data[column] = float(row[column])
+            for column in (CI_COLUMNS + VALIDATION_COLUMNS + INTERFERENCE_COLUMNS + WARMUP_COLUMNS +
+                           STARTUP_COLUMNS + SESSION_CACHE_COLUMNS + PACING_COLUMNS + PREP_COLUMNS +
+                           MEMORY_COLUMNS + PERF_COLUMNS + TELEMETRY_COLUMNS + POWER_COLUMNS +
+                           ITERATION_LOG_COLUMNS):
+                if column in df.columns:
+                    data[column] = float(row[column]) if row[column] != '' else None
+            rows.append(data)
+        return rows
     except Exception as e:
         print(f"Error parsing {csv_path}: {e}", file=sys.stderr)
-        return None
+        return []
 
 
 def parse_batterystats_samples(stats_path: Path, total_time_sec: float) -> Optional[Dict]:
@@ -116,13 +426,48 @@ def parse_batterystats_samples(stats_path: Path, total_time_sec: float) -> Optio
         return None
 
 
-def find_matching_batterystats(perf_path: Path, measurements_dir: Path) -> Optional[Path]:
+def load_iteration_log(log_path: Path) -> pd.DataFrame:
+    """
+    Read an _iterations.bin file written with --iteration-log.
+
+    Returns one row per measured iteration: start_ns (since the start of the
+    measurement window), latency_ns, worker, missed_deadline and epoch_ns
+    (wall-clock start of the iteration)
+    """
+    data = log_path.read_bytes()
+    if data[:8] != ITERATION_LOG_MAGIC:
+        raise ValueError(f"{log_path} is not an onnx_runner iteration log")
+    header_size, record_size, latency_unit_ns, _workers = np.frombuffer(data, dtype='<u4', count=4, offset=8)
+    start_epoch_ns = int(np.frombuffer(data, dtype='<i8', count=1, offset=24)[0])
+    if record_size != ITERATION_RECORD_DTYPE.itemsize:
+        raise ValueError(f"{log_path}: unexpected record size {record_size}")
+
+    count = (len(data) - header_size) // record_size
+    records = np.frombuffer(data, dtype=ITERATION_RECORD_DTYPE, count=count, offset=int(header_size))
+    df = pd.DataFrame({
+        'start_ns': records['start_ns'].astype(np.int64),
+        'latency_ns': records['latency'].astype(np.int64) * int(latency_unit_ns),
+        'worker': records['worker'],
+        'missed_deadline': (records['flags'] & 1).astype(bool),
+    })
+    df['epoch_ns'] = start_epoch_ns + df['start_ns']
+    # Workers write whole chunks each, so the file is only ordered per worker
+    return df.sort_values('start_ns', kind='stable').reset_index(drop=True)
+
+
+def find_matching_batterystats(perf_path: Path, measurements_dir: Path,
+                               batterystats_file: str = '') -> Optional[Path]:
     """
     Find the batterystats file that matches the performance file.
 
     Performance file format: model_TIMESTAMP_performance.csv
     Batterystats file format: model_TIMESTAMP_batterystats.txt
+    Sweep rows name their own file instead: model_TIMESTAMP_cfgN_batterystats.txt
     """
+    if batterystats_file:
+        stats_path = measurements_dir / batterystats_file
+        return stats_path if stats_path.exists() else None
+
     # Remove _performance.csv suffix
     base_name = perf_path.stem.replace('_performance', '')
 
@@ -154,6 +499,8 @@ def process_measurements(measurements_dir: Path) -> pd.DataFrame:
     - voltage_list: List of voltage samples
     - avg_power: Average power (W)
     - energy: Energy per single inference (Wh)
+    - samples_per_inference: Batch size of one inference
+    - energy_per_sample: Energy per sample (Wh)
     - iterations: Number of inferences
     - usperinf: Microseconds per inference
     - totaltimesec: Total time (seconds)
@@ -173,48 +520,77 @@ def process_measurements(measurements_dir: Path) -> pd.DataFrame:
     skipped = 0
 
     for perf_path in sorted(perf_files):
-        # Parse performance data
-        perf_data = parse_performance_csv(perf_path)
-        if not perf_data:
+        # Parse performance data (one row per configuration)
+        perf_rows = parse_performance_csv(perf_path)
+        if not perf_rows:
             print(f"  ⚠ Skipped (no perf data): {perf_path.name}", file=sys.stderr)
             skipped += 1
             continue
 
-        # Find matching batterystats file
-        stats_path = find_matching_batterystats(perf_path, measurements_dir)
-        if not stats_path:
-            print(f"  ⚠ Skipped (no batterystats): {perf_path.name}", file=sys.stderr)
-            skipped += 1
-            continue
-
-        # Parse battery data
-        battery_data = parse_batterystats_samples(stats_path, perf_data['total_time_sec'])
-        if not battery_data:
-            print(f"  ⚠ Skipped (no battery data): {perf_path.name}", file=sys.stderr)
-            skipped += 1
-            continue
-
-        # Calculate energy per inference
-        # Energy per inference (Wh) = Power (W) * Time per inference (s) / 3600
-        time_per_inf_sec = perf_data['us_per_inference'] / 1_000_000.0  # Convert µs to seconds
-        energy_per_inf = (battery_data['avg_power'] * time_per_inf_sec) / 3600.0
-
-        # Create record
-        record = {
-            'filename': perf_data['model'],
-            'date_time': perf_data['timestamp'],
-            'current_list': battery_data['current_list'],
-            'voltage_list': battery_data['voltage_list'],
-            'avg_power': battery_data['avg_power'],
-            'iterations': perf_data['iterations'],
-            'usperinf': perf_data['us_per_inference'],
-            'totaltimesec': perf_data['total_time_sec'],
-            'energy': energy_per_inf,
-        }
-
-        records.append(record)
-        processed += 1
-        print(f"  ✓ Processed: {perf_data['model']} ({perf_data['timestamp']})")
+        for perf_data in perf_rows:
+            # No run finished in the window: the per-inference metrics are -1
+            if perf_data['iterations'] == 0:
+                print(f"  ⚠ Skipped (no completed runs): {perf_path.name}", file=sys.stderr)
+                skipped += 1
+                continue
+
+            # The runner's own fuel-gauge (or RAPL) samples cover exactly the measurement
+            # window, so they win over batterystats; the sample lists are then not available
+            if perf_data.get('power_mean_w') is not None:
+                battery_data = {
+                    'voltage_list': [],
+                    'current_list': [],
+                    'avg_power': perf_data['power_mean_w'],
+                }
+                energy_source = perf_data['power_source'] or 'fuel_gauge'
+            else:
+                # Find matching batterystats file
+                stats_path = find_matching_batterystats(perf_path, measurements_dir,
+                                                        perf_data['batterystats_file'])
+                if not stats_path:
+                    print(f"  ⚠ Skipped (no batterystats): {perf_path.name}", file=sys.stderr)
+                    skipped += 1
+                    continue
+
+                # Parse battery data
+                battery_data = parse_batterystats_samples(stats_path, perf_data['total_time_sec'])
+                if not battery_data:
+                    print(f"  ⚠ Skipped (no battery data): {perf_path.name}", file=sys.stderr)
+                    skipped += 1
+                    continue
+                energy_source = 'batterystats'
+
+            # Calculate energy per inference
+            # Energy per inference (Wh) = Power (W) * Time per inference (s) / 3600
+            time_per_inf_sec = perf_data['us_per_inference'] / 1_000_000.0  # Convert µs to seconds
+            energy_per_inf = (battery_data['avg_power'] * time_per_inf_sec) / 3600.0
+            samples = max(perf_data['samples_per_inference'], 1)
+
+            # Create record
+            record = {
+                'filename': perf_data['model'],
+                'date_time': perf_data['timestamp'],
+                'current_list': battery_data['current_list'],
+                'voltage_list': battery_data['voltage_list'],
+                'avg_power': battery_data['avg_power'],
+                'iterations': perf_data['iterations'],
+                'usperinf': perf_data['us_per_inference'],
+                'totaltimesec': perf_data['total_time_sec'],
+                'energy': energy_per_inf,
+                'samples_per_inference': samples,
+                'energy_per_sample': energy_per_inf / samples,
+                'energy_source': energy_source,
+            }
+            for column in (CONFIG_COLUMNS + SAMPLE_COLUMNS + CI_COLUMNS + VALIDATION_COLUMNS +
+                           INTERFERENCE_COLUMNS + WARMUP_COLUMNS + STARTUP_COLUMNS + SESSION_CACHE_COLUMNS +
+                           PACING_COLUMNS + PREP_COLUMNS + MEMORY_COLUMNS + PERF_COLUMNS + TELEMETRY_COLUMNS +
+                           POWER_COLUMNS + ITERATION_LOG_COLUMNS + LATENCY_COLUMNS):
+                if column in perf_data:
+                    record[column] = perf_data[column]
+
+            records.append(record)
+            processed += 1
+            print(f"  ✓ Processed: {perf_data['model']} ({perf_data['timestamp']})")
 
     print(f"\nProcessed: {processed}, Skipped: {skipped}")
 
@@ -231,14 +607,74 @@ def process_measurements(measurements_dir: Path) -> pd.DataFrame:
         'iterations',
         'usperinf',
         'totaltimesec',
-        'energy'
+        'energy',
+        'samples_per_inference',
+        'energy_per_sample',
+        'energy_source',
     ]
 
+    # Configuration, per-sample and latency distribution columns only exist for newer measurements
+    column_order += [column for column in (CONFIG_COLUMNS + SAMPLE_COLUMNS + CI_COLUMNS + VALIDATION_COLUMNS +
+                                           INTERFERENCE_COLUMNS + WARMUP_COLUMNS + STARTUP_COLUMNS +
+                                           SESSION_CACHE_COLUMNS + PACING_COLUMNS + PREP_COLUMNS +
+                                           MEMORY_COLUMNS + PERF_COLUMNS + TELEMETRY_COLUMNS + POWER_COLUMNS +
+                                           ITERATION_LOG_COLUMNS + LATENCY_COLUMNS)
+                     if column in df.columns]
+
     df = df[column_order]
 
     return df
 
 
+def variant_comparison(df: pd.DataFrame) -> pd.DataFrame:
+    """
+    One row per precision variant (--variants) and configuration, with latency,
+    energy and output error next to the fp32 original of the same run.
+
+    speedup is the original's latency over the variant's, energy_ratio the
+    variant's energy per inference over the original's; both are empty where
+    the run has no fp32 row for that configuration.
+    """
+    if 'model_variant' not in df.columns:
+        return pd.DataFrame()
+    rows = df[df['model_variant'].fillna('') != ''].copy()
+    if rows.empty:
+        return pd.DataFrame()
+
+    # The family is the original's file name, the same for all its variants
+    def family(row) -> str:
+        path = Path(row['filename'])
+        suffix = f"_{row['model_variant']}"
+        stem = path.stem[:-len(suffix)] if path.stem.endswith(suffix) else path.stem
+        return str(path.with_name(stem + path.suffix))
+    rows['family'] = rows.apply(family, axis=1)
+
+    keys = ['date_time', 'family'] + [column for column in ('execution_provider', 'intra_op_threads', 'cpu_mask',
+                                                           'workers', 'target_rate_hz', 'dim_overrides',
+                                                           'prep_mode', 'interference')
+                                      if column in rows.columns]
+    metrics = [column for column in ('usperinf', 'latency_p50_us', 'latency_p99_us', 'energy', 'avg_power',
+                                     'validation_max_abs_error', 'validation_min_cosine', 'validation_passed')
+               if column in rows.columns]
+    table = rows[keys + ['model_variant'] + metrics].copy()
+    table['energy_per_inference_mj'] = table['energy'] * 3600.0 * 1000.0
+
+    # Missing configuration values (closed loop, no shape) would drop rows from the merge
+    table[keys] = table[keys].fillna('').astype(str)
+    original = table[table['model_variant'] == 'fp32'][keys + ['usperinf', 'energy']]
+    original = original.rename(columns={'usperinf': 'fp32_usperinf', 'energy': 'fp32_energy'})
+    original = original.drop_duplicates(subset=keys)
+    table = table.merge(original, on=keys, how='left')
+    table['speedup'] = table['fp32_usperinf'] / table['usperinf']
+    table['energy_ratio'] = table['energy'] / table['fp32_energy']
+
+    order = {name: i for i, name in enumerate(['fp32', 'fp16', 'int8_dynamic', 'int8_static'])}
+    table['variant_order'] = table['model_variant'].map(order).fillna(len(order))
+    table = table.sort_values(keys + ['variant_order']).drop(columns=['variant_order', 'fp32_usperinf',
+                                                                        'fp32_energy', 'energy'])
+    return table.reset_index(drop=True)
+
+
 def main():
     """Main entry point."""
     print("=" * 60)
@@ -279,6 +715,14 @@ def main():
         print(f"\n✗ Error saving pickle file: {e}", file=sys.stderr)
         sys.exit(1)
 
+    # Precision variants side by side (--variants runs only)
+    comparison = variant_comparison(df)
+    if not comparison.empty:
+        comparison_path = reports_dir / f"variant_comparison_{timestamp}.csv"
+        comparison.to_csv(comparison_path, index=False)
+        print(f"\n✓ Variant comparison saved to: {comparison_path.absolute()}")
+        print(comparison.to_string(index=False))
+
     # Display sample
     print("\nSample data (first 3 rows):")
     print("-" * 60)
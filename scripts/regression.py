@@ -0,0 +1,424 @@
+#!/usr/bin/env python3
+"""
+Track measurements over time and flag performance regressions.
+
+A baseline store (baselines/baseline_store.json) keeps the recent runs of every
+(device, SoC, ONNX Runtime version, model hash, session configuration). The
+runs come from the DataFrame that parse_measurements.py writes. `compare`
+checks rows that are not in the store yet against it: time per inference, p99
+latency, energy per inference and peak memory.
+
+A metric regresses when it is worse by more than --threshold (relative) and
+the difference is significant at --alpha (one-sided):
+- With at least MIN_BASELINE_RUNS stored runs, the new value is tested against
+  the run-to-run spread of the baseline (Student t prediction interval). This
+  covers thermal and frequency variation between runs, not just within one.
+- With fewer runs, latency falls back to Welch's test on the per-iteration
+  mean and standard deviation of the last baseline run and the new run. Energy
+  and memory have no within-run spread; they are 'unconfirmed' until enough
+  runs are recorded.
+
+A row without a baseline of its exact identity is compared with the latest
+baseline of the same model file, device, SoC and configuration: an ONNX Runtime
+upgrade or a retrained model are then checked against what ran before, and
+the 'changed' column names what differs.
+
+Usage:
+  python3 scripts/parse_measurements.py
+  python3 scripts/regression.py record [pkl_file]       # accept runs as baseline
+  python3 scripts/regression.py compare [pkl_file] [--threshold=0.05] [--alpha=0.01] [--record]
+
+compare exits with 1 if anything regressed, so it can gate a CI job. Results
+are written to reports/regressions_<timestamp>.csv.
+"""
+
+import argparse
+import json
+import math
+import statistics
+import sys
+from datetime import datetime
+from pathlib import Path
+import pandas as pd
+
+SCRIPT_DIR = Path(__file__).parent
+PROJECT_ROOT = SCRIPT_DIR.parent
+REPORTS_DIR = PROJECT_ROOT / "reports"
+DEFAULT_STORE = PROJECT_ROOT / "baselines" / "baseline_store.json"
+
+STORE_VERSION = 1
+DEFAULT_THRESHOLD = 0.05
+DEFAULT_ALPHA = 0.01
+DEFAULT_MAX_RUNS = 20
+MIN_BASELINE_RUNS = 3
+
+# What the row ran on; a change of these is what regression tracking is for
+IDENTITY_COLUMNS = ['device_model', 'soc', 'ort_version', 'model_hash']
+
+# What the row measured; rows only compare with the same configuration
+CONFIG_KEY_COLUMNS = [
+    'load_mode',
+    'intra_op_threads',
+    'inter_op_threads',
+    'execution_mode',
+    'allow_spinning',
+    'graph_optimization_level',
+    'mem_pattern',
+    'cpu_arena',
+    'shared_arena',
+    'session_config_entries',
+    'cpu_mask',
+    'execution_provider',
+    'nnapi_flags',
+    'workers',
+    'worker_sessions',
+    'target_rate_hz',
+    'dim_overrides',
+    'input_shapes',
+    'model_variant',
+    'prep_mode',
+    'prep_passes',
+    'interference',
+]
+
+# Compared metrics (all: higher is worse) and the columns they are stored from
+METRICS = {
+    'usperinf': 'time per inference (µs)',
+    'latency_p99_us': 'p99 latency (µs)',
+    'energy_mj': 'energy per inference (mJ)',
+    'vm_hwm_kb': 'peak memory (kB)',
+}
+
+# Per-run values kept for Welch's test on latency with few baseline runs
+WINDOW_COLUMNS = ['latency_mean_us', 'latency_stddev_us', 'iterations']
+
+
+def text(value) -> str:
+    """Key text of a DataFrame cell; missing values (older CSVs, None, NaN) are ''."""
+    if value is None or (isinstance(value, float) and math.isnan(value)):
+        return ''
+    # Integer columns read as float once a missing value is in them
+    if isinstance(value, float) and value.is_integer():
+        return str(int(value))
+    return str(value)
+
+
+def number(value):
+    try:
+        value = float(value)
+    except (TypeError, ValueError):
+        return None
+    return None if math.isnan(value) else value
+
+
+def row_identity(row) -> dict:
+    return {column: text(row.get(column)) for column in IDENTITY_COLUMNS}
+
+
+def row_config(row) -> dict:
+    return {column: text(row.get(column)) for column in CONFIG_KEY_COLUMNS}
+
+
+def lineage_key(model: str, identity: dict, config: dict) -> str:
+    """Model, device and configuration: what stays the same across ORT upgrades and retrains."""
+    parts = [model, identity['device_model'], identity['soc']] + [f"{k}={v}" for k, v in config.items() if v]
+    return '|'.join(parts)
+
+
+def baseline_key(model: str, identity: dict, config: dict) -> str:
+    return f"{lineage_key(model, identity, config)}|ort={identity['ort_version']}|hash={identity['model_hash']}"
+
+
+def row_run(row) -> dict:
+    """Metrics of one measurement window, as stored."""
+    energy_wh = number(row.get('energy'))
+    run = {
+        'date_time': text(row.get('date_time')),
+        'config_index': text(row.get('config_index')),
+        'usperinf': number(row.get('usperinf')),
+        'latency_p99_us': number(row.get('latency_p99_us')),
+        'energy_mj': energy_wh * 3600.0 * 1000.0 if energy_wh is not None else None,
+        'vm_hwm_kb': number(row.get('vm_hwm_kb')),
+    }
+    for column in WINDOW_COLUMNS:
+        run[column] = number(row.get(column))
+    return run
+
+
+def load_store(path: Path) -> dict:
+    if not path.exists():
+        return {'version': STORE_VERSION, 'baselines': {}}
+    store = json.loads(path.read_text())
+    if store.get('version') != STORE_VERSION:
+        raise ValueError(f"{path}: unsupported store version {store.get('version')}")
+    return store
+
+
+def save_store(store: dict, path: Path):
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_text(json.dumps(store, indent=1, sort_keys=True) + '\n')
+
+
+def recorded_runs(store: dict) -> set:
+    """(model, date_time, config_index) of every stored run."""
+    return {(entry['model'], run['date_time'], run['config_index'])
+            for entry in store['baselines'].values() for run in entry['runs']}
+
+
+def new_rows(df: pd.DataFrame, store: dict) -> list:
+    seen = recorded_runs(store)
+    rows = []
+    for _, row in df.iterrows():
+        if (text(row['filename']), text(row.get('date_time')), text(row.get('config_index'))) not in seen:
+            rows.append(row)
+    return rows
+
+
+def record_row(store: dict, row, max_runs: int):
+    model = text(row['filename'])
+    identity = row_identity(row)
+    config = row_config(row)
+    entry = store['baselines'].setdefault(baseline_key(model, identity, config), {
+        'model': model,
+        'identity': identity,
+        'config': config,
+        'runs': [],
+    })
+    entry['runs'].append(row_run(row))
+    entry['runs'].sort(key=lambda run: run['date_time'])
+    del entry['runs'][:-max_runs]
+
+
+def find_baseline(store: dict, model: str, identity: dict, config: dict):
+    """The exact identity's baseline, else the latest one of the same lineage."""
+    exact = store['baselines'].get(baseline_key(model, identity, config))
+    if exact and exact['runs']:
+        return exact
+    lineage = lineage_key(model, identity, config)
+    candidates = [entry for entry in store['baselines'].values()
+                  if entry['runs'] and lineage_key(entry['model'], entry['identity'], entry['config']) == lineage]
+    if not candidates:
+        return None
+    return max(candidates, key=lambda entry: entry['runs'][-1]['date_time'])
+
+
+def incomplete_beta(a: float, b: float, x: float) -> float:
+    """Regularized incomplete beta function I_x(a, b) (continued fraction, Lentz's method)."""
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    if x > (a + 1.0) / (a + b + 2.0):
+        return 1.0 - incomplete_beta(b, a, 1.0 - x)
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) + a * math.log(x) + b * math.log1p(-x)) / a
+    tiny = 1e-300
+    c, d = 1.0, 1.0 - (a + b) * x / (a + 1.0)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    result = d
+    for m in range(1, 200):
+        for numerator in (m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                          -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            result *= c * d
+        if abs(c * d - 1.0) < 1e-12:
+            break
+    return front * result
+
+
+def student_t_sf(t: float, df: float) -> float:
+    """P(T > t) for Student's t with df degrees of freedom."""
+    tail = 0.5 * incomplete_beta(df / 2.0, 0.5, df / (df + t * t))
+    return tail if t > 0 else 1.0 - tail
+
+
+def run_to_run_p_value(values: list, new: float) -> float:
+    """One-sided p-value of new against the spread of the baseline runs (prediction interval)."""
+    n = len(values)
+    mean = statistics.fmean(values)
+    spread = statistics.stdev(values)
+    if spread == 0.0:
+        return 0.0 if new > mean else 1.0
+    return student_t_sf((new - mean) / (spread * math.sqrt(1.0 + 1.0 / n)), n - 1)
+
+
+def welch_p_value(baseline: dict, run: dict):
+    """One-sided p-value that the new run's mean latency is higher, from the iterations of both runs."""
+    values = [baseline.get(column) for column in WINDOW_COLUMNS] + [run.get(column) for column in WINDOW_COLUMNS]
+    if any(value is None for value in values):
+        return None
+    mean_a, sd_a, n_a, mean_b, sd_b, n_b = values
+    if n_a < 2 or n_b < 2:
+        return None
+    var_a, var_b = sd_a ** 2 / n_a, sd_b ** 2 / n_b
+    if var_a + var_b == 0.0:
+        return 0.0 if mean_b > mean_a else 1.0
+    df = (var_a + var_b) ** 2 / (var_a ** 2 / (n_a - 1) + var_b ** 2 / (n_b - 1))
+    return student_t_sf((mean_b - mean_a) / math.sqrt(var_a + var_b), df)
+
+
+def compare_metric(metric: str, baseline_runs: list, run: dict, threshold: float, alpha: float) -> dict:
+    new = run.get(metric)
+    values = [value for value in (past.get(metric) for past in baseline_runs) if value is not None]
+    result = {'metric': METRICS[metric], 'new': new, 'baseline': None, 'baseline_runs': len(values),
+              'change_pct': None, 'p_value': None, 'status': 'no_data'}
+    if new is None or not values:
+        return result
+    reference = statistics.fmean(values)
+    result['baseline'] = reference
+    if reference <= 0.0:
+        return result
+    change = new / reference - 1.0
+    result['change_pct'] = change * 100.0
+
+    # p-values are for "worse"; 1 - p is the evidence for "better"
+    if len(values) >= MIN_BASELINE_RUNS:
+        p_worse = run_to_run_p_value(values, new)
+    elif metric == 'usperinf':
+        p_worse = welch_p_value(baseline_runs[-1], run)
+    else:
+        p_worse = None
+
+    if abs(change) <= threshold:
+        result['status'] = 'ok'
+    elif p_worse is None:
+        result['status'] = 'unconfirmed'
+    elif change > 0 and p_worse < alpha:
+        result['status'] = 'regression'
+    elif change < 0 and 1.0 - p_worse < alpha:
+        result['status'] = 'improvement'
+    else:
+        result['status'] = 'ok'
+    if p_worse is not None:
+        result['p_value'] = p_worse if change > 0 else 1.0 - p_worse
+    return result
+
+
+def changed_fields(entry: dict, identity: dict) -> str:
+    changes = [f"{column}: {entry['identity'][column] or '?'} → {identity[column] or '?'}"
+               for column in IDENTITY_COLUMNS if entry['identity'][column] != identity[column]]
+    return '; '.join(changes)
+
+
+def describe_config(config: dict) -> str:
+    parts = [config['execution_provider'] or 'cpu']
+    if config['intra_op_threads']:
+        parts.append(f"{config['intra_op_threads']}t")
+    for column in ('cpu_mask', 'model_variant', 'dim_overrides', 'target_rate_hz', 'prep_mode', 'interference'):
+        if config[column] and config[column] not in ('none', 'all'):
+            parts.append(config[column])
+    return ' '.join(parts)
+
+
+def load_dataframe(pkl_arg):
+    if pkl_arg:
+        pkl_path = Path(pkl_arg)
+    else:
+        pkl_files = sorted(REPORTS_DIR.glob("measurements_data_*.pkl"))
+        if not pkl_files:
+            print("ERROR: No pickle files in reports/ (run parse_measurements.py first)", file=sys.stderr)
+            return None
+        pkl_path = pkl_files[-1]
+    print(f"Loading: {pkl_path}")
+    return pd.read_pickle(pkl_path)
+
+
+def cmd_record(args) -> int:
+    df = load_dataframe(args.pkl)
+    if df is None:
+        return 1
+    store = load_store(args.store)
+    rows = new_rows(df, store)
+    for row in rows:
+        record_row(store, row, args.max_runs)
+    save_store(store, args.store)
+    print(f"✓ Recorded {len(rows)} new run(s) in {args.store} ({len(store['baselines'])} baseline(s))")
+    return 0
+
+
+def cmd_compare(args) -> int:
+    df = load_dataframe(args.pkl)
+    if df is None:
+        return 1
+    store = load_store(args.store)
+    rows = new_rows(df, store)
+    if not rows:
+        print("No runs that are not in the baseline store yet")
+        return 0
+
+    records = []
+    clean_rows = []
+    for row in rows:
+        model = text(row['filename'])
+        identity = row_identity(row)
+        config = row_config(row)
+        run = row_run(row)
+        entry = find_baseline(store, model, identity, config)
+        base = {
+            'model': model,
+            'date_time': run['date_time'],
+            'config': describe_config(config),
+            'changed': changed_fields(entry, identity) if entry else '',
+        }
+        if entry is None:
+            records.append({**base, 'metric': '', 'status': 'no_baseline'})
+            clean_rows.append(row)
+            continue
+        results = [compare_metric(metric, entry['runs'], run, args.threshold, args.alpha) for metric in METRICS]
+        records.extend({**base, **result} for result in results)
+        if not any(result['status'] == 'regression' for result in results):
+            clean_rows.append(row)
+
+    report = pd.DataFrame(records)
+    REPORTS_DIR.mkdir(parents=True, exist_ok=True)
+    report_path = REPORTS_DIR / f"regressions_{datetime.now().strftime('%Y%m%d_%H%M%S')}.csv"
+    report.to_csv(report_path, index=False)
+
+    pd.set_option('display.width', None)
+    pd.set_option('display.max_colwidth', 60)
+    flagged = report[report['status'].isin(['regression', 'improvement', 'unconfirmed', 'no_baseline'])]
+    if not flagged.empty:
+        print(flagged.to_string(index=False, float_format=lambda value: f"{value:.4g}"))
+    regressions = int((report['status'] == 'regression').sum())
+    print(f"\n{len(rows)} run(s) compared: {regressions} regression(s), "
+          f"{int((report['status'] == 'improvement').sum())} improvement(s), "
+          f"{int((report['status'] == 'unconfirmed').sum())} unconfirmed, "
+          f"{int((report['status'] == 'no_baseline').sum())} without baseline")
+    print(f"✓ Report saved to: {report_path}")
+
+    if args.record:
+        for row in clean_rows:
+            record_row(store, row, args.max_runs)
+        save_store(store, args.store)
+        print(f"✓ Recorded {len(clean_rows)} run(s) without regressions in {args.store}")
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--store', type=Path, default=DEFAULT_STORE, help=f"Baseline store (default: {DEFAULT_STORE})")
+    parser.add_argument('--max-runs', type=int, default=DEFAULT_MAX_RUNS,
+                        help=f"Runs kept per baseline (default: {DEFAULT_MAX_RUNS})")
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    record = commands.add_parser('record', help='Add runs that are not in the store as baselines')
+    record.add_argument('pkl', nargs='?', help='DataFrame from parse_measurements.py (default: latest in reports/)')
+    record.set_defaults(handler=cmd_record)
+
+    compare = commands.add_parser('compare', help='Compare runs that are not in the store with their baselines')
+    compare.add_argument('pkl', nargs='?', help='DataFrame from parse_measurements.py (default: latest in reports/)')
+    compare.add_argument('--threshold', type=float, default=DEFAULT_THRESHOLD,
+                         help=f"Smallest relative change that counts (default: {DEFAULT_THRESHOLD})")
+    compare.add_argument('--alpha', type=float, default=DEFAULT_ALPHA,
+                         help=f"Significance level, one-sided (default: {DEFAULT_ALPHA})")
+    compare.add_argument('--record', action='store_true', help='Then record the runs that did not regress')
+    compare.set_defaults(handler=cmd_compare)
+
+    args = parser.parse_args()
+    return args.handler(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,13 +1,33 @@
 #!/usr/bin/env bash
 # Run all ONNX models in ./models/ directory once
 # Full flow: build → push model → measure
-# Usage: ./scripts/run_all_models.sh
+# Usage: ./scripts/run_all_models.sh [--batch] [--server] [runner options...]
+#   --batch   Push all models, then benchmark them in a single onnx_runner process
+#             (one consolidated CSV, no per-model adb round-trips)
+#   --server  Send every model as a job to a long-lived onnx_runner server on the
+#             device instead of starting the binary per model (runner_client.py)
 
 set -euo pipefail
 
+BATCH_MODE=0
+SERVER_MODE=0
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --batch) BATCH_MODE=1 ;;
+        --server) SERVER_MODE=1 ;;
+        *) break ;;
+    esac
+    shift
+done
+RUNNER_OPTIONS=("$@")
+
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 MEASUREMENT_SCRIPT="$SCRIPT_DIR/measure_model.sh"
+MEASURE_COMMAND=("$MEASUREMENT_SCRIPT")
+if [ "$SERVER_MODE" -eq 1 ]; then
+    MEASURE_COMMAND=(python3 "$SCRIPT_DIR/runner_client.py")
+fi
 PUSH_BINARY_SCRIPT="$SCRIPT_DIR/push_binary_to_device.sh"
 MODEL_DIR="./models"
 DEVICE_MODELS_DIR="/data/local/tmp/models"
@@ -76,6 +96,26 @@ log "Step 3/3: Running measurements..."
 log "============================================================"
 log ""
 
+if [ "$BATCH_MODE" -eq 1 ]; then
+    log "Batch mode: pushing all models..."
+    for modelpath in "${models[@]}"; do
+        model_relative="${modelpath#$MODEL_DIR/}"
+        model_dir=$(dirname "${model_relative}")
+        adb shell "mkdir -p ${DEVICE_MODELS_DIR}/${model_dir}" 2>/dev/null || true
+        adb push "${modelpath}" "${DEVICE_MODELS_DIR}/${model_dir}/" > /dev/null 2>&1
+    done
+    log "  ✓ ${#models[@]} model(s) pushed to device"
+    log ""
+
+    if "${MEASURE_COMMAND[@]}" "." ${RUNNER_OPTIONS[@]+"${RUNNER_OPTIONS[@]}"}; then
+        log "  ✓ Batch measurement completed successfully"
+        exit 0
+    else
+        log "  ✗ Batch measurement failed"
+        exit 1
+    fi
+fi
+
 total_runs=0
 failed_runs=0
 model_count=0
@@ -108,7 +148,7 @@ for modelpath in "${models[@]}"; do
     log "  Running measurement..."
     total_runs=$((total_runs + 1))
 
-    if "$MEASUREMENT_SCRIPT" "$model_relative"; then
+    if "${MEASURE_COMMAND[@]}" "$model_relative" ${RUNNER_OPTIONS[@]+"${RUNNER_OPTIONS[@]}"}; then
         log "  ✓ Measurement completed successfully"
     else
         log "  ✗ Measurement failed"
@@ -119,6 +159,11 @@ for modelpath in "${models[@]}"; do
     log ""
 done
 
+# The binary may be replaced before the next run; stop the server that runs the old one
+if [ "$SERVER_MODE" -eq 1 ]; then
+    python3 "$SCRIPT_DIR/runner_client.py" --shutdown || true
+fi
+
 log "============================================================"
 log "All measurements complete!"
 log "============================================================"
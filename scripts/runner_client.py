@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""
+Run a measurement through a long-lived onnx_runner server on the device.
+
+Does what measure_model.sh does, without starting a process per data point:
+the server (onnx_runner --serve) keeps warm sessions between jobs, dumps
+batterystats per window itself, streams the console output and the
+performance CSV rows back, and sends the result files over the same socket.
+
+The server is started on first use (over adb, listening on the device's
+loopback interface) and reached through `adb forward`.
+
+Usage:
+  python3 scripts/runner_client.py <onnx_path_relative_to_models> [runner options...]
+  python3 scripts/runner_client.py --shutdown
+
+Files land in ./measurements/ with the same names as with measure_model.sh, so
+parse_measurements.py reads them unchanged.
+"""
+
+import argparse
+import base64
+import json
+import socket
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+DEVICE_DIR = '/data/local/tmp'
+DEFAULT_PORT = 5557
+OUTPUT_DIR = Path('./measurements')
+
+# Same phases as measure_model.sh
+WARMUP_DURATION = 6
+SILENT_DURATION = 6
+MEASUREMENT_DURATION = 48
+
+SERVER_START_TIMEOUT_S = 10.0
+
+
+def log(message: str):
+    print(f"[{time.strftime('%H:%M:%S')}] {message}", flush=True)
+
+
+class RunnerConnection:
+    """Newline-delimited JSON over the forwarded socket."""
+
+    def __init__(self, port: int):
+        self.sock = socket.create_connection(('127.0.0.1', port))
+        self.stream = self.sock.makefile('rw', encoding='utf-8', newline='\n')
+
+    def send(self, request: dict):
+        self.stream.write(json.dumps(request) + '\n')
+        self.stream.flush()
+
+    def receive(self) -> dict:
+        line = self.stream.readline()
+        if not line:
+            raise ConnectionError('Server closed the connection')
+        return json.loads(line)
+
+    def close(self):
+        self.stream.close()
+        self.sock.close()
+
+
+def connect(port: int) -> RunnerConnection:
+    """Connect to a running server; adb accepts the forward even if nothing listens, so probe it."""
+    connection = RunnerConnection(port)
+    try:
+        connection.send({'command': 'status'})
+        connection.receive()
+    except (ConnectionError, OSError, ValueError):
+        connection.close()
+        raise ConnectionError('No server behind the forwarded port')
+    return connection
+
+
+def start_server(port: int) -> RunnerConnection:
+    subprocess.run(['adb', 'forward', f'tcp:{port}', f'tcp:{port}'], check=True, stdout=subprocess.DEVNULL)
+    try:
+        return connect(port)
+    except (ConnectionError, OSError):
+        pass
+
+    log(f"Starting onnx_runner server on the device (tcp:{port})...")
+    subprocess.run(['adb', 'shell',
+                    f'cd {DEVICE_DIR} && LD_LIBRARY_PATH=. nohup ./onnx_runner --serve=tcp:{port} '
+                    f'> {DEVICE_DIR}/onnx_runner_server.log 2>&1 &'], check=True)
+    deadline = time.monotonic() + SERVER_START_TIMEOUT_S
+    while True:
+        try:
+            return connect(port)
+        except (ConnectionError, OSError):
+            if time.monotonic() > deadline:
+                raise
+            time.sleep(0.2)
+
+
+def fetch(connection: RunnerConnection, device_path: str) -> bool:
+    connection.send({'command': 'fetch', 'path': device_path})
+    event = connection.receive()
+    if event.get('event') != 'file':
+        log(f"  ⚠ Warning: Could not fetch {device_path}: {event.get('message', event)}")
+        return False
+    local_path = OUTPUT_DIR / Path(device_path).name
+    local_path.write_bytes(base64.b64decode(event['data']))
+    log(f"  ✓ Saved: {local_path}")
+    return True
+
+
+def run_job(connection: RunnerConnection, model: str, runner_options: list, durations: tuple) -> bool:
+    warmup, silence, measurement = durations
+    connection.send({
+        'id': model,
+        'model': model,
+        'warmup': warmup,
+        'silence': silence,
+        'measurement': measurement,
+        'options': runner_options,
+    })
+
+    header = ''
+    rows = []
+    while True:
+        event = connection.receive()
+        kind = event.get('event')
+        if kind == 'log':
+            stream = sys.stderr if event.get('stream') == 'stderr' else sys.stdout
+            print(event['line'], file=stream, flush=True)
+        elif kind == 'accepted':
+            log(f"Running {model} ({event['windows']} window(s), timestamp {event['timestamp']})")
+        elif kind == 'window':
+            header = event['csv_header']
+            rows.append(event['csv_row'])
+        elif kind == 'error':
+            log(f"  ✗ Job rejected: {event['message']}")
+            return False
+        elif kind == 'done':
+            break
+
+    OUTPUT_DIR.mkdir(parents=True, exist_ok=True)
+    if rows:
+        perf_path = OUTPUT_DIR / Path(event['performance_file']).name
+        perf_path.write_text(header + ''.join(rows))
+        log(f"  ✓ Performance metrics saved to: {perf_path}")
+    for device_path in event.get('files', []):
+        fetch(connection, device_path)
+    return bool(event.get('ok'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter,
+                                     allow_abbrev=False)
+    parser.add_argument('model', nargs='?', help='Model, directory or manifest relative to models/')
+    parser.add_argument('--port', type=int, default=DEFAULT_PORT, help='Local and device TCP port')
+    parser.add_argument('--warmup', type=int, default=WARMUP_DURATION)
+    parser.add_argument('--silence', type=int, default=SILENT_DURATION)
+    parser.add_argument('--measurement', type=int, default=MEASUREMENT_DURATION)
+    parser.add_argument('--shutdown', action='store_true', help='Stop the device server and exit')
+    args, runner_options = parser.parse_known_args()
+
+    if args.shutdown:
+        subprocess.run(['adb', 'forward', f'tcp:{args.port}', f'tcp:{args.port}'], check=True,
+                       stdout=subprocess.DEVNULL)
+        try:
+            connection = connect(args.port)
+        except (ConnectionError, OSError):
+            log("No server running")
+            return 0
+        connection.send({'command': 'shutdown'})
+        connection.receive()
+        connection.close()
+        log("Server stopped")
+        return 0
+    if not args.model:
+        parser.print_usage()
+        return 1
+
+    connection = start_server(args.port)
+    try:
+        ok = run_job(connection, args.model, runner_options, (args.warmup, args.silence, args.measurement))
+    finally:
+        connection.close()
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,133 @@
+#include "allocation_counter.hpp"
+
+#ifdef ONNX_RUNNER_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+
+#if defined(__GLIBC__)
+#define INTERPOSED_NOEXCEPT noexcept
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+#else
+#include <dlfcn.h>
+#define INTERPOSED_NOEXCEPT
+#endif
+
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_bytes{0};
+
+    void count_allocation(size_t bytes) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    using MallocFunction = void *(*)(size_t);
+    using CallocFunction = void *(*)(size_t, size_t);
+    using ReallocFunction = void *(*)(void *, size_t);
+    using MemalignFunction = void *(*)(size_t, size_t);
+
+#if defined(__GLIBC__)
+    MallocFunction real_malloc() { return __libc_malloc; }
+    CallocFunction real_calloc() { return __libc_calloc; }
+    ReallocFunction real_realloc() { return __libc_realloc; }
+    MemalignFunction real_memalign() { return __libc_memalign; }
+#else
+    // bionic has no __libc_* entry points. Its dlsym does not allocate, so libc's
+    // definition (the next one after the executable) is looked up on first use.
+    template<typename Function>
+    Function next_definition(std::atomic<void *> &slot, const char *name) {
+        void *function = slot.load(std::memory_order_acquire);
+        if (function == nullptr) {
+            function = dlsym(RTLD_NEXT, name);
+            slot.store(function, std::memory_order_release);
+        }
+        return reinterpret_cast<Function>(function);
+    }
+
+    std::atomic<void *> g_malloc{nullptr};
+    std::atomic<void *> g_calloc{nullptr};
+    std::atomic<void *> g_realloc{nullptr};
+    std::atomic<void *> g_memalign{nullptr};
+
+    MallocFunction real_malloc() { return next_definition<MallocFunction>(g_malloc, "malloc"); }
+    CallocFunction real_calloc() { return next_definition<CallocFunction>(g_calloc, "calloc"); }
+    ReallocFunction real_realloc() { return next_definition<ReallocFunction>(g_realloc, "realloc"); }
+    MemalignFunction real_memalign() { return next_definition<MemalignFunction>(g_memalign, "memalign"); }
+#endif
+}
+
+// Definitions in the executable take precedence over libc's for every library,
+// libonnxruntime.so included. free() is left alone: only allocations are counted.
+extern "C" {
+void *malloc(size_t size) INTERPOSED_NOEXCEPT {
+    count_allocation(size);
+    return real_malloc()(size);
+}
+
+void *calloc(size_t count, size_t size) INTERPOSED_NOEXCEPT {
+    count_allocation(count * size);
+    return real_calloc()(count, size);
+}
+
+void *realloc(void *ptr, size_t size) INTERPOSED_NOEXCEPT {
+    if (size > 0) {
+        count_allocation(size);
+    }
+    return real_realloc()(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) INTERPOSED_NOEXCEPT {
+    count_allocation(size);
+    return real_memalign()(alignment, size);
+}
+
+// aligned_alloc (API 28+ on Android) and posix_memalign go through memalign,
+// which every libc version provides
+void *aligned_alloc(size_t alignment, size_t size) INTERPOSED_NOEXCEPT {
+    count_allocation(size);
+    return real_memalign()(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) INTERPOSED_NOEXCEPT {
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    count_allocation(size);
+    void *ptr = real_memalign()(alignment, size);
+    if (ptr == nullptr && size > 0) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+}
+
+bool allocation_counting_enabled() {
+    return true;
+}
+
+AllocationCounts allocation_counts() {
+    AllocationCounts counts;
+    counts.allocations = g_allocations.load(std::memory_order_relaxed);
+    counts.bytes = g_bytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+#else
+
+bool allocation_counting_enabled() {
+    return false;
+}
+
+AllocationCounts allocation_counts() {
+    return AllocationCounts();
+}
+
+#endif
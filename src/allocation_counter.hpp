@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocations made by the whole process, ONNX Runtime included.
+//
+// Counting needs a build with ONNX_RUNNER_COUNT_ALLOCATIONS (make COUNT_ALLOCATIONS=1),
+// which interposes malloc, calloc, realloc and the aligned variants in the
+// executable and forwards them to libc. Without it the counts stay at zero.
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;  // Requested bytes
+};
+
+// Whether this build counts allocations
+bool allocation_counting_enabled();
+
+// Allocations since process start
+AllocationCounts allocation_counts();
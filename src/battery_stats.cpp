@@ -0,0 +1,12 @@
+#include "battery_stats.hpp"
+
+#include <cstdlib>
+
+int reset_battery_stats() {
+    return system("dumpsys batterystats --reset > /dev/null 2>&1");
+}
+
+int dump_battery_stats(const std::string &output_file) {
+    const std::string dump_cmd = "dumpsys batterystats > '" + output_file + "' 2>/dev/null";
+    return system(dump_cmd.c_str());
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+// Reset Android battery statistics so the next dump only covers what follows.
+// Returns the exit code of dumpsys (0 on success).
+int reset_battery_stats();
+
+// Write the current battery statistics to output_file. Returns dumpsys' exit code.
+int dump_battery_stats(const std::string &output_file);
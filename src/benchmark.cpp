@@ -0,0 +1,929 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <onnxruntime_cxx_api.h>
+#include "allocation_counter.hpp"
+#include "battery_stats.hpp"
+#include "confidence_monitor.hpp"
+#include "config.hpp"
+#include "cpu_affinity.hpp"
+#include "device_identity.hpp"
+#include "inference_session.hpp"
+#include "memory_stats.hpp"
+#include "node_placement.hpp"
+#include "op_profile.hpp"
+#include "profile_trace.hpp"
+#include "rate_pacer.hpp"
+#include "results_csv.hpp"
+#include "results_sink.hpp"
+#include "runner_paths.hpp"
+#include "warmup_monitor.hpp"
+#include "worker_pool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    double elapsed_ms(clock::time_point start, clock::time_point end) {
+        return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+    }
+
+    uint64_t duration_ns(clock::duration duration) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+
+    int64_t epoch_ms_now() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // A cache file is usable if it was written after the model last changed
+    bool is_fresh_cache(const std::string &cache_path, const std::string &model_path) {
+        std::error_code ec;
+        const auto cache_time = fs::last_write_time(cache_path, ec);
+        if (ec) {
+            return false;
+        }
+        const auto model_time = fs::last_write_time(model_path, ec);
+        return !ec && cache_time >= model_time;
+    }
+
+    // Print each input's type and resolved shape, and any override that matched nothing
+    void print_inputs(const std::vector<ModelInput> &inputs, const InputConfig &config) {
+        for (const auto &input: inputs) {
+            std::cout << "  ℹ Input '" << input.name << "': " << element_type_name(input.element_type) << " [";
+            for (size_t d = 0; d < input.shape.size(); ++d) {
+                std::cout << (d == 0 ? "" : ",") << input.shape[d];
+            }
+            std::cout << "]";
+            if (input.mapping) {
+                std::cout << " from " << input.source << " (" << input.tensors.size() << " sample(s))";
+            }
+            std::cout << "\n";
+        }
+        for (const auto &name: unmatched_dim_overrides(inputs, config)) {
+            std::cerr << "  ⚠ Warning: No input has a dynamic dimension named '" << name << "'\n";
+        }
+    }
+}
+
+bool run_benchmark_case(const BenchmarkCase &bench_case, const PhaseDurations &durations,
+                        BenchmarkResult &result) {
+    result.bench_case = bench_case;
+    const SessionConfig &session_config = bench_case.session;
+
+    // Pin the driver thread before the session exists, so that ORT's worker
+    // threads (created with the session) inherit the same CPU mask
+    std::string affinity_error;
+    if (!apply_cpu_affinity(session_config.cpu_mask, affinity_error)) {
+        std::cerr << "Error: Failed to set CPU affinity "
+                << cpu_mask_name(session_config.cpu_mask) << ": " << affinity_error << "\n";
+        return false;
+    }
+
+    // Report which execution provider each node landed on, using a separate
+    // profiling session so that the benchmarked session is not profiled
+    if (!bench_case.placement_file.empty()) {
+        std::cout << "[Setup] Collecting node placement...\n";
+        NodePlacement placement;
+        std::string placement_error;
+        const std::string profile_prefix = bench_case.placement_file.substr(
+            0, bench_case.placement_file.find_last_of('.'));
+        if (collect_node_placement(bench_case.model_path, session_config, bench_case.inputs, profile_prefix,
+                                   placement, placement_error)) {
+            result.provider_node_counts = format_provider_counts(placement);
+            for (const auto &entry: placement.provider_node_counts) {
+                std::cout << "  " << entry.first << ": " << entry.second << " node(s)\n";
+            }
+            if (export_node_placement_csv(bench_case.placement_file, placement)) {
+                std::cout << "  ℹ Node placement exported to: " << bench_case.placement_file << "\n";
+                std::cout << "RESULT_FILE=" << bench_case.placement_file << "\n";  // For script parsing
+            }
+            std::cout << "\n";
+        } else {
+            std::cerr << "  ⚠ Warning: Failed to collect node placement: " << placement_error << "\n\n";
+        }
+    }
+
+    // Load the optimized-model cache if it is newer than the model, otherwise let this
+    // session write it. Compiling providers keep fused nodes that cannot be saved.
+    SessionConfig setup_config = session_config;
+    std::string load_path = bench_case.model_path;
+    if (!bench_case.optimized_model_path.empty()) {
+        if (session_config.execution_provider != ExecutionProvider::Cpu) {
+            std::cerr << "  ⚠ Warning: Optimized-model cache is only supported with the CPU provider\n";
+        } else if (is_fresh_cache(bench_case.optimized_model_path, bench_case.model_path)) {
+            load_path = bench_case.optimized_model_path;
+            result.model_source = "optimized_cache";
+        } else {
+            std::error_code ec;
+            fs::create_directories(fs::path(bench_case.optimized_model_path).parent_path(), ec);
+            setup_config.optimized_model_path = bench_case.optimized_model_path;
+        }
+    }
+
+    // Build the session once so that only Run() is timed. In cold-load mode every
+    // iteration rebuilds the environment and session instead, and the setup
+    // session only resolves the inputs.
+    std::shared_ptr<InferenceSession> session;
+    std::string startup_profile_prefix;
+    if (bench_case.startup_profile) {
+        startup_profile_prefix = measurements_dir() + "/startup_profile";
+    }
+    // Telemetry covers all phases. The benchmark threads only bump the atomics
+    // in `progress`; the sampler thread does the sysfs reads.
+    RunProgress progress;
+    std::unique_ptr<TelemetrySampler> telemetry;
+    if (bench_case.telemetry_interval_ms > 0) {
+        telemetry = std::make_unique<TelemetrySampler>(
+            std::chrono::milliseconds(bench_case.telemetry_interval_ms),
+            std::chrono::seconds(durations.warmup_seconds + durations.silence_seconds + durations.measurement_seconds),
+            progress);
+        if (!telemetry->start()) {
+            std::cerr << "  ⚠ Warning: No cpufreq or thermal zone readable, telemetry disabled\n";
+            telemetry.reset();
+        }
+    }
+
+    // Only plain warm sessions are cached: cold loads and startup profiles measure the
+    // build itself, and a session that writes the optimized-model cache is a one-off
+    const bool cacheable = bench_case.session_cache != nullptr && !bench_case.cold_load &&
+                           !bench_case.startup_profile && setup_config.optimized_model_path.empty();
+    const std::string cache_key = cacheable ? session_cache_key(load_path, setup_config, bench_case.inputs) : "";
+
+    std::cout << "[Setup] Loading model" << (load_path != bench_case.model_path ? " (optimized cache)" : "")
+            << "...\n";
+    reset_peak_rss();
+    result.rss_before_setup_kb = read_process_memory().rss_kb;
+    const auto setup_start = clock::now();
+    if (cacheable) {
+        if (const CachedSession *cached = bench_case.session_cache->find(cache_key)) {
+            session = cached->session;
+            result.session_reused = true;
+            result.setup_saved_ms = cached->setup_ms;
+        }
+    }
+    if (!session) {
+        try {
+            session = std::make_shared<InferenceSession>(load_path, setup_config, bench_case.inputs,
+                                                         startup_profile_prefix);
+        } catch (const Ort::Exception &e) {
+            std::cerr << "ONNX Runtime error during setup: " << e.what() << "\n";
+            return false;
+        } catch (const std::exception &e) {
+            std::cerr << "Error during setup: " << e.what() << "\n";
+            return false;
+        }
+    }
+    result.setup_ms = elapsed_ms(setup_start, clock::now());
+    result.rss_after_setup_kb = read_process_memory().rss_kb;
+    if (cacheable) {
+        if (!result.session_reused) {
+            CachedSession entry;
+            entry.session = session;
+            entry.setup_ms = result.setup_ms;
+            if (result.rss_before_setup_kb >= 0 && result.rss_after_setup_kb >= 0) {
+                entry.resident_kb = std::max<int64_t>(0, result.rss_after_setup_kb - result.rss_before_setup_kb);
+            }
+            bench_case.session_cache->insert(cache_key, std::move(entry));
+        }
+        result.session_cache_used = true;
+        result.session_cache = bench_case.session_cache->stats();
+    }
+    if (result.session_reused) {
+        std::cout << "  ✓ Session reused from cache (" << result.setup_ms << "ms)\n";
+    } else {
+        result.startup = session->startup_timings();
+        std::cout << "  ✓ Session ready (" << result.setup_ms << "ms: read " << result.startup.file_read_ms
+                << ", create " << result.startup.session_create_ms << ", inputs " << result.startup.input_prep_ms
+                << ", first run " << result.startup.first_run_ms << ")\n";
+    }
+
+    if (!setup_config.optimized_model_path.empty() && fs::exists(setup_config.optimized_model_path)) {
+        result.optimized_model_saved = true;
+        load_path = setup_config.optimized_model_path;
+        std::cout << "  ℹ Optimized model saved to: " << setup_config.optimized_model_path << "\n";
+    }
+
+    // The profiler covers session creation and the priming run; ending it here
+    // keeps the benchmarked runs unprofiled
+    if (bench_case.startup_profile) {
+        ProfileTrace trace;
+        std::string trace_error;
+        const std::string profile_path = session->end_profiling();
+        if (load_profile_trace(profile_path, trace, trace_error)) {
+            result.model_load_ms = (session_event_us(trace, "model_loading_uri") +
+                                    session_event_us(trace, "model_loading_array")) / 1000.0;
+            result.session_init_ms = session_event_us(trace, "session_initialization") / 1000.0;
+            std::cout << "  ℹ Profiled: model loading " << result.model_load_ms << "ms, session initialization "
+                    << result.session_init_ms << "ms\n";
+        } else {
+            std::cerr << "  ⚠ Warning: Failed to read startup profile: " << trace_error << "\n";
+        }
+        std::remove(profile_path.c_str());
+    }
+
+    print_inputs(session->inputs(), bench_case.inputs);
+    std::cout << "\n";
+    result.input_shapes = format_input_shapes(session->inputs());
+    result.samples_per_inference = samples_per_inference(session->inputs());
+    result.dataset_samples = dataset_size(session->inputs());
+
+    // Concurrent mode: every worker runs either the shared session through its
+    // own bindings, or a session of its own (the setup session is worker 0's)
+    std::vector<std::unique_ptr<InferenceSession> > worker_sessions;
+    std::vector<std::unique_ptr<RunContext> > worker_contexts;
+    std::unique_ptr<WorkerPool> pool;
+    if (bench_case.workers > 1) {
+        std::cout << "[Setup] Preparing " << bench_case.workers << " workers ("
+                << (bench_case.per_worker_sessions ? "one session each" : "shared session") << ")...\n";
+        std::vector<WorkerPool::RunFunction> run_functions;
+        try {
+            for (int worker = 0; worker < bench_case.workers; ++worker) {
+                if (!bench_case.per_worker_sessions) {
+                    worker_contexts.push_back(session->create_run_context(static_cast<size_t>(worker)));
+                    RunContext *context = worker_contexts.back().get();
+                    InferenceSession *shared = session.get();
+                    run_functions.emplace_back([shared, context]() { shared->run(*context); });
+                } else if (worker == 0) {
+                    InferenceSession *own = session.get();
+                    run_functions.emplace_back([own]() { own->run(); });
+                } else {
+                    worker_sessions.push_back(std::make_unique<InferenceSession>(load_path, session_config,
+                                                                                 bench_case.inputs));
+                    InferenceSession *own = worker_sessions.back().get();
+                    run_functions.emplace_back([own]() { own->run(); });
+                }
+            }
+        } catch (const std::exception &e) {
+            std::cerr << "Error preparing workers: " << e.what() << "\n";
+            return false;
+        }
+        pool = std::make_unique<WorkerPool>(std::move(run_functions));
+        for (int worker = 0; worker < bench_case.workers; ++worker) {
+            result.worker_latency.push_back(std::make_unique<LatencyHistogram>());
+        }
+        std::cout << "  ✓ Workers ready\n\n";
+    }
+
+    // Prepared inputs go into buffers of their own, so the setup inputs stay
+    // untouched for validation and profiling
+    std::unique_ptr<InputPipeline> input_pipeline;
+    if (bench_case.prep_mode != PrepMode::None) {
+        std::cout << "[Setup] Preparing inputs before every run (" << prep_mode_name(bench_case.prep_mode) << ", "
+                << bench_case.prep_passes << (bench_case.prep_passes == 1 ? " pass" : " passes") << ")...\n";
+        try {
+            input_pipeline = std::make_unique<InputPipeline>(*session, bench_case.prep_mode, bench_case.prep_passes,
+                                                             bench_case.inputs.seed);
+        } catch (const std::exception &e) {
+            std::cerr << "Error preparing the input pipeline: " << e.what() << "\n";
+            return false;
+        }
+        std::cout << "  ✓ Input pipeline ready\n\n";
+    }
+
+    // Later cold loads read the cache written above (without rewriting it)
+    StartupTimings cold_totals;
+    if (bench_case.cold_load) {
+        session.reset();
+    }
+    const auto run_once = [&]() {
+        if (input_pipeline) {
+            input_pipeline->run();
+        } else if (session) {
+            session->run();
+        } else {
+            const StartupTimings timings = run_onnx_inference(load_path, session_config, bench_case.inputs);
+            cold_totals.file_read_ms += timings.file_read_ms;
+            cold_totals.session_create_ms += timings.session_create_ms;
+            cold_totals.input_prep_ms += timings.input_prep_ms;
+            cold_totals.first_run_ms += timings.first_run_ms;
+        }
+    };
+
+    // Open loop on the calling thread: one request per period until the deadline
+    // (or until an adaptive warmup converges or the confidence target is reached),
+    // idle in between. Late requests run back to back until the schedule catches up.
+    const bool paced = bench_case.target_rate_hz > 0.0;
+    std::unique_ptr<IterationLog> iteration_log;
+    std::unique_ptr<WarmupMonitor> warmup_monitor;
+    std::unique_ptr<ConfidenceMonitor> ci_monitor;
+    const auto stop_early = [&]() {
+        return (warmup_monitor && warmup_monitor->converged()) || (ci_monitor && ci_monitor->update(clock::now()));
+    };
+    const auto run_paced = [&](clock::time_point start, clock::time_point deadline, bool record,
+                               uint64_t &iterations) {
+        RatePacer pacer(bench_case.target_rate_hz, start);
+        while (pacer.next() < deadline && !stop_early()) {
+            const auto scheduled = pacer.wait();
+            const auto run_start = clock::now();
+            run_once();
+            const auto run_end = clock::now();
+            progress.record_run(duration_ns(run_end - run_start));
+            if (warmup_monitor) {
+                warmup_monitor->record(run_end, duration_ns(run_end - run_start));
+            }
+            if (record) {
+                result.latency->record(duration_ns(run_end - run_start));
+                result.queue_delay->record(duration_ns(run_start - scheduled));
+                const bool missed = pacer.missed(scheduled, run_end);
+                if (missed) {
+                    ++result.missed_deadlines;
+                }
+                if (iteration_log) {
+                    iteration_log->record(0, run_start, run_end, missed ? IterationLog::MISSED_DEADLINE : 0);
+                }
+            }
+            ++iterations;
+        }
+        if (!stop_early() && clock::now() < deadline) {
+            sleep_until_absolute(deadline);
+        }
+    };
+
+    // Background load runs from here to the end of the measurement window, so that
+    // warmup settles under the same contention that is measured
+    std::unique_ptr<BackgroundLoad> background;
+    if (!bench_case.interference.empty()) {
+        std::cout << "[Setup] Starting background load: " << format_interference(bench_case.interference) << "...\n";
+        background = std::make_unique<BackgroundLoad>(bench_case.interference, session_config.cpu_mask);
+        std::string load_error;
+        if (!background->start(load_error)) {
+            std::cerr << "Error starting background load: " << load_error << "\n";
+            return false;
+        }
+        std::cout << "  ✓ Background load running\n\n";
+    }
+
+    // Phase 1: Warmup (adaptive: until the latency settles, warmup_seconds at most)
+    progress.begin_phase(BenchmarkPhase::Warmup);
+    if (durations.warmup_seconds > 0) {
+        const bool adaptive = bench_case.warmup_cv_threshold > 0.0;
+        if (adaptive) {
+            std::cout << "[Phase 1/3] Warmup (adaptive: CV < " << bench_case.warmup_cv_threshold * 100.0
+                    << "% over " << bench_case.warmup_window << " runs, at most " << durations.warmup_seconds
+                    << "s)...\n";
+        } else {
+            std::cout << "[Phase 1/3] Warmup (" << durations.warmup_seconds << "s)...\n";
+        }
+        const auto start = clock::now();
+        const auto deadline = start + std::chrono::seconds(durations.warmup_seconds);
+        if (adaptive) {
+            warmup_monitor = std::make_unique<WarmupMonitor>(
+                static_cast<size_t>(bench_case.warmup_window), bench_case.warmup_cv_threshold,
+                std::chrono::milliseconds(Config::WARMUP_MIN_MS), start);
+        }
+
+        if (pool) {
+            WorkerRecording recording;
+            recording.progress = &progress;
+            recording.warmup = warmup_monitor.get();
+            if (warmup_monitor) {
+                recording.stop_early = [&]() { return warmup_monitor->converged(); };
+            }
+            WorkerPhaseStats stats;
+            std::string worker_error;
+            if (!pool->run_for(std::chrono::seconds(durations.warmup_seconds), bench_case.target_rate_hz,
+                               recording, stats, worker_error)) {
+                std::cerr << "ONNX Runtime error during warmup: " << worker_error << "\n";
+                return false;
+            }
+            result.warmup_iterations = stats.iterations;
+        } else if (paced) {
+            try {
+                run_paced(start, deadline, false, result.warmup_iterations);
+            } catch (const Ort::Exception &e) {
+                std::cerr << "ONNX Runtime error during warmup: " << e.what() << "\n";
+                return false;
+            }
+        } else {
+            // Only the run is timed, as in the measurement loop, so the CV test
+            // does not see the recording and the convergence check
+            auto run_end = clock::now();
+            while (run_end < deadline && !stop_early()) {
+                try {
+                    const auto run_start = clock::now();
+                    run_once();
+                    run_end = clock::now();
+                    progress.record_run(duration_ns(run_end - run_start));
+                    if (warmup_monitor) {
+                        warmup_monitor->record(run_end, duration_ns(run_end - run_start));
+                    }
+                    ++result.warmup_iterations;
+                } catch (const Ort::Exception &e) {
+                    std::cerr << "ONNX Runtime error during warmup: " << e.what() << "\n";
+                    return false;
+                }
+            }
+        }
+
+        result.warmup_elapsed_ms = elapsed_ms(start, clock::now());
+        std::cout << "  ✓ Warmup completed (" << result.warmup_iterations << " iterations, "
+                << result.warmup_elapsed_ms << "ms)\n";
+        if (warmup_monitor) {
+            result.warmup_converged = warmup_monitor->converged();
+            result.warmup_converged_iterations = warmup_monitor->converged_iterations();
+            result.warmup_cv = warmup_monitor->cv();
+            if (result.warmup_converged) {
+                std::cout << "  ✓ Latency converged after " << result.warmup_converged_iterations
+                        << " iterations (CV " << result.warmup_cv * 100.0 << "%)\n";
+            } else {
+                std::cerr << "  ⚠ Warning: Latency did not converge within " << durations.warmup_seconds << "s (";
+                if (result.warmup_cv < 0.0) {
+                    std::cerr << "fewer than " << bench_case.warmup_window << " runs";
+                } else {
+                    std::cerr << "CV " << result.warmup_cv * 100.0 << "%";
+                }
+                std::cerr << "); measuring anyway\n";
+            }
+            warmup_monitor.reset();
+        }
+        std::cout << "\n";
+    }
+    result.rss_after_warmup_kb = read_process_memory().rss_kb;
+
+    // Phase 2: Silence - just wait for system stabilization
+    progress.begin_phase(BenchmarkPhase::Silence);
+    if (durations.silence_seconds > 0) {
+        std::cout << "[Phase 2/3] Silence (" << durations.silence_seconds << "s)...\n";
+        std::this_thread::sleep_for(std::chrono::seconds(durations.silence_seconds));
+        std::cout << "  ✓ Silence completed\n\n";
+    }
+
+    // Reset battery statistics before measurement
+    if (bench_case.batterystats) {
+        std::cout << "[Phase 2.5/3] Resetting battery statistics...\n";
+        result.stats_reset_epoch_ms = epoch_ms_now();
+        const int reset_result = reset_battery_stats();
+        if (reset_result == 0) {
+            std::cout << "  ✓ Battery statistics reset\n\n";
+        } else {
+            std::cerr << "  ⚠ Warning: Failed to reset battery statistics (code: "
+                    << reset_result << ")\n\n";
+        }
+
+        // Small delay to ensure stats are reset
+        std::this_thread::sleep_for(std::chrono::milliseconds(Config::STATS_RESET_DELAY_MS));
+    }
+
+    // The fuel gauge (RAPL on a Linux host) is read in-process for the exact measurement window
+    PowerSampler power_sampler(std::chrono::milliseconds(bench_case.power_interval_ms));
+    if (bench_case.power_interval_ms > 0) {
+        std::string power_error;
+        if (power_sampler.open(power_error)) {
+            result.power_collected = true;
+            if (power_sampler.charging()) {
+                std::cerr << "  ⚠ Warning: Battery is charging; power includes the charger (use WiFi ADB)\n";
+            }
+        } else {
+            std::cerr << "  ⚠ Warning: Power sampling unavailable: " << power_error << "\n";
+        }
+    }
+
+    // Phase 3: Measurement (with a confidence target: until the interval is narrow
+    // enough, measurement_seconds at most)
+    CiMetric ci_metric = bench_case.ci_metric;
+    if (bench_case.ci_target > 0.0) {
+        if (ci_metric == CiMetric::Energy && !result.power_collected) {
+            std::cerr << "  ⚠ Warning: No sampled power, confidence target applies to latency\n";
+            ci_metric = CiMetric::Latency;
+        }
+        std::cout << "[Phase 3/3] Measurement (until the 95% CI of " << ci_metric_name(ci_metric) << " is within ±"
+                << bench_case.ci_target * 100.0 << "%, " << std::min(bench_case.ci_min_seconds,
+                                                                     durations.measurement_seconds)
+                << "-" << durations.measurement_seconds << "s)...\n";
+    } else {
+        std::cout << "[Phase 3/3] Measurement (" << durations.measurement_seconds << "s)...\n";
+    }
+    cold_totals = StartupTimings();
+    LatencyHistogram &latency = *result.latency;
+    MemorySampler memory_sampler(std::chrono::milliseconds(Config::MEMORY_SAMPLE_INTERVAL_MS));
+    memory_sampler.start();
+    if (result.power_collected) {
+        power_sampler.start();
+    }
+    // Counters follow the threads that exist now (ORT's pools) and any the driver
+    // thread creates during the window (workers, cold-load sessions)
+    PerfCounters perf_counters;
+    if (bench_case.perf_counters) {
+        std::string perf_error;
+        if (perf_counters.open(current_cpu_mask(), perf_error)) {
+            result.perf_collected = true;
+            if (perf_counters.user_space_only()) {
+                std::cout << "  ℹ Performance counters count user space only (perf_event_paranoid)\n";
+            }
+        } else {
+            std::cerr << "  ⚠ Warning: Performance counters unavailable: " << perf_error
+                    << " (try: adb shell setprop security.perf_harden 0)\n";
+        }
+    }
+    // Chunks are allocated and the file opened before the window; iterations are
+    // then handed to the writer thread without blocking the timed loop
+    if (!bench_case.iteration_log_file.empty()) {
+        iteration_log = std::make_unique<IterationLog>(static_cast<size_t>(bench_case.workers),
+                                                       bench_case.cold_load ? 1000 : 1);
+        std::string log_error;
+        const int64_t epoch_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        if (!iteration_log->open(bench_case.iteration_log_file, clock::now(), epoch_ns, log_error)) {
+            std::cerr << "  ⚠ Warning: Could not create iteration log " << bench_case.iteration_log_file << ": "
+                    << log_error << "\n";
+            iteration_log.reset();
+        }
+    }
+    const std::vector<PowerRailEnergy> rails_start = read_power_rails();
+    const AllocationCounts allocations_start = allocation_counts();
+    progress.begin_phase(BenchmarkPhase::Measurement);
+    if (result.perf_collected) {
+        perf_counters.start();
+    }
+    result.measurement_start_epoch_ms = epoch_ms_now();
+    const auto measurement_start = clock::now();
+    if (background) {
+        background->begin_window();
+    }
+    if (input_pipeline) {
+        input_pipeline->reset_stats();
+    }
+    const auto measurement_deadline = measurement_start + std::chrono::seconds(durations.measurement_seconds);
+    if (bench_case.ci_target > 0.0) {
+        ci_monitor = std::make_unique<ConfidenceMonitor>(
+            ci_metric, bench_case.ci_target, std::chrono::milliseconds(Config::CI_BATCH_MS),
+            std::chrono::seconds(bench_case.ci_min_seconds), std::chrono::seconds(durations.measurement_seconds),
+            progress,
+            result.power_collected ? &power_sampler : nullptr, measurement_start);
+    }
+
+    // Only the run itself is timed; the recording and the confidence check
+    // between runs count towards the window's wall time (measurement_elapsed_ms)
+    // but not towards the latency. Workers time each of their runs themselves.
+    auto measurement_end = measurement_start;
+    if (pool) {
+        WorkerRecording recording;
+        recording.latency = &latency;
+        for (auto &histogram: result.worker_latency) {
+            recording.worker_latency.push_back(histogram.get());
+        }
+        recording.queue_delay = result.queue_delay.get();
+        recording.progress = &progress;
+        recording.iteration_log = iteration_log.get();
+        if (ci_monitor) {
+            recording.stop_early = [&]() { return ci_monitor->update(clock::now()); };
+        }
+        WorkerPhaseStats stats;
+        std::string worker_error;
+        if (!pool->run_for(std::chrono::seconds(durations.measurement_seconds), bench_case.target_rate_hz,
+                           recording, stats, worker_error)) {
+            std::cerr << "ONNX Runtime error during measurement: " << worker_error << "\n";
+            return false;
+        }
+        result.measurement_iterations = stats.iterations;
+        result.missed_deadlines = stats.missed_deadlines;
+        measurement_end = clock::now();
+    } else if (paced) {
+        try {
+            run_paced(measurement_start, measurement_deadline, true, result.measurement_iterations);
+        } catch (const Ort::Exception &e) {
+            std::cerr << "ONNX Runtime error during measurement: " << e.what() << "\n";
+            return false;
+        }
+        measurement_end = clock::now();
+    } else {
+        while (measurement_end < measurement_deadline) {
+            const auto run_start = clock::now();
+            try {
+                run_once();
+            } catch (const Ort::Exception &e) {
+                std::cerr << "ONNX Runtime error during measurement: " << e.what() << "\n";
+                return false;
+            }
+            measurement_end = clock::now();
+            latency.record(duration_ns(measurement_end - run_start));
+            progress.record_run(duration_ns(measurement_end - run_start));
+            if (iteration_log) {
+                iteration_log->record(0, run_start, measurement_end);
+            }
+            ++result.measurement_iterations;
+            if (ci_monitor && ci_monitor->update(measurement_end)) {
+                break;
+            }
+        }
+    }
+    if (ci_monitor) {
+        result.ci_collected = true;
+        result.ci_metric = ci_metric;
+        result.ci = ci_monitor->interval();
+        result.ci_reached = ci_monitor->reached();
+        ci_monitor.reset();
+    }
+
+    result.measurement_elapsed_ms = elapsed_ms(measurement_start, measurement_end);
+    result.measurement_end_epoch_ms = epoch_ms_now();
+    if (background) {
+        background->stop();
+        result.interference_load = background->achieved_load();
+        background.reset();
+    }
+    if (input_pipeline) {
+        const LatencyHistogram &end_to_end = input_pipeline->end_to_end();
+        result.e2e_latency_mean_us = ns_to_us(end_to_end.mean_ns());
+        result.e2e_latency_p50_us = ns_to_us(static_cast<double>(end_to_end.percentile_ns(50.0)));
+        result.e2e_latency_p99_us = ns_to_us(static_cast<double>(end_to_end.percentile_ns(99.0)));
+        result.prep_mean_us = input_pipeline->prep_mean_us();
+        result.prep_stall_mean_us = input_pipeline->stall_mean_us();
+        input_pipeline.reset();
+    }
+    if (result.perf_collected) {
+        perf_counters.stop();
+        result.perf = perf_counters.read();
+    }
+    const AllocationCounts allocations_end = allocation_counts();
+    if (result.power_collected) {
+        power_sampler.stop();
+        result.power = power_sampler.summary();
+    }
+    result.rail_energy_j = format_rail_energy(rails_start, read_power_rails());
+    if (iteration_log) {
+        if (!iteration_log->close()) {
+            std::cerr << "  ⚠ Warning: Error writing to iteration log\n";
+        }
+        result.iteration_log_records = iteration_log->written();
+        result.iteration_log_dropped = iteration_log->dropped();
+    }
+    memory_sampler.stop();
+    result.rss_measurement_mean_kb = memory_sampler.mean_rss_kb();
+    result.rss_measurement_peak_kb = memory_sampler.peak_rss_kb();
+    result.vm_hwm_kb = read_process_memory().hwm_kb;
+    if (telemetry) {
+        telemetry->stop();
+        result.telemetry_collected = true;
+        result.telemetry = telemetry->summarize(BenchmarkPhase::Measurement);
+    }
+
+    std::cout << "  ✓ Measurement completed\n\n";
+
+    if (iteration_log) {
+        if (result.iteration_log_dropped > 0) {
+            std::cerr << "  ⚠ Warning: Iteration log dropped " << result.iteration_log_dropped << " of "
+                    << (result.iteration_log_records + result.iteration_log_dropped)
+                    << " iterations (writer fell behind)\n";
+        }
+        std::cout << "  ℹ Iteration log written to: " << bench_case.iteration_log_file << "\n";
+        std::cout << "RESULT_FILE=" << bench_case.iteration_log_file << "\n";  // For script parsing
+    }
+    if (telemetry && !bench_case.telemetry_file.empty() && telemetry->export_csv(bench_case.telemetry_file)) {
+        std::cout << "  ℹ Telemetry exported to: " << bench_case.telemetry_file << "\n";
+        std::cout << "RESULT_FILE=" << bench_case.telemetry_file << "\n";  // For script parsing
+    }
+
+    // Capture the battery statistics of this window before anything else runs
+    if (!bench_case.batterystats_file.empty()) {
+        const int dump_result = dump_battery_stats(bench_case.batterystats_file);
+        if (dump_result == 0) {
+            std::cout << "  ✓ Battery statistics saved to: " << bench_case.batterystats_file << "\n";
+            std::cout << "BATTERYSTATS_FILE=" << bench_case.batterystats_file << "\n";  // For script parsing
+        } else {
+            std::cerr << "  ⚠ Warning: Failed to dump battery statistics (code: "
+                    << dump_result << ")\n";
+        }
+    }
+
+    // Profile a bounded number of runs on a separate session, after the window so
+    // that the profiler's overhead stays out of the measured energy
+    if (bench_case.profile_runs > 0 && !bench_case.profile_file.empty()) {
+        std::cout << "[Profile] Profiling " << bench_case.profile_runs << " inferences per operator...\n";
+        OpProfile op_profile;
+        std::string profile_error;
+        const std::string profile_prefix = bench_case.profile_file.substr(0, bench_case.profile_file.find_last_of('.'));
+        if (collect_op_profile(load_path, session_config, bench_case.inputs, profile_prefix,
+                               static_cast<size_t>(bench_case.profile_runs), op_profile, profile_error)) {
+            result.top_op_types = format_top_op_types(op_profile, Config::PROFILE_TOP_OP_TYPES);
+            for (size_t i = 0; i < op_profile.op_types.size() && i < Config::PROFILE_TOP_OP_TYPES; ++i) {
+                const OpTiming &timing = op_profile.op_types[i];
+                std::cout << "  " << timing.name << ": " << timing.total_us / static_cast<double>(op_profile.runs)
+                        << " µs/run (" << 100.0 * timing.total_us / op_profile.kernel_total_us << "%, "
+                        << timing.provider << ")\n";
+            }
+            if (export_op_profile_csv(bench_case.profile_file, op_profile)) {
+                std::cout << "  ℹ Op profile exported to: " << bench_case.profile_file << "\n";
+                std::cout << "RESULT_FILE=" << bench_case.profile_file << "\n";  // For script parsing
+            }
+        } else {
+            std::cerr << "  ⚠ Warning: Failed to profile operators: " << profile_error << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // Compare outputs on fresh sessions, also after the window, so that neither the
+    // reference run nor the comparison is measured
+    if (bench_case.validate) {
+        std::cout << "[Validate] Comparing outputs with the CPU fp32 reference...\n";
+        std::string validation_error;
+        if (validate_outputs(load_path, session_config, bench_case.inputs, bench_case.validation, result.validation,
+                             validation_error)) {
+            result.validation_collected = true;
+            std::cout << "  " << (result.validation.passed ? "✓" : "⚠ Warning:") << " " << result.validation.outputs
+                    << " output(s) × " << result.validation.samples << " sample(s): max abs error "
+                    << result.validation.max_abs_error << ", min cosine " << result.validation.min_cosine << " ("
+                    << result.validation.worst_output << ")\n";
+        } else {
+            std::cerr << "  ⚠ Warning: Failed to validate outputs: " << validation_error << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // Hashed after the window, so reading the file does not touch setup or the measured runs
+    result.model_hash = model_file_hash(bench_case.model_path);
+
+    // Calculate metrics; per-inference ones are -1 when no run finished in the
+    // window (a very short window, or a confidence target met at once)
+    const bool completed_runs = result.measurement_iterations > 0 && result.measurement_elapsed_ms > 0.0;
+    result.total_time_sec = result.measurement_elapsed_ms / 1000.0;
+    if (completed_runs) {
+        result.us_per_inference = (result.measurement_elapsed_ms * 1000.0) /
+                                  static_cast<double>(result.measurement_iterations);
+        result.throughput = static_cast<double>(result.measurement_iterations) * 1000.0 /
+                            result.measurement_elapsed_ms;
+        result.us_per_sample = result.us_per_inference / static_cast<double>(result.samples_per_inference);
+        result.samples_per_second = result.throughput * static_cast<double>(result.samples_per_inference);
+        result.busy_fraction = ns_to_us(static_cast<double>(latency.sum_ns())) /
+                               (result.measurement_elapsed_ms * 1000.0 * static_cast<double>(bench_case.workers));
+    } else {
+        result.us_per_inference = -1.0;
+        result.throughput = -1.0;
+        result.us_per_sample = -1.0;
+        result.samples_per_second = -1.0;
+        result.busy_fraction = -1.0;
+    }
+    if (bench_case.cold_load && completed_runs) {
+        const double iterations = static_cast<double>(result.measurement_iterations);
+        result.startup.file_read_ms = cold_totals.file_read_ms / iterations;
+        result.startup.session_create_ms = cold_totals.session_create_ms / iterations;
+        result.startup.input_prep_ms = cold_totals.input_prep_ms / iterations;
+        result.startup.first_run_ms = cold_totals.first_run_ms / iterations;
+    }
+    if (result.power_collected && result.power.samples > 0) {
+        result.window_energy_j = result.power.mean_w * result.total_time_sec;
+        if (completed_runs) {
+            result.energy_per_inference_j = result.window_energy_j /
+                                            static_cast<double>(result.measurement_iterations);
+        }
+    }
+    if (allocation_counting_enabled() && completed_runs) {
+        const double iterations = static_cast<double>(result.measurement_iterations);
+        result.allocations_per_run =
+            static_cast<double>(allocations_end.allocations - allocations_start.allocations) / iterations;
+        result.allocated_bytes_per_run =
+            static_cast<double>(allocations_end.bytes - allocations_start.bytes) / iterations;
+    }
+
+    if (pool && !bench_case.workers_file.empty() && export_worker_latency_csv(bench_case.workers_file, result)) {
+        std::cout << "  ℹ Per-worker latency exported to: " << bench_case.workers_file << "\n";
+        std::cout << "RESULT_FILE=" << bench_case.workers_file << "\n";  // For script parsing
+    }
+    return true;
+}
+
+void print_benchmark_result(const BenchmarkResult &result, const PhaseDurations &durations) {
+    const LatencyHistogram &latency = *result.latency;
+
+    std::cout << "=== Benchmark Results ===\n";
+    std::cout << "Model: " << result.bench_case.model_filename << "\n";
+    std::cout << "Session: " << describe_session_config(result.bench_case.session) << "\n";
+    std::cout << "Inputs: " << result.input_shapes << "\n";
+    std::cout << "Measurement Duration: " << durations.measurement_seconds << "s\n";
+    std::cout << "Iterations: " << result.measurement_iterations << "\n";
+    std::cout << "Elapsed (ms): " << result.measurement_elapsed_ms << "\n";
+    if (result.bench_case.warmup_cv_threshold > 0.0) {
+        std::cout << "Warmup: " << result.warmup_iterations << " iterations in " << result.warmup_elapsed_ms << " ms, "
+                << (result.warmup_converged ? "converged" : "not converged") << " (CV "
+                << (result.warmup_cv < 0.0 ? 0.0 : result.warmup_cv * 100.0) << "%)\n";
+    }
+    std::cout << "Startup (ms" << (result.bench_case.cold_load ? ", mean per cold load" : "") << "): read "
+            << result.startup.file_read_ms << ", create " << result.startup.session_create_ms
+            << ", inputs " << result.startup.input_prep_ms << ", first run " << result.startup.first_run_ms
+            << " [" << result.model_source << (result.session_reused ? ", reused session" : "") << "]\n";
+    std::cout << "Microseconds per inference: " << std::fixed << std::setprecision(2)
+            << result.us_per_inference << " µs\n";
+    std::cout << "Throughput: " << std::fixed << std::setprecision(2)
+            << result.throughput << " inf/s\n";
+    if (result.samples_per_inference > 1) {
+        std::cout << "Per sample: " << result.us_per_sample << " µs, "
+                << result.samples_per_second << " samples/s (batch " << result.samples_per_inference << ")\n";
+    }
+    if (result.bench_case.target_rate_hz > 0.0) {
+        const LatencyHistogram &queue_delay = *result.queue_delay;
+        std::cout << "Pacing: target " << result.bench_case.target_rate_hz << " Hz, achieved " << result.throughput
+                << " Hz, missed deadlines " << result.missed_deadlines << ", busy "
+                << result.busy_fraction * 100.0 << "%\n";
+        std::cout << "Queue delay (µs): p50 " << ns_to_us(static_cast<double>(queue_delay.percentile_ns(50.0)))
+                << ", p99 " << ns_to_us(static_cast<double>(queue_delay.percentile_ns(99.0)))
+                << ", max " << ns_to_us(static_cast<double>(queue_delay.max_ns())) << "\n";
+    }
+    if (result.bench_case.prep_mode != PrepMode::None) {
+        std::cout << "Input prep (" << prep_mode_name(result.bench_case.prep_mode) << "): " << result.prep_mean_us
+                << " µs/inference";
+        if (result.prep_stall_mean_us >= 0.0) {
+            std::cout << ", run waited " << result.prep_stall_mean_us << " µs";
+        }
+        std::cout << "; end-to-end (µs): mean " << result.e2e_latency_mean_us << ", p50 " << result.e2e_latency_p50_us
+                << ", p99 " << result.e2e_latency_p99_us << "\n";
+    }
+    std::cout << "Latency (µs): p50 " << ns_to_us(static_cast<double>(latency.percentile_ns(50.0)))
+            << ", p90 " << ns_to_us(static_cast<double>(latency.percentile_ns(90.0)))
+            << ", p99 " << ns_to_us(static_cast<double>(latency.percentile_ns(99.0)))
+            << ", p99.9 " << ns_to_us(static_cast<double>(latency.percentile_ns(99.9)))
+            << ", max " << ns_to_us(static_cast<double>(latency.max_ns()))
+            << ", stddev " << ns_to_us(latency.stddev_ns()) << "\n";
+    if (result.ci_collected) {
+        const ConfidenceInterval &ci = result.ci;
+        std::cout << "95% CI of " << ci_metric_name(result.ci_metric)
+                << (result.ci_metric == CiMetric::Energy ? " (mJ/inference): " : " (µs): ");
+        if (ci.relative_half_width >= 0.0) {
+            std::cout << ci.mean << " [" << ci.low << ", " << ci.high << "], ±" << ci.relative_half_width * 100.0
+                    << "% over " << ci.batches << " batches, target ±" << result.bench_case.ci_target * 100.0 << "% "
+                    << (result.ci_reached ? "reached" : "not reached") << "\n";
+        } else {
+            std::cout << "not enough batches (" << ci.batches << ")\n";
+        }
+    }
+    if (!result.bench_case.interference.empty()) {
+        std::cout << "Interference: " << result.interference_load;
+        if (result.interference_p50_ratio >= 0.0) {
+            std::cout << "; vs. alone p50 ×" << result.interference_p50_ratio << ", p99 ×"
+                    << result.interference_p99_ratio;
+            if (result.interference_energy_ratio >= 0.0) {
+                std::cout << ", energy/inference ×" << result.interference_energy_ratio;
+            }
+        }
+        std::cout << "\n";
+    }
+    if (result.validation_collected) {
+        const OutputValidation &validation = result.validation;
+        std::cout << "Output validation (" << validation.reference << "): max abs error " << validation.max_abs_error
+                << ", mean abs error " << validation.mean_abs_error << ", min cosine " << validation.min_cosine
+                << " (" << validation.worst_output << "), " << (validation.passed ? "passed" : "FAILED") << "\n";
+    }
+    if (result.rss_after_setup_kb >= 0) {
+        std::cout << "Memory (MB): session +" << (result.rss_after_setup_kb - result.rss_before_setup_kb) / 1024.0
+                << ", RSS mean " << result.rss_measurement_mean_kb / 1024.0 << ", peak "
+                << result.rss_measurement_peak_kb / 1024.0 << ", HWM " << result.vm_hwm_kb / 1024.0 << "\n";
+    }
+    if (result.session_cache_used) {
+        const SessionCacheStats &cache = result.session_cache;
+        std::cout << "Session cache: " << cache.entries << " session(s), " << cache.resident_kb / 1024.0
+                << " MB; hits " << cache.hits << ", misses " << cache.misses << ", evictions " << cache.evictions
+                << ", load time saved " << cache.setup_saved_ms << " ms\n";
+    }
+    if (result.energy_per_inference_j >= 0.0) {
+        std::cout << "Power (" << (result.power.source == "rapl" ? "RAPL" : "fuel gauge") << "): mean "
+                << result.power.mean_w << " W, peak " << result.power.peak_w
+                << " W, " << result.energy_per_inference_j * 1000.0 << " mJ/inference (" << result.power.samples
+                << " samples)\n";
+    }
+    if (!result.rail_energy_j.empty()) {
+        std::cout << "  Rail energy (J): " << result.rail_energy_j << "\n";
+    }
+    if (result.perf_collected && result.perf.has_hardware_counts) {
+        const double iterations = static_cast<double>(result.measurement_iterations);
+        const ClusterCounts &total = result.perf.total;
+        std::cout << "Perf counters: IPC " << instructions_per_cycle(total) << ", per inference: "
+                << static_cast<double>(total.cycles) / iterations << " cycles, "
+                << static_cast<double>(total.instructions) / iterations << " instructions, "
+                << static_cast<double>(total.cache_misses) / iterations << " cache misses, "
+                << static_cast<double>(total.branch_misses) / iterations << " branch misses\n";
+        std::cout << "  Cycles by cluster: " << format_cluster_cycles(result.perf) << " (IPC "
+                << format_cluster_ipc(result.perf) << ")\n";
+    }
+    if (result.telemetry_collected) {
+        const TelemetrySummary &telemetry = result.telemetry;
+        std::cout << "Telemetry: CPU freq " << (telemetry.cluster_freq_mhz.empty() ? "n/a" : telemetry.cluster_freq_mhz)
+                << " MHz";
+        if (telemetry.temp_max_c >= 0.0) {
+            std::cout << ", hottest zone " << telemetry.temp_start_c << " → " << telemetry.temp_max_c << " °C";
+        }
+        if (telemetry.throttled_fraction >= 0.0) {
+            std::cout << ", capped " << 100.0 * telemetry.throttled_fraction << "% of samples";
+        }
+        std::cout << "\n";
+    }
+    if (result.allocations_per_run >= 0.0) {
+        std::cout << "Heap allocations per inference: " << result.allocations_per_run << " ("
+                << result.allocated_bytes_per_run << " bytes)\n";
+    }
+    for (size_t worker = 0; worker < result.worker_latency.size(); ++worker) {
+        const LatencyHistogram &worker_latency = *result.worker_latency[worker];
+        std::cout << "  Worker " << worker << ": " << worker_latency.count() << " inf, p50 "
+                << ns_to_us(static_cast<double>(worker_latency.percentile_ns(50.0))) << ", p99 "
+                << ns_to_us(static_cast<double>(worker_latency.percentile_ns(99.0))) << " µs\n";
+    }
+    std::cout << "=========================\n";
+}
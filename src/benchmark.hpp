@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "confidence_monitor.hpp"
+#include "device_telemetry.hpp"
+#include "inference_session.hpp"
+#include "input_pipeline.hpp"
+#include "interference.hpp"
+#include "latency_histogram.hpp"
+#include "model_inputs.hpp"
+#include "output_validation.hpp"
+#include "perf_counters.hpp"
+#include "power_sampler.hpp"
+#include "session_cache.hpp"
+#include "session_config.hpp"
+
+// Durations of the three benchmark phases
+struct PhaseDurations {
+    int warmup_seconds = 0;
+    int silence_seconds = 0;
+    int measurement_seconds = 0;
+};
+
+// One configuration to run through warmup, silence and measurement
+struct BenchmarkCase {
+    std::string model_filename;  // Relative to model_base_path(), as reported
+    std::string model_path;      // Full path on the device
+    std::string model_variant;   // Precision variant with --variants ("fp32", "fp16", ...); empty otherwise
+    SessionConfig session;
+    InputConfig inputs;
+    bool cold_load = false;
+
+    // Reset batterystats before the measurement window; off when the fuel gauge is enough
+    bool batterystats = true;
+
+    // Where to write batterystats after the measurement window; empty = leave it to the caller
+    std::string batterystats_file;
+
+    // Fuel-gauge sampling interval during measurement; 0 = off
+    int power_interval_ms = 0;
+
+    // Where to write the node → execution provider report; empty = skip it
+    std::string placement_file;
+
+    // Optimized-model cache: saved on the first load, loaded instead of the model after
+    // that (CPU provider only); empty = no cache
+    std::string optimized_model_path;
+
+    // Profile session creation to split it into model loading and session initialization
+    bool startup_profile = false;
+
+    // Concurrent worker threads driving Run(); 1 = run on the calling thread
+    int workers = 1;
+    bool per_worker_sessions = false;  // Each worker builds its own session instead of sharing one
+
+    // Where to write per-worker latency statistics (workers > 1); empty = skip it
+    std::string workers_file;
+
+    // Where to stream every measured iteration (binary, see IterationLog); empty = skip it
+    std::string iteration_log_file;
+
+    // Adaptive warmup: end it once the latency CV over the last warmup_window runs
+    // stays below this threshold (warmup_seconds is then the cap); 0 = fixed warmup
+    double warmup_cv_threshold = 0.0;
+    int warmup_window = 0;
+
+    // Confidence-interval termination: end the measurement once the 95% CI of
+    // ci_metric is within ±ci_target of its mean, after ci_min_seconds at least
+    // (measurement_seconds is then the cap); 0 = fixed measurement
+    double ci_target = 0.0;
+    CiMetric ci_metric = CiMetric::Latency;
+    int ci_min_seconds = 0;
+
+    // Open-loop request rate in Hz (warmup and measurement); 0 = as fast as possible
+    double target_rate_hz = 0.0;
+
+    // Input preparation before every run (see InputPipeline), prep_passes times
+    // per input; None = inputs prepared once at setup
+    PrepMode prep_mode = PrepMode::None;
+    int prep_passes = 1;
+
+    // Count cycles, instructions, cache/branch misses, ... during measurement
+    bool perf_counters = false;
+
+    // Sample CPU frequencies and temperatures every N ms from setup to the end of
+    // measurement; 0 = off
+    int telemetry_interval_ms = 0;
+    std::string telemetry_file;  // Where to write the time series
+
+    // Inferences to profile per operator after the measurement window; 0 = skip
+    int profile_runs = 0;
+    std::string profile_file;  // Where to write the per-operator summary
+
+    // Background load from the start of warmup to the end of measurement; empty = none.
+    // A loaded window names the window that ran its configuration alone (-1 = none),
+    // and interference_baseline marks that window.
+    std::vector<InterferenceSource> interference;
+    bool interference_baseline = false;
+    int interference_baseline_window = -1;
+
+    // Compare the outputs with a reference after the measurement window
+    bool validate = false;
+    ValidationSettings validation;
+
+    // Warm sessions shared with other windows (--serve, --session-cache); null = build a new one
+    SessionCache *session_cache = nullptr;
+};
+
+// Metrics collected for one benchmark case
+struct BenchmarkResult {
+    BenchmarkCase bench_case;
+    size_t config_index = 0;
+
+    double setup_ms = 0.0;
+
+    // Startup breakdown of the setup session; in cold-load mode the mean over
+    // the measured iterations
+    StartupTimings startup;
+    double model_load_ms = -1.0;    // From the profiler with startup_profile; -1 = not profiled
+    double session_init_ms = -1.0;
+    std::string model_source = "original";  // "original" or "optimized_cache"
+    std::string model_hash;  // Of the model file (model_file_hash); empty if unreadable
+    bool optimized_model_saved = false;
+    bool session_reused = false;  // Taken from the session cache; setup then built nothing
+    double setup_saved_ms = 0.0;  // Build time of the reused session
+    bool session_cache_used = false;
+    SessionCacheStats session_cache;  // Snapshot after setup
+    uint64_t warmup_iterations = 0;
+    double warmup_elapsed_ms = 0.0;
+    bool warmup_converged = false;          // Adaptive warmup ended before its cap
+    uint64_t warmup_converged_iterations = 0;  // Runs it took to converge
+    double warmup_cv = -1.0;                // Latency CV of the last window; -1 = fixed warmup
+
+    // Confidence interval of the measurement (ci_target > 0)
+    bool ci_collected = false;
+    CiMetric ci_metric = CiMetric::Latency;  // Latency unless energy was requested and sampled
+    ConfidenceInterval ci;
+    bool ci_reached = false;                 // The window ended on the target, not on the cap
+    uint64_t measurement_iterations = 0;
+    double measurement_elapsed_ms = 0.0;
+    double us_per_inference = 0.0;
+    double total_time_sec = 0.0;
+    double throughput = 0.0;
+
+    // Resolved input shapes and batch size; per-sample metrics divide by it
+    std::string input_shapes;
+    size_t samples_per_inference = 1;
+    size_t dataset_samples = 1;  // Distinct input samples the runs cycle through
+    double us_per_sample = 0.0;
+    double samples_per_second = 0.0;
+
+    // Wall-clock times (ms since the Unix epoch) for aligning with batterystats history
+    int64_t stats_reset_epoch_ms = 0;
+    int64_t measurement_start_epoch_ms = 0;
+    int64_t measurement_end_epoch_ms = 0;
+
+    // "<provider>:<node count>;..." from the placement report (empty if not collected)
+    std::string provider_node_counts;
+
+    // "<op type>:<share of kernel time %>;..." from the op profile (empty if not collected)
+    std::string top_op_types;
+
+    // Background work done during the measurement window (see BackgroundLoad::achieved_load),
+    // and the loaded window against its baseline window: p50, p99 and energy per
+    // inference as loaded / alone (-1 = no baseline or no fuel-gauge energy)
+    std::string interference_load;
+    double interference_p50_ratio = -1.0;
+    double interference_p99_ratio = -1.0;
+    double interference_energy_ratio = -1.0;
+
+    // Output error against the reference (validate only)
+    bool validation_collected = false;
+    OutputValidation validation;
+
+    // Per-inference latency during measurement (all workers)
+    std::unique_ptr<LatencyHistogram> latency = std::make_unique<LatencyHistogram>();
+
+    // Per-worker latency during measurement (workers > 1 only)
+    std::vector<std::unique_ptr<LatencyHistogram> > worker_latency;
+
+    // Iterations written to / dropped from the iteration log (iteration_log_file only)
+    uint64_t iteration_log_records = 0;
+    uint64_t iteration_log_dropped = 0;
+
+    // Paced mode: time from a request being due to its run starting, and requests
+    // that finished after the next one was due
+    std::unique_ptr<LatencyHistogram> queue_delay = std::make_unique<LatencyHistogram>();
+    uint64_t missed_deadlines = 0;
+
+    // Share of the window spent inside Run(), per worker (about 1 when closed loop)
+    double busy_fraction = 0.0;
+
+    // With input preparation (µs, -1 = not collected): latency from the start of
+    // each inference's preparation to the end of its run, mean preparation time,
+    // and the mean wait for prepared inputs (pipelined only). latency then holds
+    // the time per iteration, i.e. 1 / throughput.
+    double e2e_latency_mean_us = -1.0;
+    double e2e_latency_p50_us = -1.0;
+    double e2e_latency_p99_us = -1.0;
+    double prep_mean_us = -1.0;
+    double prep_stall_mean_us = -1.0;
+
+    // Process memory in kB (-1 = unavailable): VmRSS at phase boundaries, VmRSS
+    // sampled during measurement, and VmHWM at the end of the window (reset before
+    // setup where the kernel supports it, otherwise the process lifetime peak)
+    int64_t rss_before_setup_kb = -1;
+    int64_t rss_after_setup_kb = -1;
+    int64_t rss_after_warmup_kb = -1;
+    double rss_measurement_mean_kb = -1.0;
+    int64_t rss_measurement_peak_kb = -1;
+    int64_t vm_hwm_kb = -1;
+
+    // perf_event_open counts over the measurement window (perf_counters only)
+    bool perf_collected = false;
+    PerfCounterResults perf;
+
+    // Battery power sampled in-process over the measurement window (power_interval_ms > 0
+    // and a readable fuel gauge), and energy from it (-1 = not sampled)
+    bool power_collected = false;
+    PowerSummary power;
+    double window_energy_j = -1.0;
+    double energy_per_inference_j = -1.0;
+
+    // "<rail>:<joules>;..." from the on-device power monitor (empty where there is none)
+    std::string rail_energy_j;
+
+    // CPU frequency, throttling and temperature over the measurement window
+    // (telemetry_interval_ms > 0 only)
+    bool telemetry_collected = false;
+    TelemetrySummary telemetry;
+
+    // Heap allocations per inference during measurement; -1 unless built with
+    // allocation counting (see allocation_counter.hpp)
+    double allocations_per_run = -1.0;
+    double allocated_bytes_per_run = -1.0;
+};
+
+// Build the session, then run warmup → silence → batterystats reset → measurement.
+// Returns false (after printing the error) if ONNX Runtime fails.
+bool run_benchmark_case(const BenchmarkCase &bench_case, const PhaseDurations &durations,
+                        BenchmarkResult &result);
+
+// Print the results summary to stdout
+void print_benchmark_result(const BenchmarkResult &result, const PhaseDurations &durations);
+
+// Convert nanoseconds to microseconds for reporting
+inline double ns_to_us(double ns) {
+    return ns / 1000.0;
+}
@@ -0,0 +1,431 @@
+#include "benchmark_job.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include "config.hpp"
+#include "device_identity.hpp"
+#include "model_list.hpp"
+#include "results_csv.hpp"
+#include "results_sink.hpp"
+#include "runner_paths.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Replace every configuration by one copy per swept value (no-op for an empty sweep)
+    template<typename T, typename Apply>
+    void expand_sweep(std::vector<SessionConfig> &configs, const std::vector<T> &values, Apply apply) {
+        if (values.empty()) {
+            return;
+        }
+        std::vector<SessionConfig> expanded;
+        expanded.reserve(configs.size() * values.size());
+        for (const SessionConfig &config: configs) {
+            for (const T &value: values) {
+                SessionConfig variant = config;
+                apply(variant, value);
+                expanded.push_back(variant);
+            }
+        }
+        configs.swap(expanded);
+    }
+
+    // What a loaded window is compared with: its configuration alone
+    struct BaselineSummary {
+        bool completed = false;
+        uint64_t p50_ns = 0;
+        uint64_t p99_ns = 0;
+        double energy_per_inference_j = -1.0;
+    };
+
+    void compare_with_baseline(const BaselineSummary &baseline, BenchmarkResult &result) {
+        const LatencyHistogram &latency = *result.latency;
+        if (baseline.p50_ns > 0) {
+            result.interference_p50_ratio = static_cast<double>(latency.percentile_ns(50.0)) /
+                                            static_cast<double>(baseline.p50_ns);
+        }
+        if (baseline.p99_ns > 0) {
+            result.interference_p99_ratio = static_cast<double>(latency.percentile_ns(99.0)) /
+                                            static_cast<double>(baseline.p99_ns);
+        }
+        if (baseline.energy_per_inference_j > 0.0 && result.energy_per_inference_j >= 0.0) {
+            result.interference_energy_ratio = result.energy_per_inference_j / baseline.energy_per_inference_j;
+        }
+    }
+}
+
+std::vector<BenchmarkCase> build_benchmark_plan(const BenchmarkOptions &options,
+                                                const std::vector<std::string> &models) {
+    // Session option matrix, outermost sweep first
+    std::vector<SessionConfig> session_configs{options.session};
+    expand_sweep(session_configs, options.sweep_execution_providers, [](SessionConfig &config, ExecutionProvider value) {
+        config.execution_provider = value;
+    });
+    expand_sweep(session_configs, options.sweep_graph_optimization_levels,
+                 [](SessionConfig &config, GraphOptimizationLevel value) {
+                     config.graph_optimization_level = value;
+                 });
+    expand_sweep(session_configs, options.sweep_execution_modes, [](SessionConfig &config, ExecutionMode value) {
+        config.execution_mode = value;
+    });
+    expand_sweep(session_configs, options.sweep_mem_pattern, [](SessionConfig &config, bool value) {
+        config.mem_pattern = value;
+    });
+    expand_sweep(session_configs, options.sweep_cpu_arena, [](SessionConfig &config, bool value) {
+        config.cpu_arena = value;
+    });
+    expand_sweep(session_configs, options.sweep_cpu_masks, [](SessionConfig &config, uint64_t value) {
+        config.cpu_mask = value;
+    });
+    expand_sweep(session_configs, options.sweep_intra_op_threads, [](SessionConfig &config, int value) {
+        config.intra_op_threads = value;
+    });
+
+    // Input files are relative to the models directory unless absolute
+    InputConfig base_inputs = options.inputs;
+    for (auto &entry: base_inputs.input_files) {
+        entry.second = (fs::path(model_base_path()) / entry.second).string();
+    }
+
+    // Each swept shape is applied on top of the --shape overrides
+    std::vector<InputConfig> input_configs;
+    for (const auto &shape: options.sweep_shapes) {
+        InputConfig input_config = base_inputs;
+        for (const auto &dim: shape) {
+            input_config.dim_overrides[dim.first] = dim.second;
+        }
+        input_configs.push_back(input_config);
+    }
+    if (input_configs.empty()) {
+        input_configs.push_back(base_inputs);
+    }
+
+    std::vector<int> worker_counts = options.sweep_workers;
+    if (worker_counts.empty()) {
+        worker_counts.push_back(options.workers);
+    }
+
+    std::vector<double> target_rates = options.sweep_target_rates;
+    if (target_rates.empty()) {
+        target_rates.push_back(options.target_rate_hz);
+    }
+
+    std::vector<PrepMode> prep_modes = options.sweep_prep_modes;
+    if (prep_modes.empty()) {
+        prep_modes.push_back(options.prep_mode);
+    }
+
+    // Co-run models are relative to the models directory, like the benchmarked ones
+    std::vector<InterferenceSource> interference = options.interference;
+    for (auto &source: interference) {
+        if (source.kind == InterferenceSource::Kind::Model) {
+            source.model_path = (fs::path(model_base_path()) / source.model).string();
+        }
+    }
+
+    std::vector<BenchmarkCase> plan;
+    for (const std::string &model: models) {
+        for (const InputConfig &input_config: input_configs) {
+            for (const SessionConfig &session_config: session_configs) {
+                for (const int workers: worker_counts) {
+                    for (const double target_rate_hz: target_rates) {
+                        BenchmarkCase bench_case;
+                        bench_case.model_filename = model;
+                        bench_case.model_path = (fs::path(model_base_path()) / model).string();
+                        if (options.variants) {
+                            bench_case.model_variant = model_variant_name(model);
+                        }
+                        bench_case.session = session_config;
+                        bench_case.inputs = input_config;
+                        bench_case.cold_load = options.cold_load;
+                        bench_case.startup_profile = options.startup_profile;
+                        bench_case.workers = workers;
+                        bench_case.per_worker_sessions = options.per_worker_sessions;
+                        bench_case.target_rate_hz = target_rate_hz;
+                        bench_case.profile_runs = options.profile_runs;
+                        bench_case.validate = options.validate;
+                        if (options.validate) {
+                            ValidationSettings &validation = bench_case.validation;
+                            // Variants are compared with their original, unless a reference is given
+                            std::string reference = options.reference_model;
+                            if (reference.empty() && options.variants) {
+                                reference = variant_original(model);
+                            }
+                            validation.reference_name = reference == model ? "" : reference;
+                            if (reference.empty()) {
+                                reference = model;
+                            }
+                            validation.reference_model_path = (fs::path(model_base_path()) / reference).string();
+                            validation.reference_dir = options.reference_dir;
+                            // Outputs depend on the contents of both models and on everything the
+                            // inputs are made from; a change of any of them names other files
+                            const std::string reference_key =
+                                model_file_hash(bench_case.model_path) + "|" +
+                                model_file_hash(validation.reference_model_path) + "|" +
+                                describe_input_config(input_config);
+                            validation.file_prefix = sanitize_filename(model + "_" + reference) + "_" +
+                                                     text_hash(reference_key);
+                            validation.samples = Config::VALIDATION_SAMPLES;
+                            validation.max_abs_error = options.validation_max_abs_error;
+                            validation.min_cosine = options.validation_min_cosine;
+                        }
+                        bench_case.warmup_cv_threshold = options.warmup_cv_threshold;
+                        bench_case.warmup_window = options.warmup_window;
+                        bench_case.ci_target = options.ci_target;
+                        bench_case.ci_metric = options.ci_metric;
+                        bench_case.ci_min_seconds = options.ci_min_seconds;
+                        bench_case.perf_counters = options.perf_counters;
+                        bench_case.power_interval_ms = options.power_interval_ms;
+                        bench_case.batterystats = options.batterystats;
+                        bench_case.telemetry_interval_ms = options.telemetry_interval_ms;
+                        if (options.optimized_cache) {
+                            // The saved graph depends on the optimization level it was built with
+                            bench_case.optimized_model_path = (fs::path(optimized_model_dir()) / (
+                                sanitize_filename(model) + "." +
+                                graph_optimization_level_name(session_config.graph_optimization_level) +
+                                ".ort")).string();
+                        }
+                        bench_case.prep_passes = options.prep_passes;
+                        for (const PrepMode prep_mode: prep_modes) {
+                            BenchmarkCase prep_case = bench_case;
+                            prep_case.prep_mode = prep_mode;
+                            // Under load, each configuration first runs alone for comparison
+                            if (!interference.empty()) {
+                                if (options.interference_baseline) {
+                                    BenchmarkCase baseline = prep_case;
+                                    baseline.interference_baseline = true;
+                                    plan.push_back(baseline);
+                                    prep_case.interference_baseline_window = static_cast<int>(plan.size() - 1);
+                                }
+                                prep_case.interference = interference;
+                            }
+                            plan.push_back(prep_case);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return plan;
+}
+
+bool prepare_benchmark_job(const BenchmarkOptions &options, bool dump_every_window, BenchmarkJob &job,
+                           std::string &error) {
+    job.options = options;
+    job.durations.warmup_seconds = options.warmup_seconds;
+    job.durations.silence_seconds = options.silence_seconds;
+    job.durations.measurement_seconds = options.measurement_seconds;
+
+    // Resolve the model argument (file, directory or manifest) under model_base_path()
+    if (!resolve_model_list(model_base_path(), options.model_filename, job.models, job.is_batch, error)) {
+        return false;
+    }
+    if (options.variants) {
+        expand_model_variants(model_base_path(), job.models);
+        job.is_batch = job.is_batch || job.models.size() > 1;
+    }
+
+    // Batch results are consolidated into one file named after the directory or manifest
+    const std::string run_name = job.is_batch ? batch_run_name(options.model_filename) : options.model_filename;
+
+    // Capture timestamp at the start
+    job.timestamp = get_current_timestamp();
+    const std::string &timestamp = job.timestamp;
+    job.performance_file = measurement_file_path(run_name, timestamp, "_performance.csv");
+
+    job.plan = build_benchmark_plan(options, job.models);
+    std::vector<BenchmarkCase> &plan = job.plan;
+
+    // A single configuration leaves the batterystats dump to measure_model.sh. Sweeps,
+    // batches and server jobs reset the stats once per window, so each window is
+    // dumped right after it.
+    const bool per_window_stats = dump_every_window || job.is_batch || plan.size() > 1;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        const std::string config_suffix = per_window_stats ? "_cfg" + std::to_string(i) : "";
+        if (per_window_stats && options.batterystats) {
+            plan[i].batterystats_file = measurement_file_path(
+                plan[i].model_filename, timestamp, config_suffix + "_batterystats.txt");
+        }
+        // Placement matters when an EP can take nodes away from the CPU provider
+        if (options.placement_report || plan[i].session.execution_provider != ExecutionProvider::Cpu) {
+            plan[i].placement_file = measurement_file_path(
+                plan[i].model_filename, timestamp, config_suffix + "_placement.csv");
+        }
+        if (plan[i].profile_runs > 0) {
+            plan[i].profile_file = measurement_file_path(
+                plan[i].model_filename, timestamp, config_suffix + "_ops.csv");
+        }
+        if (plan[i].telemetry_interval_ms > 0) {
+            plan[i].telemetry_file = measurement_file_path(
+                plan[i].model_filename, timestamp, config_suffix + "_telemetry.csv");
+        }
+        if (plan[i].workers > 1) {
+            plan[i].workers_file = measurement_file_path(
+                plan[i].model_filename, timestamp, config_suffix + "_workers.csv");
+        }
+        if (options.iteration_log) {
+            plan[i].iteration_log_file = measurement_file_path(
+                plan[i].model_filename, timestamp, config_suffix + "_iterations.bin");
+        }
+    }
+    return true;
+}
+
+void print_benchmark_job(const BenchmarkJob &job) {
+    const BenchmarkOptions &options = job.options;
+    const PhaseDurations &durations = job.durations;
+    const std::vector<BenchmarkCase> &plan = job.plan;
+    const std::string &timestamp = job.timestamp;
+
+    std::cout << "=== Starting 3-Phase Benchmark ===\n";
+    if (job.is_batch) {
+        std::cout << "Batch: " << options.model_filename << " (" << job.models.size() << " models)\n";
+    } else {
+        std::cout << "Model: " << options.model_filename << "\n";
+    }
+    std::cout << "Timestamp: " << timestamp << "\n";
+    std::cout << "BENCHMARK_TIMESTAMP=" << timestamp << "\n";  // For script parsing
+    std::cout << "Load mode: " << (options.cold_load ? "cold" : "warm") << "\n";
+    const DeviceIdentity &identity = device_identity();
+    std::cout << "Device: " << (identity.device_model.empty() ? "unknown" : identity.device_model)
+            << (identity.soc.empty() ? "" : " (" + identity.soc + ")") << ", ONNX Runtime " << identity.ort_version
+            << "\n";
+    if (!options.batterystats) {
+        std::cout << "BATTERYSTATS_DISABLED=1\n";  // For script parsing: energy comes from the fuel gauge only
+    }
+    if (plan.size() == 1) {
+        std::cout << "Session: " << describe_session_config(plan.front().session) << "\n";
+        if (plan.front().workers > 1) {
+            std::cout << "Workers: " << plan.front().workers << " ("
+                    << (plan.front().per_worker_sessions ? "per-worker sessions" : "shared session") << ")\n";
+        }
+        if (plan.front().target_rate_hz > 0.0) {
+            std::cout << "Target rate: " << plan.front().target_rate_hz << " Hz (open loop)\n";
+        }
+        if (!plan.front().inputs.dim_overrides.empty()) {
+            std::cout << "Shape: " << format_dim_overrides(plan.front().inputs.dim_overrides) << "\n";
+        }
+    } else {
+        std::cout << "Windows: " << plan.size() << " (model × configuration)\n";
+    }
+    if (options.warmup_cv_threshold > 0.0) {
+        std::cout << "Phase 1 (Warmup): adaptive, CV < " << options.warmup_cv_threshold * 100.0 << "% over "
+                << options.warmup_window << " runs, at most " << durations.warmup_seconds << "s\n";
+    } else {
+        std::cout << "Phase 1 (Warmup): " << durations.warmup_seconds << "s\n";
+    }
+    std::cout << "Phase 2 (Silence): " << durations.silence_seconds << "s\n";
+    if (options.ci_target > 0.0) {
+        std::cout << "Phase 3 (Measurement): until the 95% CI of " << ci_metric_name(options.ci_metric)
+                << " is within ±" << options.ci_target * 100.0 << "%, " << options.ci_min_seconds << "-"
+                << durations.measurement_seconds << "s\n";
+    } else {
+        std::cout << "Phase 3 (Measurement): " << durations.measurement_seconds << "s\n";
+    }
+    std::cout << "===================================\n\n";
+}
+
+bool run_benchmark_job(const BenchmarkJob &job, const std::function<void(const BenchmarkResult &)> &on_window) {
+    const std::vector<BenchmarkCase> &plan = job.plan;
+
+    // Create measurements directory if it doesn't exist
+    std::error_code mkdir_error;
+    fs::create_directories(measurements_dir(), mkdir_error);
+    if (mkdir_error) {
+        std::cerr << "Error: Cannot create " << measurements_dir() << ": " << mkdir_error.message() << "\n";
+        return false;
+    }
+
+    // Each window's row is appended as soon as it finishes, so a crash or a
+    // killed batch keeps every completed window
+    const std::string &performance_file = job.performance_file;
+    AsyncFileWriter performance_sink;
+    size_t completed_cases = 0;
+    size_t failed_cases = 0;
+    std::vector<BaselineSummary> baselines(plan.size());
+
+    for (size_t i = 0; i < plan.size(); ++i) {
+        if (plan.size() > 1) {
+            std::cout << "### Window " << (i + 1) << "/" << plan.size() << ": "
+                    << plan[i].model_filename << " | " << describe_session_config(plan[i].session);
+            if (plan[i].prep_mode != PrepMode::None) {
+                std::cout << " | prep: " << prep_mode_name(plan[i].prep_mode);
+            }
+            if (plan[i].interference_baseline) {
+                std::cout << " | alone";
+            } else if (!plan[i].interference.empty()) {
+                std::cout << " | under load: " << format_interference(plan[i].interference);
+            }
+            std::cout << "\n\n";
+        }
+
+        BenchmarkResult result;
+        result.config_index = i;
+        if (!run_benchmark_case(plan[i], job.durations, result)) {
+            // A single broken model must not abort a whole batch
+            if (plan.size() == 1) {
+                return false;
+            }
+            std::cerr << "  ✗ Skipping " << plan[i].model_filename << " after error\n\n";
+            ++failed_cases;
+            continue;
+        }
+
+        if (plan[i].interference_baseline) {
+            BaselineSummary &baseline = baselines[i];
+            baseline.completed = true;
+            baseline.p50_ns = result.latency->percentile_ns(50.0);
+            baseline.p99_ns = result.latency->percentile_ns(99.0);
+            baseline.energy_per_inference_j = result.energy_per_inference_j;
+        } else if (plan[i].interference_baseline_window >= 0 &&
+                   baselines[static_cast<size_t>(plan[i].interference_baseline_window)].completed) {
+            compare_with_baseline(baselines[static_cast<size_t>(plan[i].interference_baseline_window)], result);
+        }
+
+        // Output final results
+        print_benchmark_result(result, job.durations);
+        std::cout << "\n";
+        ++completed_cases;
+
+        if (!performance_sink.is_open()) {
+            std::string sink_error;
+            if (performance_sink.open(performance_file, sink_error)) {
+                std::ostringstream header;
+                write_performance_csv_header(header);
+                performance_sink.append(header.str());
+            } else {
+                std::cerr << "Warning: Could not create performance metrics file: " << performance_file << ": "
+                        << sink_error << "\n";
+            }
+        }
+        if (performance_sink.is_open()) {
+            std::ostringstream row;
+            write_performance_csv_row(row, job.timestamp, result);
+            performance_sink.append(row.str());
+        }
+        if (on_window) {
+            on_window(result);
+        }
+    }
+
+    if (completed_cases == 0) {
+        std::cerr << "Error: All benchmark windows failed\n";
+        return false;
+    }
+    if (failed_cases > 0) {
+        std::cerr << "⚠ Warning: " << failed_cases << " of " << plan.size() << " windows failed\n";
+    }
+
+    if (performance_sink.is_open()) {
+        if (performance_sink.close()) {
+            std::cout << "  ℹ Performance metrics exported to: " << performance_file << "\n";
+            std::cout << "PERFORMANCE_FILE=" << performance_file << "\n";  // For script parsing
+        } else {
+            std::cerr << "Warning: Error writing performance metrics file: " << performance_file << "\n";
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "benchmark.hpp"
+#include "options.hpp"
+
+// One invocation of the runner: the resolved models and every window to run
+struct BenchmarkJob {
+    BenchmarkOptions options;
+    PhaseDurations durations;
+    std::vector<std::string> models;  // Relative to model_base_path()
+    bool is_batch = false;            // The model argument named a directory or manifest
+    std::string timestamp;
+    std::string performance_file;     // Where the performance CSV is streamed to
+    std::vector<BenchmarkCase> plan;
+};
+
+// Expand the options into the list of configurations to benchmark, model by model
+std::vector<BenchmarkCase> build_benchmark_plan(const BenchmarkOptions &options,
+                                                const std::vector<std::string> &models);
+
+// Resolve the models and build the plan with its per-window output files.
+// dump_every_window makes even a single window dump its own batterystats
+// (for callers without measure_model.sh around them). On failure returns
+// false and sets error.
+bool prepare_benchmark_job(const BenchmarkOptions &options, bool dump_every_window, BenchmarkJob &job,
+                           std::string &error);
+
+// Print the run header (model, timestamp, phases, ...) to stdout
+void print_benchmark_job(const BenchmarkJob &job);
+
+// Run every window in order, appending each finished one to the performance CSV
+// and passing it to on_window (if set). Returns false if the only window or
+// every window failed.
+bool run_benchmark_job(const BenchmarkJob &job, const std::function<void(const BenchmarkResult &)> &on_window);
@@ -0,0 +1,121 @@
+#include "confidence_monitor.hpp"
+
+#include <cmath>
+#include "config.hpp"
+
+namespace {
+    // Two-sided 95% quantiles of Student's t for 1..30 degrees of freedom
+    constexpr double T_975[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+
+    double t_quantile_975(size_t degrees_of_freedom) {
+        constexpr size_t table_size = sizeof(T_975) / sizeof(T_975[0]);
+        if (degrees_of_freedom <= table_size) {
+            return T_975[degrees_of_freedom - 1];
+        }
+        // Cornish-Fisher expansion around the normal quantile; within 0.001 above 30
+        const double z = 1.959964;
+        const double df = static_cast<double>(degrees_of_freedom);
+        return z + (z * z * z + z) / (4.0 * df) + (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z) / (96.0 * df * df);
+    }
+}
+
+const char *ci_metric_name(CiMetric metric) {
+    switch (metric) {
+        case CiMetric::Latency:
+            return "latency";
+        case CiMetric::Energy:
+            return "energy";
+    }
+    return "unknown";
+}
+
+bool parse_ci_metric(const std::string &text, CiMetric &metric) {
+    if (text == "latency") {
+        metric = CiMetric::Latency;
+    } else if (text == "energy") {
+        metric = CiMetric::Energy;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+ConfidenceMonitor::ConfidenceMonitor(CiMetric metric, double target, std::chrono::nanoseconds batch_length,
+                                     std::chrono::nanoseconds min_duration, std::chrono::nanoseconds max_duration,
+                                     const RunProgress &progress,
+                                     const PowerSampler *power, clock::time_point start)
+    : metric_(metric),
+      target_(target),
+      batch_length_(std::chrono::duration_cast<clock::duration>(batch_length)),
+      earliest_end_(start + std::chrono::duration_cast<clock::duration>(min_duration)),
+      progress_(progress),
+      power_(power),
+      batch_end_(start + batch_length_),
+      batch_start_runs_(progress.runs()),
+      batch_start_run_ns_(progress.run_ns()),
+      batch_start_energy_j_(power != nullptr ? power->energy_j() : 0.0) {
+    // No reallocation inside the measurement window
+    batch_means_.reserve(static_cast<size_t>(max_duration / batch_length) + 1);
+}
+
+bool ConfidenceMonitor::update(clock::time_point now) {
+    if (now < batch_end_ || reached_) {
+        return reached_;
+    }
+
+    const uint64_t runs = progress_.runs();
+    const uint64_t run_ns = progress_.run_ns();
+    const double energy_j = power_ != nullptr ? power_->energy_j() : 0.0;
+    // A batch without a finished run (a run longer than the batch) is merged into the next
+    if (runs > batch_start_runs_) {
+        batch_means_.push_back(batch_value(runs, run_ns, energy_j));
+        batch_start_runs_ = runs;
+        batch_start_run_ns_ = run_ns;
+        batch_start_energy_j_ = energy_j;
+    }
+    while (batch_end_ <= now) {
+        batch_end_ += batch_length_;
+    }
+
+    if (now >= earliest_end_ && batch_means_.size() >= Config::CI_MIN_BATCHES) {
+        const ConfidenceInterval current = interval();
+        reached_ = current.relative_half_width >= 0.0 && current.relative_half_width <= target_;
+    }
+    return reached_;
+}
+
+double ConfidenceMonitor::batch_value(uint64_t runs, uint64_t run_ns, double energy_j) const {
+    const double batch_runs = static_cast<double>(runs - batch_start_runs_);
+    if (metric_ == CiMetric::Energy) {
+        return (energy_j - batch_start_energy_j_) * 1000.0 / batch_runs;
+    }
+    return static_cast<double>(run_ns - batch_start_run_ns_) / 1000.0 / batch_runs;
+}
+
+ConfidenceInterval ConfidenceMonitor::interval() const {
+    ConfidenceInterval result;
+    result.batches = batch_means_.size();
+    if (batch_means_.size() < 2) {
+        return result;
+    }
+    const double count = static_cast<double>(batch_means_.size());
+    double sum = 0.0;
+    for (const double value: batch_means_) {
+        sum += value;
+    }
+    const double mean = sum / count;
+    double squares = 0.0;
+    for (const double value: batch_means_) {
+        squares += (value - mean) * (value - mean);
+    }
+    const double half_width = t_quantile_975(batch_means_.size() - 1) * std::sqrt(squares / (count - 1.0) / count);
+    result.mean = mean;
+    result.low = mean - half_width;
+    result.high = mean + half_width;
+    result.relative_half_width = mean > 0.0 ? half_width / mean : -1.0;
+    return result;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "device_telemetry.hpp"
+#include "power_sampler.hpp"
+
+// Quantity whose confidence interval ends the measurement (--ci-metric)
+enum class CiMetric {
+    Latency,  // Mean latency per inference, µs
+    Energy,   // Fuel-gauge energy per inference, mJ
+};
+
+const char *ci_metric_name(CiMetric metric);
+bool parse_ci_metric(const std::string &text, CiMetric &metric);
+
+// 95% confidence interval of a per-inference mean (-1 = not computed)
+struct ConfidenceInterval {
+    double mean = -1.0;
+    double low = -1.0;
+    double high = -1.0;
+    double relative_half_width = -1.0;  // (high - low) / 2 / mean
+    size_t batches = 0;
+};
+
+// Statistically driven end of the measurement window (--ci-target). Successive
+// runs are correlated (DVFS, thermal state, cache contents), so the interval is
+// built from batch means: the window is cut into fixed-length batches, each
+// batch contributes one mean per inference (from RunProgress, and for energy
+// from the fuel gauge's running integral), and Student's t over the batch means
+// gives the 95% interval. The window may end once the interval's half-width is
+// within the target fraction of the mean, no earlier than min_duration.
+//
+// update() is called by the driver thread only: between its own runs, or from
+// the pool's producer loop. It reads two atomics and a clock value except at a
+// batch boundary, so calling it every run does not disturb the measurement.
+class ConfidenceMonitor {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // power must be running (start()ed) for CiMetric::Energy; max_duration is
+    // the window's upper bound, used to size the batch storage up front
+    ConfidenceMonitor(CiMetric metric, double target, std::chrono::nanoseconds batch_length,
+                      std::chrono::nanoseconds min_duration, std::chrono::nanoseconds max_duration,
+                      const RunProgress &progress,
+                      const PowerSampler *power, clock::time_point start);
+
+    // Close the batch if it has ended; true once the target is reached
+    bool update(clock::time_point now);
+
+    bool reached() const { return reached_; }
+
+    // Over the batches closed so far
+    ConfidenceInterval interval() const;
+
+private:
+    double batch_value(uint64_t runs, uint64_t run_ns, double energy_j) const;
+
+    CiMetric metric_;
+    double target_;
+    clock::duration batch_length_;
+    clock::time_point earliest_end_;
+    const RunProgress &progress_;
+    const PowerSampler *power_;
+
+    clock::time_point batch_end_;
+    uint64_t batch_start_runs_;
+    uint64_t batch_start_run_ns_;
+    double batch_start_energy_j_;
+    std::vector<double> batch_means_;
+    bool reached_ = false;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "onnxruntime_c_api.h"
+
+// Configuration constants
+namespace Config {
+    // Default paths: where the scripts push to on Android, relative to the working
+    // directory on a Linux host. The environment variables override them (see runner_paths.hpp).
+#ifdef __ANDROID__
+    constexpr const char *MODEL_BASE_PATH = "/data/local/tmp/models";
+    constexpr const char *MEASUREMENTS_DIR = "/data/local/tmp/measurements";
+    constexpr const char *OPTIMIZED_MODEL_DIR = "/data/local/tmp/optimized_models";
+#else
+    constexpr const char *MODEL_BASE_PATH = "models";
+    constexpr const char *MEASUREMENTS_DIR = "measurements";
+    constexpr const char *OPTIMIZED_MODEL_DIR = "optimized_models";
+#endif
+    constexpr const char *MODEL_BASE_PATH_ENV = "ONNX_RUNNER_MODEL_DIR";
+    constexpr const char *MEASUREMENTS_DIR_ENV = "ONNX_RUNNER_MEASUREMENTS_DIR";
+    constexpr const char *OPTIMIZED_MODEL_DIR_ENV = "ONNX_RUNNER_OPTIMIZED_MODEL_DIR";
+
+    // ONNX Runtime settings
+    constexpr int INTRA_OP_NUM_THREADS = 1;
+    constexpr int INTER_OP_NUM_THREADS = 1;
+    constexpr OrtLoggingLevel LOGGING_LEVEL = ORT_LOGGING_LEVEL_WARNING;
+    constexpr const char *ENV_NAME = "ONNXInference";
+
+    // Random data generation
+    constexpr float RANDOM_MIN = 0.0f;
+    constexpr float RANDOM_MAX = 1.0f;
+    constexpr int64_t RANDOM_INT_MAX = 100;
+    constexpr int64_t DEFAULT_DYNAMIC_DIM = 1;
+
+    // Timing
+    constexpr int STATS_RESET_DELAY_MS = 500;
+
+    // Adaptive warmup (--adaptive-warmup): default coefficient-of-variation
+    // threshold, runs per rolling window, and the shortest warmup
+    constexpr double WARMUP_CV_THRESHOLD = 0.05;
+    constexpr int WARMUP_WINDOW_RUNS = 32;
+    constexpr int WARMUP_MIN_MS = 500;
+
+    // Confidence-interval termination (--ci-target): batch length of the batch
+    // means, batches needed before stopping, and the default shortest window
+    constexpr int CI_BATCH_MS = 500;
+    constexpr size_t CI_MIN_BATCHES = 10;
+    constexpr int CI_MIN_MEASUREMENT_SECONDS = 10;
+
+    // Precision variants benchmarked with --variants, as file suffixes written by
+    // scripts/make_variants.py ("<stem>_<variant>.onnx"), and the name of the original
+    constexpr const char *MODEL_VARIANTS[] = {"fp16", "int8_dynamic", "int8_static"};
+    constexpr const char *ORIGINAL_VARIANT = "fp32";
+
+    // Op types listed on the console and in the CSV's top_op_types column (--profile)
+    constexpr size_t PROFILE_TOP_OP_TYPES = 5;
+
+    // Output validation (--validate): dataset samples compared, and the default
+    // tolerances against the CPU fp32 reference
+    constexpr size_t VALIDATION_SAMPLES = 4;
+    constexpr double VALIDATION_MAX_ABS_ERROR = 1e-3;
+    constexpr double VALIDATION_MIN_COSINE = 0.999;
+
+    // Fuel-gauge / RAPL power sampling during measurement (--power-interval)
+    constexpr int POWER_SAMPLE_INTERVAL_MS = 20;
+
+    // Whether batterystats is reset and dumped around each window by default
+    // (--batterystats); dumpsys only exists on Android
+#ifdef __ANDROID__
+    constexpr bool BATTERYSTATS_DEFAULT = true;
+#else
+    constexpr bool BATTERYSTATS_DEFAULT = false;
+#endif
+
+    // Memory sampling during measurement
+    constexpr int MEMORY_SAMPLE_INTERVAL_MS = 100;
+
+    // Device telemetry (--telemetry): default interval, and samples reserved beyond
+    // the expected run length (setup time)
+    constexpr int TELEMETRY_SAMPLE_INTERVAL_MS = 200;
+    constexpr size_t TELEMETRY_SPARE_SAMPLES = 256;
+
+    // Per-iteration log (--iteration-log): records per chunk, chunks per worker
+    // (the writer may fall this far behind before records are dropped), and how
+    // long the writer sleeps when it has nothing to write
+    constexpr size_t ITERATION_LOG_CHUNK_RECORDS = 4096;
+    constexpr size_t ITERATION_LOG_CHUNKS_PER_WORKER = 8;
+    constexpr int ITERATION_LOG_WRITER_SLEEP_MS = 10;
+
+    // Session cache: sessions kept warm by the server (--serve), their resident
+    // memory budget (0 = unlimited), and pending server connections
+    constexpr size_t SESSION_CACHE_SIZE = 8;
+    constexpr int SESSION_CACHE_BUDGET_MB = 1024;
+    constexpr int SERVER_LISTEN_BACKLOG = 4;
+
+    // Background load (--co-run, --stress): how long co-run sessions may take to
+    // load, how often the start is polled, spin-loop iterations between stop checks,
+    // and the buffer each memory-bandwidth thread streams through (well above the LLC)
+    constexpr int INTERFERENCE_START_TIMEOUT_SECONDS = 60;
+    constexpr int INTERFERENCE_POLL_MS = 10;
+    constexpr int STRESS_CPU_BATCH = 1 << 16;
+    constexpr int STRESS_MEMBW_BUFFER_MB = 64;
+
+    // Fixed-rate schedules (--target-rate, --co-run=MODEL:HZ): the periods must
+    // be at least 1 ns and stay far from overflowing steady_clock over a run
+    constexpr double MIN_REQUEST_RATE_HZ = 1e-6;
+    constexpr double MAX_REQUEST_RATE_HZ = 1e9;
+
+    // Worker pool (--workers)
+    constexpr size_t WORKER_QUEUE_SLOTS_PER_WORKER = 2;
+    constexpr int WORKER_SPIN_ATTEMPTS = 64;
+    constexpr int WORKER_IDLE_SLEEP_US = 50;
+
+    // CSV format
+    constexpr const char *CSV_DELIMITER = ",";
+    constexpr int FLOAT_PRECISION = 3;
+}
@@ -0,0 +1,134 @@
+#include "cpu_affinity.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <unistd.h>
+
+namespace {
+    constexpr int MAX_CPUS = 64;
+
+    bool parse_cpu_index(const std::string &text, int &cpu) {
+        char *end = nullptr;
+        const long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || parsed < 0 || parsed >= MAX_CPUS) {
+            return false;
+        }
+        cpu = static_cast<int>(parsed);
+        return true;
+    }
+}
+
+bool parse_cpu_mask(const std::string &text, uint64_t &mask) {
+    if (text.rfind("0x", 0) == 0 || text.rfind("0X", 0) == 0) {
+        char *end = nullptr;
+        errno = 0;
+        const unsigned long long parsed = std::strtoull(text.c_str() + 2, &end, 16);
+        if (text.size() == 2 || *end != '\0' || errno != 0 || parsed == 0) {
+            return false;
+        }
+        mask = static_cast<uint64_t>(parsed);
+        return true;
+    }
+
+    uint64_t result = 0;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        const size_t dash = range.find('-');
+        int first = 0;
+        int last = 0;
+        if (dash == std::string::npos) {
+            if (!parse_cpu_index(range, first)) {
+                return false;
+            }
+            last = first;
+        } else if (!parse_cpu_index(range.substr(0, dash), first) ||
+                   !parse_cpu_index(range.substr(dash + 1), last) || last < first) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            result |= uint64_t{1} << cpu;
+        }
+    }
+
+    if (result == 0) {
+        return false;
+    }
+    mask = result;
+    return true;
+}
+
+std::string format_cpu_mask(uint64_t mask) {
+    std::ostringstream oss;
+    oss << "0x" << std::hex << mask;
+    return oss.str();
+}
+
+bool apply_cpu_affinity(uint64_t mask, std::string &error) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (mask == 0) {
+        // The kernel intersects this with the CPUs the process may use
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    for (int cpu = 0; cpu < MAX_CPUS; ++cpu) {
+        if (mask & (uint64_t{1} << cpu)) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+
+    // pid 0 applies to the calling thread only
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+uint64_t current_cpu_mask() {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+        return 0;
+    }
+    uint64_t mask = 0;
+    for (int cpu = 0; cpu < MAX_CPUS; ++cpu) {
+        if (CPU_ISSET(cpu, &cpu_set)) {
+            mask |= uint64_t{1} << cpu;
+        }
+    }
+    return mask;
+}
+
+std::vector<uint64_t> read_cpu_clusters() {
+    std::vector<uint64_t> clusters;
+    for (int policy = 0; policy < MAX_CPUS; ++policy) {
+        std::ifstream file("/sys/devices/system/cpu/cpufreq/policy" + std::to_string(policy) + "/related_cpus");
+        if (!file.is_open()) {
+            continue;
+        }
+        uint64_t mask = 0;
+        int cpu = 0;
+        while (file >> cpu) {
+            if (cpu >= 0 && cpu < MAX_CPUS) {
+                mask |= uint64_t{1} << cpu;
+            }
+        }
+        if (mask != 0) {
+            clusters.push_back(mask);
+        }
+    }
+
+    if (clusters.empty()) {
+        const long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        const int count = cpus > 0 && cpus < MAX_CPUS ? static_cast<int>(cpus) : MAX_CPUS;
+        clusters.push_back(count == MAX_CPUS ? ~uint64_t{0} : (uint64_t{1} << count) - 1);
+    }
+    return clusters;
+}
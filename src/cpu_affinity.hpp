@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parse a CPU mask given either as hex ("0xf0") or as a CPU list ("4-7", "0,2,4-5").
+// Supports CPUs 0-63. Returns false on malformed input.
+bool parse_cpu_mask(const std::string &text, uint64_t &mask);
+
+// Format a CPU mask as hex (e.g. "0xf0")
+std::string format_cpu_mask(uint64_t mask);
+
+// Pin the calling thread to the CPUs in mask (0 = all CPUs). Threads created
+// afterwards (including ONNX Runtime's intra-op and inter-op workers) inherit it.
+bool apply_cpu_affinity(uint64_t mask, std::string &error);
+
+// CPUs the calling thread may run on
+uint64_t current_cpu_mask();
+
+// CPU clusters (big/LITTLE groups): one mask per cpufreq policy, i.e. per set of
+// CPUs sharing a clock, in policy order. Falls back to one cluster of all CPUs.
+std::vector<uint64_t> read_cpu_clusters();
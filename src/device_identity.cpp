@@ -0,0 +1,188 @@
+#include "device_identity.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "config.hpp"
+
+#ifdef __ANDROID__
+#include <sys/system_properties.h>
+#else
+#include <sys/utsname.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+    constexpr size_t HASH_CHUNK_BYTES = 1 << 20;
+
+#ifdef __ANDROID__
+    std::string system_property(const char *name) {
+        char value[PROP_VALUE_MAX] = {};
+        __system_property_get(name, value);
+        return value;
+    }
+#endif
+
+    // "Google Pixel 8": the model usually repeats the manufacturer's name
+    std::string join_names(const std::string &vendor, const std::string &name) {
+        if (vendor.empty() || name.compare(0, vendor.size(), vendor) == 0) {
+            return name;
+        }
+        return name.empty() ? vendor : vendor + " " + name;
+    }
+
+    // The identity goes into CSV fields unquoted: the delimiter becomes ';' and
+    // line breaks, quotes and other control characters become spaces
+    std::string csv_safe(std::string text) {
+        for (char &c: text) {
+            if (c == Config::CSV_DELIMITER[0]) {
+                c = ';';
+            } else if (c == '"' || static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+                c = ' ';
+            }
+        }
+        while (!text.empty() && text.back() == ' ') {
+            text.pop_back();
+        }
+        return text;
+    }
+
+#ifndef __ANDROID__
+    // Device-tree properties are NUL-terminated, and string lists ("compatible")
+    // NUL-separated; only the first (most specific) entry is kept
+    std::string read_line(const std::string &path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        line = line.substr(0, line.find('\0'));
+        while (!line.empty() && line.back() == ' ') {
+            line.pop_back();
+        }
+        return line;
+    }
+
+    // "model name" on x86 (and some arm64 kernels), "Hardware" on older arm ones
+    std::string cpu_model_name() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            const size_t colon = line.find(':');
+            if (colon == std::string::npos || colon + 2 > line.size()) {
+                continue;
+            }
+            const std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+            if (key == "model name" || key == "Hardware") {
+                return line.substr(colon + 2);
+            }
+        }
+        return "";
+    }
+#endif
+
+    DeviceIdentity read_device_identity() {
+        DeviceIdentity identity;
+#ifdef __ANDROID__
+        identity.device_model = join_names(system_property("ro.product.manufacturer"),
+                                           system_property("ro.product.model"));
+        // ro.soc.* exist since Android 12; the board platform (e.g. "kalama") before that
+        identity.soc = join_names(system_property("ro.soc.manufacturer"), system_property("ro.soc.model"));
+        if (identity.soc.empty()) {
+            identity.soc = system_property("ro.board.platform");
+        }
+        identity.build_fingerprint = system_property("ro.build.fingerprint");
+#else
+        // Linux host: DMI on x86 servers, the device tree on arm64 boards
+        identity.device_model = join_names(read_line("/sys/devices/virtual/dmi/id/sys_vendor"),
+                                           read_line("/sys/devices/virtual/dmi/id/product_name"));
+        if (identity.device_model.empty()) {
+            identity.device_model = read_line("/proc/device-tree/model");
+        }
+        identity.soc = cpu_model_name();
+        if (identity.soc.empty()) {
+            identity.soc = read_line("/proc/device-tree/compatible");
+        }
+        utsname system{};
+        if (uname(&system) == 0) {
+            identity.build_fingerprint = std::string(system.sysname) + " " + system.release + " " + system.machine;
+        }
+#endif
+        identity.ort_version = Ort::GetVersionString();
+        for (std::string *field: {&identity.device_model, &identity.soc, &identity.build_fingerprint,
+                                  &identity.ort_version}) {
+            *field = csv_safe(*field);
+        }
+        return identity;
+    }
+
+    uint64_t fnv1a(uint64_t hash, const char *data, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(data[i])) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    std::string hex_digits(uint64_t hash) {
+        std::ostringstream oss;
+        oss << std::hex;
+        oss.width(16);
+        oss.fill('0');
+        oss << hash;
+        return oss.str();
+    }
+
+    struct CachedHash {
+        uintmax_t size = 0;
+        fs::file_time_type modified;
+        std::string hash;
+    };
+}
+
+const DeviceIdentity &device_identity() {
+    static const DeviceIdentity identity = read_device_identity();
+    return identity;
+}
+
+std::string model_file_hash(const std::string &path) {
+    // Only the driver thread hashes; a batch or sweep hashes each file once
+    static std::map<std::string, CachedHash> cache;
+
+    std::error_code error;
+    const uintmax_t size = fs::file_size(path, error);
+    const fs::file_time_type modified = fs::last_write_time(path, error);
+    if (error) {
+        return "";
+    }
+    const auto cached = cache.find(path);
+    if (cached != cache.end() && cached->second.size == size && cached->second.modified == modified) {
+        return cached->second.hash;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return "";
+    }
+    uint64_t hash = FNV_OFFSET_BASIS;
+    std::vector<char> chunk(HASH_CHUNK_BYTES);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hash = fnv1a(hash, chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+    if (file.bad()) {
+        return "";
+    }
+
+    const std::string digits = hex_digits(hash);
+    cache[path] = CachedHash{size, modified, digits};
+    return digits;
+}
+
+std::string text_hash(const std::string &text) {
+    return hex_digits(fnv1a(FNV_OFFSET_BASIS, text.data(), text.size()));
+}
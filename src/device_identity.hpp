@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+// What a measurement ran on, so that runs can be compared over time
+// (scripts/regression.py keys its baselines by these). Empty = unavailable.
+// On a Linux host the same fields come from DMI or the device tree, the CPU
+// model in /proc/cpuinfo, and the kernel release. The strings hold no CSV
+// delimiter, quote or control character.
+struct DeviceIdentity {
+    std::string device_model;       // ro.product.manufacturer + ro.product.model
+    std::string soc;                // ro.soc.manufacturer + ro.soc.model, else ro.board.platform
+    std::string build_fingerprint;  // ro.build.fingerprint (OS build)
+    std::string ort_version;        // ONNX Runtime library actually loaded
+};
+
+// Read once; later calls return the same values
+const DeviceIdentity &device_identity();
+
+// Content hash of a model file: 64-bit FNV-1a of its bytes, as 16 hex digits.
+// Cached per path, size and modification time. Returns "" if the file cannot be read.
+std::string model_file_hash(const std::string &path);
+
+// The same hash of a string, e.g. to name files after a long key
+std::string text_hash(const std::string &text);
@@ -0,0 +1,347 @@
+#include "device_telemetry.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unistd.h>
+#include "config.hpp"
+#include "cpu_affinity.hpp"
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    constexpr int MAX_CPUS = 64;
+    constexpr const char *CPU_DIR = "/sys/devices/system/cpu";
+    constexpr const char *THERMAL_DIR = "/sys/class/thermal";
+
+    // Zones outside this range are unused sensors reporting placeholder values
+    constexpr double MIN_PLAUSIBLE_TEMP_C = -40.0;
+    constexpr double MAX_PLAUSIBLE_TEMP_C = 150.0;
+
+    std::string read_line(const std::string &path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    // Numeric suffixes of the directory entries named <prefix><N>, sorted
+    std::vector<int> numbered_entries(const char *dir_path, const std::string &prefix) {
+        std::vector<int> numbers;
+        DIR *dir = opendir(dir_path);
+        if (dir == nullptr) {
+            return numbers;
+        }
+        while (const dirent *entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.compare(0, prefix.size(), prefix) != 0 || name.size() == prefix.size()) {
+                continue;
+            }
+            char *end = nullptr;
+            const long number = std::strtol(name.c_str() + prefix.size(), &end, 10);
+            if (*end == '\0' && number >= 0) {
+                numbers.push_back(static_cast<int>(number));
+            }
+        }
+        closedir(dir);
+        std::sort(numbers.begin(), numbers.end());
+        return numbers;
+    }
+
+    // Column-safe thermal zone type, e.g. "cpu-1-0-usr" → "cpu_1_0_usr"
+    std::string column_name(const std::string &text) {
+        std::string name;
+        for (const char c: text) {
+            name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        }
+        return name;
+    }
+
+    void write_optional(std::ofstream &file, double value) {
+        if (!std::isnan(value)) {
+            file << value;
+        }
+    }
+}
+
+bool read_sysfs_integer(int fd, long long &value) {
+    char buffer[64];
+    const ssize_t length = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if (length <= 0) {
+        return false;
+    }
+    buffer[length] = '\0';
+    char *end = nullptr;
+    value = std::strtoll(buffer, &end, 10);
+    return end != buffer;
+}
+
+const char *benchmark_phase_name(BenchmarkPhase phase) {
+    switch (phase) {
+        case BenchmarkPhase::Setup:
+            return "setup";
+        case BenchmarkPhase::Warmup:
+            return "warmup";
+        case BenchmarkPhase::Silence:
+            return "silence";
+        case BenchmarkPhase::Measurement:
+            return "measurement";
+    }
+    return "unknown";
+}
+
+TelemetrySampler::TelemetrySampler(std::chrono::milliseconds interval, std::chrono::seconds expected_duration,
+                                   const RunProgress &progress)
+    : interval_(interval), expected_duration_(expected_duration), progress_(progress) {
+}
+
+TelemetrySampler::~TelemetrySampler() {
+    stop();
+    for (const auto &channel: channels_) {
+        close(channel.fd);
+    }
+}
+
+void TelemetrySampler::open_channels() {
+    const auto open_channel = [this](const std::string &path, ChannelKind kind, const std::string &name,
+                                     uint64_t cpu_mask) -> Channel * {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        Channel channel;
+        channel.name = name;
+        channel.kind = kind;
+        channel.fd = fd;
+        channel.cpu_mask = cpu_mask;
+        channels_.push_back(channel);
+        return &channels_.back();
+    };
+
+    // Offline CPUs have no cpufreq directory; their column is left out
+    for (int cpu = 0; cpu < MAX_CPUS; ++cpu) {
+        const std::string cpufreq = std::string(CPU_DIR) + "/cpu" + std::to_string(cpu) + "/cpufreq";
+        open_channel(cpufreq + "/scaling_cur_freq", ChannelKind::CpuFrequency,
+                     "cpu" + std::to_string(cpu) + "_mhz", uint64_t{1} << cpu);
+    }
+
+    const std::vector<uint64_t> clusters = read_cpu_clusters();
+    const std::string policy_dir = std::string(CPU_DIR) + "/cpufreq";
+    for (const int policy: numbered_entries(policy_dir.c_str(), "policy")) {
+        const std::string path = policy_dir + "/policy" + std::to_string(policy);
+        const uint64_t policy_cpus = policy < MAX_CPUS ? uint64_t{1} << policy : 0;
+        uint64_t cpu_mask = policy_cpus;
+        for (const uint64_t cluster: clusters) {
+            if (cluster & policy_cpus) {
+                cpu_mask = cluster;  // policyN is named after the first CPU of its cluster
+            }
+        }
+        Channel *channel = open_channel(path + "/scaling_max_freq", ChannelKind::FrequencyCap,
+                                        "policy" + std::to_string(policy) + "_max_mhz", cpu_mask);
+        if (channel != nullptr) {
+            channel->hardware_max_mhz = std::atof(read_line(path + "/cpuinfo_max_freq").c_str()) / 1000.0;
+        }
+    }
+
+    for (const int zone: numbered_entries(THERMAL_DIR, "thermal_zone")) {
+        const std::string path = std::string(THERMAL_DIR) + "/thermal_zone" + std::to_string(zone);
+        const std::string type = read_line(path + "/type");
+        open_channel(path + "/temp", ChannelKind::Temperature,
+                     "tz" + std::to_string(zone) + (type.empty() ? "" : "_" + column_name(type)) + "_c", 0);
+    }
+}
+
+bool TelemetrySampler::start() {
+    if (channels_.empty()) {
+        open_channels();
+    }
+    if (channels_.empty()) {
+        return false;
+    }
+
+    // Room for every tick of the run plus some slack, so that sample() never reallocates
+    const size_t expected_samples = static_cast<size_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(expected_duration_).count() /
+        std::max<int64_t>(1, interval_.count())) + Config::TELEMETRY_SPARE_SAMPLES;
+    samples_.clear();
+    values_.clear();
+    samples_.reserve(expected_samples);
+    values_.reserve(expected_samples * channels_.size());
+
+    start_ = clock::now();
+    stopping_ = false;
+    thread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        do {
+            sample();
+        } while (!stop_requested_.wait_for(lock, interval_, [this]() { return stopping_; }));
+    });
+    return true;
+}
+
+void TelemetrySampler::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stop_requested_.notify_one();
+    thread_.join();
+    sample();  // The end of the last phase counts too
+}
+
+void TelemetrySampler::sample() {
+    TelemetrySample tick;
+    tick.elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start_).count();
+    tick.epoch_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    tick.phase = progress_.phase();
+    tick.runs = progress_.runs();
+    tick.run_ns = progress_.run_ns();
+    tick.phase_runs = tick.runs - std::min(tick.runs, progress_.phase_start_runs());
+    samples_.push_back(tick);
+
+    for (const auto &channel: channels_) {
+        long long raw = 0;
+        double value = std::numeric_limits<double>::quiet_NaN();
+        if (read_sysfs_integer(channel.fd, raw)) {
+            if (channel.kind == ChannelKind::Temperature) {
+                // Most zones report millidegrees, a few drivers whole degrees
+                value = std::llabs(raw) >= 1000 ? static_cast<double>(raw) / 1000.0 : static_cast<double>(raw);
+            } else {
+                value = static_cast<double>(raw) / 1000.0;  // kHz
+            }
+        }
+        values_.push_back(value);
+    }
+}
+
+TelemetrySummary TelemetrySampler::summarize(BenchmarkPhase phase) const {
+    TelemetrySummary summary;
+    std::vector<size_t> phase_samples;
+    for (size_t i = 0; i < samples_.size(); ++i) {
+        if (samples_[i].phase == phase) {
+            phase_samples.push_back(i);
+        }
+    }
+    if (phase_samples.empty()) {
+        return summary;
+    }
+
+    // Mean frequency over the online CPUs of each cluster
+    std::ostringstream freq;
+    freq << std::fixed << std::setprecision(0);
+    bool first_cluster = true;
+    for (const uint64_t cluster: read_cpu_clusters()) {
+        double sum = 0.0;
+        size_t count = 0;
+        for (size_t c = 0; c < channels_.size(); ++c) {
+            if (channels_[c].kind != ChannelKind::CpuFrequency || !(channels_[c].cpu_mask & cluster)) {
+                continue;
+            }
+            for (const size_t s: phase_samples) {
+                if (!std::isnan(value(s, c))) {
+                    sum += value(s, c);
+                    ++count;
+                }
+            }
+        }
+        if (count > 0) {
+            freq << (first_cluster ? "" : ";") << format_cpu_mask(cluster) << ":" << sum / static_cast<double>(count);
+            first_cluster = false;
+        }
+    }
+    summary.cluster_freq_mhz = freq.str();
+
+    size_t throttled = 0;
+    bool has_caps = false;
+    bool has_temperature = false;
+    for (const size_t s: phase_samples) {
+        bool capped = false;
+        double hottest = std::numeric_limits<double>::quiet_NaN();
+        for (size_t c = 0; c < channels_.size(); ++c) {
+            const double v = value(s, c);
+            if (std::isnan(v)) {
+                continue;
+            }
+            if (channels_[c].kind == ChannelKind::FrequencyCap && channels_[c].hardware_max_mhz > 0.0) {
+                has_caps = true;
+                capped = capped || v < channels_[c].hardware_max_mhz;
+            } else if (channels_[c].kind == ChannelKind::Temperature && v >= MIN_PLAUSIBLE_TEMP_C &&
+                       v <= MAX_PLAUSIBLE_TEMP_C && !(hottest >= v)) {
+                hottest = v;
+            }
+        }
+        throttled += capped ? 1 : 0;
+        if (!std::isnan(hottest)) {
+            if (!has_temperature) {
+                summary.temp_start_c = hottest;
+                summary.temp_max_c = hottest;
+                has_temperature = true;
+            }
+            summary.temp_max_c = std::max(summary.temp_max_c, hottest);
+        }
+    }
+    if (has_caps) {
+        summary.throttled_fraction = static_cast<double>(throttled) / static_cast<double>(phase_samples.size());
+    }
+    return summary;
+}
+
+bool TelemetrySampler::export_csv(const std::string &output_file) const {
+    std::ofstream file(output_file);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not create telemetry file: " << output_file << "\n";
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(Config::FLOAT_PRECISION);
+    file << "elapsed_ms" << Config::CSV_DELIMITER
+            << "epoch_ms" << Config::CSV_DELIMITER
+            << "phase" << Config::CSV_DELIMITER
+            << "phase_iterations" << Config::CSV_DELIMITER
+            << "interval_iterations" << Config::CSV_DELIMITER
+            << "interval_latency_mean_us";
+    for (const auto &channel: channels_) {
+        file << Config::CSV_DELIMITER << channel.name;
+    }
+    file << "\n";
+
+    // Latency columns cover the runs that completed since the previous sample
+    for (size_t s = 0; s < samples_.size(); ++s) {
+        const TelemetrySample &tick = samples_[s];
+        const uint64_t previous_runs = s == 0 ? 0 : samples_[s - 1].runs;
+        const uint64_t previous_ns = s == 0 ? 0 : samples_[s - 1].run_ns;
+        const uint64_t interval_runs = tick.runs - previous_runs;
+        file << tick.elapsed_ms << Config::CSV_DELIMITER
+                << tick.epoch_ms << Config::CSV_DELIMITER
+                << benchmark_phase_name(tick.phase) << Config::CSV_DELIMITER
+                << tick.phase_runs << Config::CSV_DELIMITER
+                << interval_runs << Config::CSV_DELIMITER;
+        if (interval_runs > 0) {
+            file << static_cast<double>(tick.run_ns - previous_ns) / static_cast<double>(interval_runs) / 1000.0;
+        }
+        for (size_t c = 0; c < channels_.size(); ++c) {
+            file << Config::CSV_DELIMITER;
+            write_optional(file, value(s, c));
+        }
+        file << "\n";
+    }
+
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Warning: Error writing to telemetry file\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class BenchmarkPhase {
+    Setup,
+    Warmup,
+    Silence,
+    Measurement
+};
+
+const char *benchmark_phase_name(BenchmarkPhase phase);
+
+// Read the integer at the start of an open sysfs file (re-read in place with
+// pread, without allocating)
+bool read_sysfs_integer(int fd, long long &value);
+
+// Phase and completed runs, published by the benchmark threads for the telemetry
+// sampler. Only relaxed/release atomics: recording a run never blocks or allocates.
+class RunProgress {
+public:
+    // Called by the driver thread between phases, while no run is in flight
+    void begin_phase(BenchmarkPhase phase) {
+        phase_start_runs_.store(runs_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        phase_.store(static_cast<int>(phase), std::memory_order_release);
+    }
+
+    void record_run(uint64_t latency_ns) {
+        runs_.fetch_add(1, std::memory_order_relaxed);
+        run_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+    }
+
+    BenchmarkPhase phase() const { return static_cast<BenchmarkPhase>(phase_.load(std::memory_order_acquire)); }
+    uint64_t phase_start_runs() const { return phase_start_runs_.load(std::memory_order_relaxed); }
+    uint64_t runs() const { return runs_.load(std::memory_order_relaxed); }
+    uint64_t run_ns() const { return run_ns_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> phase_{static_cast<int>(BenchmarkPhase::Setup)};
+    std::atomic<uint64_t> phase_start_runs_{0};
+    std::atomic<uint64_t> runs_{0};     // Since construction, all phases
+    std::atomic<uint64_t> run_ns_{0};
+};
+
+// One sampler tick: benchmark progress plus one value per channel
+struct TelemetrySample {
+    double elapsed_ms = 0.0;  // Since start()
+    int64_t epoch_ms = 0;
+    BenchmarkPhase phase = BenchmarkPhase::Setup;
+    uint64_t phase_runs = 0;  // Runs completed in the phase so far
+    uint64_t runs = 0;        // Cumulative runs and their total latency
+    uint64_t run_ns = 0;
+};
+
+// Measurement-window summary of the samples (-1 / empty = not available)
+struct TelemetrySummary {
+    std::string cluster_freq_mhz;      // "<cluster mask>:<mean MHz>;..."
+    double throttled_fraction = -1.0;  // Samples with a policy capped below its hardware maximum
+    double temp_start_c = -1.0;        // Hottest thermal zone at the first and warmest sample
+    double temp_max_c = -1.0;
+};
+
+// Samples the current frequency of every CPU (cpufreq scaling_cur_freq), the
+// frequency cap of every cpufreq policy (scaling_max_freq, lowered by thermal
+// throttling) and the temperature of every thermal zone on a background thread.
+// The sysfs files are opened once and re-read in place; storage for the
+// expected number of samples is reserved up front, so the sampler does not
+// allocate during the measured phases.
+class TelemetrySampler {
+public:
+    TelemetrySampler(std::chrono::milliseconds interval, std::chrono::seconds expected_duration,
+                     const RunProgress &progress);
+    ~TelemetrySampler();
+
+    TelemetrySampler(const TelemetrySampler &) = delete;
+    TelemetrySampler &operator=(const TelemetrySampler &) = delete;
+
+    // Open the channels and start sampling. Returns false if no channel is readable.
+    bool start();
+    void stop();
+
+    // Valid after stop()
+    const std::vector<TelemetrySample> &samples() const { return samples_; }
+    TelemetrySummary summarize(BenchmarkPhase phase) const;
+
+    // Write one row per sample (progress, latency since the previous sample, then
+    // every channel in MHz or °C) to a CSV file
+    bool export_csv(const std::string &output_file) const;
+
+private:
+    enum class ChannelKind {
+        CpuFrequency,
+        FrequencyCap,
+        Temperature
+    };
+
+    struct Channel {
+        std::string name;  // CSV column
+        ChannelKind kind = ChannelKind::CpuFrequency;
+        int fd = -1;
+        uint64_t cpu_mask = 0;             // CPU or policy CPUs (frequency channels)
+        double hardware_max_mhz = 0.0;     // cpuinfo_max_freq (frequency caps)
+    };
+
+    void open_channels();
+    void sample();
+    double value(size_t sample, size_t channel) const { return values_[sample * channels_.size() + channel]; }
+
+    std::chrono::milliseconds interval_;
+    std::chrono::seconds expected_duration_;
+    const RunProgress &progress_;
+    std::chrono::steady_clock::time_point start_;
+
+    std::vector<Channel> channels_;
+    std::vector<TelemetrySample> samples_;
+    std::vector<double> values_;  // channels_.size() per sample; NaN = read failed
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_requested_;
+    bool stopping_ = false;
+};
@@ -0,0 +1,224 @@
+#include "inference_session.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include "config.hpp"
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    double elapsed_ms(clock::time_point start, clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    Ort::SessionOptions make_profiling_session_options(const SessionConfig &config,
+                                                       const std::string &profile_prefix) {
+        Ort::SessionOptions session_options = make_session_options(config);
+        if (!profile_prefix.empty()) {
+            session_options.EnableProfiling(profile_prefix.c_str());
+        }
+        return session_options;
+    }
+
+    std::vector<char> read_file(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open model file " + path);
+        }
+        std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+            throw std::runtime_error("Cannot read model file " + path);
+        }
+        return bytes;
+    }
+}
+
+std::shared_ptr<Ort::Env> shared_ort_env(bool shared_arena) {
+    // Co-run sessions (--co-run) are created on their background threads while
+    // the driver may create its own, so the shared state is locked
+    static std::mutex mutex;
+    static std::weak_ptr<Ort::Env> current;
+    static bool arena_registered = false;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<Ort::Env> env = current.lock();
+    if (!env) {
+        env = std::make_shared<Ort::Env>(Config::LOGGING_LEVEL, Config::ENV_NAME);
+        current = env;
+        arena_registered = false;
+    }
+    if (shared_arena && !arena_registered) {
+        // Default arena settings: no limit, ONNX Runtime's extend strategy and chunk sizes
+        const Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const Ort::ArenaCfg arena_cfg(0, -1, -1, -1);
+        env->CreateAndRegisterAllocator(memory_info, arena_cfg);
+        arena_registered = true;
+    }
+    return env;
+}
+
+InferenceSession::InferenceSession(const std::string &model_path, const SessionConfig &config,
+                                   const InputConfig &input_config, const std::string &profile_prefix)
+    : env_(shared_ort_env(config.shared_arena)) {
+    const Ort::SessionOptions session_options = make_profiling_session_options(config, profile_prefix);
+
+    // The model bytes are only needed while the session is created
+    auto start = clock::now();
+    std::vector<char> buffer;
+    MappedFile mapping;
+    const void *model_data = nullptr;
+    size_t model_size = 0;
+    if (config.load_mode == ModelLoadMode::Buffer) {
+        buffer = read_file(model_path);
+        model_data = buffer.data();
+        model_size = buffer.size();
+    } else if (config.load_mode == ModelLoadMode::Mmap) {
+        std::string error;
+        if (!mapping.open(model_path, error)) {
+            throw std::runtime_error(error);
+        }
+        model_data = mapping.data();
+        model_size = mapping.size();
+    }
+    auto end = clock::now();
+    startup_.file_read_ms = elapsed_ms(start, end);
+
+    start = end;
+    session_ = model_data ? Ort::Session(*env_, model_data, model_size, session_options)
+                          : Ort::Session(*env_, model_path.c_str(), session_options);
+    end = clock::now();
+    startup_.session_create_ms = elapsed_ms(start, end);
+
+    if (session_.GetInputCount() == 0) {
+        throw std::runtime_error("No input nodes found in model");
+    }
+
+    // Create the input data once; every run() reuses it
+    start = end;
+    inputs_ = create_model_inputs(session_, input_config);
+    prepare_output_names();
+    end = clock::now();
+    startup_.input_prep_ms = elapsed_ms(start, end);
+
+    start = end;
+    init_run_context(context_, inputs_, 0);
+    startup_.first_run_ms = elapsed_ms(start, clock::now());
+}
+
+void InferenceSession::prepare_output_names() {
+    Ort::AllocatorWithDefaultOptions allocator;
+    const size_t num_output_nodes = session_.GetOutputCount();
+
+    output_name_ptrs_.reserve(num_output_nodes);
+    output_names_.reserve(num_output_nodes);
+
+    for (size_t i = 0; i < num_output_nodes; i++) {
+        output_name_ptrs_.push_back(session_.GetOutputNameAllocated(i, allocator));
+        output_names_.push_back(output_name_ptrs_.back().get());
+    }
+}
+
+void InferenceSession::init_run_context(RunContext &context, const std::vector<ModelInput> &inputs,
+                                        size_t first_sample) {
+    // A dataset gets one binding per sample, so cycling through it only switches bindings
+    const size_t samples = dataset_size(inputs);
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    context.bindings.reserve(samples);
+    for (size_t s = 0; s < samples; ++s) {
+        context.bindings.emplace_back(session_);
+        Ort::IoBinding &binding = context.bindings.back();
+        for (const auto &input: inputs) {
+            binding.BindInput(input.name.c_str(), input.tensors[input.tensors.size() == 1 ? 0 : s]);
+        }
+        for (const char *name: output_names_) {
+            binding.BindOutput(name, memory_info);
+        }
+    }
+    context.next_binding = first_sample % samples;
+
+    // Let ONNX Runtime allocate the outputs once, then bind those same buffers
+    // so that every later run writes into them instead of allocating new ones.
+    Ort::IoBinding &first = context.bindings.front();
+    session_.Run(run_options_, first);
+
+    // Output shapes of a dataset can depend on the sample (NMS, TopK, ...), so
+    // dataset samples keep letting ONNX Runtime allocate (from its arena)
+    if (samples > 1) {
+        return;
+    }
+
+    context.output_values = first.GetOutputValues();
+    for (size_t i = 0; i < context.output_values.size(); ++i) {
+        // Only tensors can be bound as preallocated outputs
+        if (context.output_values[i].IsTensor()) {
+            first.BindOutput(output_names_[i], context.output_values[i]);
+        }
+    }
+}
+
+std::unique_ptr<RunContext> InferenceSession::create_run_context(size_t first_sample) {
+    auto context = std::make_unique<RunContext>();
+    init_run_context(*context, inputs_, first_sample);
+    return context;
+}
+
+std::unique_ptr<RunContext> InferenceSession::create_run_context(const std::vector<ModelInput> &inputs) {
+    auto context = std::make_unique<RunContext>();
+    init_run_context(*context, inputs, 0);
+    return context;
+}
+
+void InferenceSession::run() {
+    run(context_);
+}
+
+void InferenceSession::run(RunContext &context) {
+    session_.Run(run_options_, context.bindings[context.next_binding]);
+    if (++context.next_binding == context.bindings.size()) {
+        context.next_binding = 0;
+    }
+}
+
+std::vector<Ort::Value> InferenceSession::run_outputs(const std::vector<ModelInput> &inputs, size_t sample) {
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::vector<const char *> input_names;
+    std::vector<Ort::Value> input_values;
+    for (const auto &own: inputs_) {
+        const auto found = std::find_if(inputs.begin(), inputs.end(),
+                                        [&](const ModelInput &input) { return input.name == own.name; });
+        if (found == inputs.end()) {
+            throw std::runtime_error("No data for input '" + own.name + "'");
+        }
+        const Ort::Value &tensor = found->tensors[found->tensors.size() == 1 ? 0 : sample % found->tensors.size()];
+        const auto info = tensor.GetTensorTypeAndShapeInfo();
+        const size_t bytes = info.GetElementCount() * element_size(info.GetElementType());
+        if (bytes == 0 && info.GetElementCount() > 0) {
+            throw std::runtime_error("Input '" + own.name + "' has no fixed-size element type");
+        }
+
+        // A view of the other session's buffer, so that both run on the same bytes
+        const std::vector<int64_t> shape = info.GetShape();
+        input_values.push_back(Ort::Value::CreateTensor(memory_info, const_cast<void *>(tensor.GetTensorRawData()),
+                                                        bytes, shape.data(), shape.size(), info.GetElementType()));
+        input_names.push_back(own.name.c_str());
+    }
+    return session_.Run(run_options_, input_names.data(), input_values.data(), input_values.size(),
+                        output_names_.data(), output_names_.size());
+}
+
+std::string InferenceSession::end_profiling() {
+    Ort::AllocatorWithDefaultOptions allocator;
+    Ort::AllocatedStringPtr profile_path = session_.EndProfilingAllocated(allocator);
+    return profile_path ? std::string(profile_path.get()) : std::string();
+}
+
+// Real ONNX Runtime inference. The session's own priming run is the inference.
+StartupTimings run_onnx_inference(const std::string &model_path, const SessionConfig &config,
+                                  const InputConfig &input_config) {
+    InferenceSession session(model_path, config, input_config);
+    return session.startup_timings();
+}
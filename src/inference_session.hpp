@@ -0,0 +1,109 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "model_inputs.hpp"
+#include "session_config.hpp"
+
+// Time spent in each step of building a session, in milliseconds
+struct StartupTimings {
+    double file_read_ms = 0.0;       // Reading or mapping the model (buffer/mmap load modes)
+    double session_create_ms = 0.0;  // Ort::Session constructor: parsing, graph optimization, init
+    double input_prep_ms = 0.0;      // Generating or mapping the inputs
+    double first_run_ms = 0.0;       // Binding the inputs/outputs and the first (priming) run
+};
+
+// IO state of one caller: bindings with the caller's own output buffers and
+// its position in the dataset. Session::Run is thread-safe, so threads that
+// share a session each run it through their own RunContext.
+struct RunContext {
+    std::vector<Ort::IoBinding> bindings;   // One per dataset sample
+    std::vector<Ort::Value> output_values;  // Preallocated outputs (single-sample inputs only)
+    size_t next_binding = 0;
+};
+
+// ONNX Runtime environment shared by every live InferenceSession. It is created
+// when no session holds it any more, so a cold load still builds its own. The
+// first call with shared_arena registers one CPU arena with it
+// (CreateAndRegisterAllocator); sessions with SessionConfig::shared_arena
+// allocate from that arena instead of their own. Safe to call from any thread.
+std::shared_ptr<Ort::Env> shared_ort_env(bool shared_arena = false);
+
+// ONNX Runtime session that is built once and reused across iterations.
+// Owns the session, the input/output names and the input tensors, so that
+// run() performs nothing but the inference itself.
+//
+// Inputs and outputs are bound through Ort::IoBinding: inputs are filled
+// once, and outputs are bound to the buffers produced by a priming run in
+// the constructor, so steady-state runs do not allocate tensors. Inputs with
+// several dataset samples get one binding per sample, and run() cycles
+// through them.
+class InferenceSession {
+public:
+    // A non-empty profile_prefix enables ORT profiling; the priming run is then
+    // part of the trace, which end_profiling() writes and returns the path of.
+    InferenceSession(const std::string &model_path, const SessionConfig &config,
+                     const InputConfig &input_config, const std::string &profile_prefix = "");
+
+    InferenceSession(const InferenceSession &) = delete;
+    InferenceSession &operator=(const InferenceSession &) = delete;
+
+    // Run a single inference on the prepared inputs (the next dataset sample)
+    void run();
+
+    // Create bindings for another caller (e.g. a worker thread), starting at the
+    // given dataset sample. Performs one priming run to allocate its outputs.
+    std::unique_ptr<RunContext> create_run_context(size_t first_sample = 0);
+
+    // Create bindings for another caller over its own input buffers: the same
+    // names, types and shapes as inputs(), one sample each (e.g. buffers that
+    // are refilled between runs). Performs one priming run.
+    std::unique_ptr<RunContext> create_run_context(const std::vector<ModelInput> &inputs);
+
+    // Run a single inference through a context from create_run_context()
+    void run(RunContext &context);
+
+    // Generated input tensors, in model input order
+    const std::vector<ModelInput> &inputs() const { return inputs_; }
+
+    // Output names, in model output order
+    const std::vector<const char *> &output_names() const { return output_names_; }
+
+    // Run once on dataset sample `sample` of the given inputs (matched by name,
+    // e.g. another session's inputs()) and return the outputs ONNX Runtime
+    // allocated, in model output order. Used to compare sessions on identical
+    // inputs; throws if an input is missing or has string elements.
+    std::vector<Ort::Value> run_outputs(const std::vector<ModelInput> &inputs, size_t sample);
+
+    // How long the constructor spent in each startup step
+    const StartupTimings &startup_timings() const { return startup_; }
+
+    // Stop profiling and return the path of the written JSON trace
+    std::string end_profiling();
+
+private:
+    void prepare_output_names();
+    void init_run_context(RunContext &context, const std::vector<ModelInput> &inputs, size_t first_sample);
+
+    std::shared_ptr<Ort::Env> env_;
+    Ort::Session session_{nullptr};
+    Ort::RunOptions run_options_;
+
+    std::vector<ModelInput> inputs_;
+
+    std::vector<Ort::AllocatedStringPtr> output_name_ptrs_;
+    std::vector<const char *> output_names_;
+
+    // Bindings used by run(); cycles through the dataset samples
+    RunContext context_;
+
+    StartupTimings startup_;
+};
+
+// Cold-load inference: builds a fresh environment (unless cached sessions hold
+// the shared one) and session, prepares the inputs and runs once. Used to measure model load cost; returns the time
+// spent in each step so that load and inference can be reported apart.
+StartupTimings run_onnx_inference(const std::string &model_path, const SessionConfig &config,
+                                  const InputConfig &input_config);
@@ -0,0 +1,179 @@
+#include "input_pipeline.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace {
+    uint64_t duration_ns(std::chrono::steady_clock::duration duration) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+}
+
+const char *prep_mode_name(PrepMode mode) {
+    switch (mode) {
+        case PrepMode::None:
+            return "none";
+        case PrepMode::Serial:
+            return "serial";
+        case PrepMode::Pipelined:
+            return "pipelined";
+    }
+    return "unknown";
+}
+
+bool parse_prep_mode(const std::string &text, PrepMode &mode) {
+    if (text == "none") {
+        mode = PrepMode::None;
+    } else if (text == "serial") {
+        mode = PrepMode::Serial;
+    } else if (text == "pipelined") {
+        mode = PrepMode::Pipelined;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+InputPipeline::InputPipeline(InferenceSession &session, PrepMode mode, int passes, uint64_t seed)
+    : session_(session), mode_(mode), passes_(std::max(passes, 1)), seed_(seed) {
+    if (seed_ == 0) {
+        std::random_device rd;
+        seed_ = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    // Every buffer starts as a copy of the setup inputs (first dataset sample),
+    // so the priming runs see valid data
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    slots_.resize(mode_ == PrepMode::Pipelined ? 2 : 1);
+    for (auto &slot: slots_) {
+        for (const auto &source: session_.inputs()) {
+            ModelInput input;
+            input.name = source.name;
+            input.element_type = source.element_type;
+            input.shape = source.shape;
+            input.symbolic_dims = source.symbolic_dims;
+            input.source = source.source;
+            input.range = source.range;
+
+            const Ort::Value &first = source.tensors.front();
+            input.data.resize(first.GetTensorTypeAndShapeInfo().GetElementCount() * element_size(input.element_type));
+            std::memcpy(input.data.data(), first.GetTensorRawData(), input.data.size());
+            input.tensors.push_back(Ort::Value::CreateTensor(
+                memory_info,
+                input.data.data(),
+                input.data.size(),
+                input.shape.data(),
+                input.shape.size(),
+                input.element_type));
+            slot.inputs.push_back(std::move(input));
+        }
+        slot.context = session_.create_run_context(slot.inputs);
+    }
+
+    if (mode_ == PrepMode::Pipelined) {
+        producer_ = std::thread([this]() { run_producer(); });
+    }
+}
+
+InputPipeline::~InputPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+}
+
+void InputPipeline::prepare(Slot &slot, uint64_t frame) {
+    const auto start = clock::now();
+    const std::vector<ModelInput> &sources = session_.inputs();
+    for (int pass = 0; pass < passes_; ++pass) {
+        for (size_t i = 0; i < slot.inputs.size(); ++i) {
+            const ModelInput &source = sources[i];
+            ModelInput &input = slot.inputs[i];
+            if (source.mapping) {
+                // The next dataset sample, read out of the mapped file
+                const Ort::Value &sample = source.tensors[frame % source.tensors.size()];
+                std::memcpy(input.data.data(), sample.GetTensorRawData(), input.data.size());
+            } else {
+                // A fresh stream per frame and input
+                fill_random(input.data.data(), input.data.size() / element_size(input.element_type),
+                            input.element_type, input.range,
+                            seed_ + 0x9E3779B97F4A7C15ull * (frame * slot.inputs.size() + i + 1));
+            }
+        }
+    }
+    slot.prep_start = start;
+    slot.prep_ns = duration_ns(clock::now() - start);
+}
+
+void InputPipeline::run_producer() {
+    uint64_t frame = 0;
+    size_t index = 0;
+    for (;;) {
+        Slot &slot = slots_[index];
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [&]() { return !slot.ready || stopping_; });
+            if (stopping_) {
+                return;
+            }
+        }
+        // The consumer does not touch a slot that is not ready
+        prepare(slot, frame++);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slot.ready = true;
+        }
+        changed_.notify_all();
+        index = (index + 1) % slots_.size();
+    }
+}
+
+void InputPipeline::run() {
+    Slot &slot = slots_[next_slot_];
+    const auto wait_start = clock::now();
+    if (mode_ == PrepMode::Pipelined) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [&]() { return slot.ready; });
+    } else {
+        prepare(slot, next_frame_++);
+    }
+    const auto run_start = clock::now();
+    session_.run(*slot.context);
+    const auto run_end = clock::now();
+
+    end_to_end_.record(duration_ns(run_end - slot.prep_start));
+    prep_ns_ += slot.prep_ns;
+    if (mode_ == PrepMode::Pipelined) {
+        stall_ns_ += duration_ns(run_start - wait_start);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slot.ready = false;
+        }
+        changed_.notify_all();
+        next_slot_ = (next_slot_ + 1) % slots_.size();
+    }
+    ++frames_;
+}
+
+void InputPipeline::reset_stats() {
+    end_to_end_.reset();
+    prep_ns_ = 0;
+    stall_ns_ = 0;
+    frames_ = 0;
+}
+
+double InputPipeline::prep_mean_us() const {
+    return frames_ > 0 ? static_cast<double>(prep_ns_) / static_cast<double>(frames_) / 1000.0 : -1.0;
+}
+
+double InputPipeline::stall_mean_us() const {
+    if (mode_ != PrepMode::Pipelined) {
+        return -1.0;
+    }
+    return frames_ > 0 ? static_cast<double>(stall_ns_) / static_cast<double>(frames_) / 1000.0 : -1.0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "inference_session.hpp"
+#include "latency_histogram.hpp"
+
+// How the inputs of each measured inference are produced (--prep)
+enum class PrepMode {
+    None,       // Once at setup; runs reuse the bound inputs (default)
+    Serial,     // Before every run, on the benchmark thread
+    Pipelined,  // On a producer thread, into a second buffer while the current run executes
+};
+
+const char *prep_mode_name(PrepMode mode);
+bool parse_prep_mode(const std::string &text, PrepMode &mode);
+
+// Per-inference input preparation as a stand-in for decoding and resizing a
+// frame or loading the next sample: generated inputs are regenerated with a
+// fresh seed, file-backed inputs copy their next dataset sample out of the
+// mapped file, `passes` times each. Prepared inputs go into buffers of their
+// own with their own bindings on the session (two in Pipelined mode, so the
+// producer fills one while the other is being inferred).
+//
+// The producer thread is started by the benchmark thread and inherits its CPU
+// affinity. It blocks while both buffers are full, so an idle producer costs
+// no CPU time.
+class InputPipeline {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Copies the session's inputs into the buffers and performs one priming run
+    // per buffer (which throws like any run). seed 0 = random.
+    InputPipeline(InferenceSession &session, PrepMode mode, int passes, uint64_t seed);
+    ~InputPipeline();
+
+    InputPipeline(const InputPipeline &) = delete;
+    InputPipeline &operator=(const InputPipeline &) = delete;
+
+    // One inference on freshly prepared inputs
+    void run();
+
+    // Clear the statistics below (start of the measurement window)
+    void reset_stats();
+
+    // Per inference since reset_stats(): latency from the start of its input
+    // preparation to the end of its run, preparation time, and how long the
+    // run waited for its inputs (Pipelined mode only)
+    const LatencyHistogram &end_to_end() const { return end_to_end_; }
+    double prep_mean_us() const;
+    double stall_mean_us() const;
+
+private:
+    struct Slot {
+        std::vector<ModelInput> inputs;  // Own buffers, one tensor each
+        std::unique_ptr<RunContext> context;
+        bool ready = false;              // Prepared and not yet inferred
+        clock::time_point prep_start;
+        uint64_t prep_ns = 0;
+    };
+
+    void prepare(Slot &slot, uint64_t frame);
+    void run_producer();
+
+    InferenceSession &session_;
+    PrepMode mode_;
+    int passes_;
+    uint64_t seed_;
+    std::vector<Slot> slots_;
+    size_t next_slot_ = 0;
+    uint64_t next_frame_ = 0;  // Serial mode; the producer counts its own
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool stopping_ = false;
+    std::thread producer_;
+
+    LatencyHistogram end_to_end_;
+    uint64_t prep_ns_ = 0;
+    uint64_t stall_ns_ = 0;
+    uint64_t frames_ = 0;
+};
@@ -0,0 +1,285 @@
+#include "interference.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include "config.hpp"
+#include "cpu_affinity.hpp"
+#include "inference_session.hpp"
+#include "rate_pacer.hpp"
+
+namespace {
+    // Split a trailing "@MASK" off text
+    bool split_cpu_mask(std::string &text, uint64_t &mask) {
+        const size_t at = text.rfind('@');
+        if (at == std::string::npos) {
+            return true;
+        }
+        const std::string mask_text = text.substr(at + 1);
+        text.erase(at);
+        return parse_cpu_mask(mask_text, mask) && mask != 0;
+    }
+
+    // Split a trailing ":VALUE" off text; value stays untouched without one
+    bool split_value(std::string &text, double &value) {
+        const size_t colon = text.rfind(':');
+        if (colon == std::string::npos) {
+            return true;
+        }
+        const std::string value_text = text.substr(colon + 1);
+        text.erase(colon);
+        char *end = nullptr;
+        value = std::strtod(value_text.c_str(), &end);
+        return !value_text.empty() && *end == '\0' && std::isfinite(value) && value > 0.0;
+    }
+
+    const char *stressor_name(InterferenceSource::Kind kind) {
+        return kind == InterferenceSource::Kind::Cpu ? "cpu" : "membw";
+    }
+
+    std::string source_name(const InterferenceSource &source) {
+        return source.kind == InterferenceSource::Kind::Model ? source.model : stressor_name(source.kind);
+    }
+
+    // All CPUs of the device, from the cpufreq policies
+    uint64_t all_cpus() {
+        uint64_t mask = 0;
+        for (const uint64_t cluster: read_cpu_clusters()) {
+            mask |= cluster;
+        }
+        return mask;
+    }
+}
+
+bool parse_co_run(const std::string &text, InterferenceSource &source) {
+    source = InterferenceSource();
+    source.kind = InterferenceSource::Kind::Model;
+    std::string model = text;
+    if (!split_cpu_mask(model, source.cpu_mask) || !split_value(model, source.rate_hz) || model.empty() ||
+        (source.rate_hz > 0.0 && !valid_request_rate(source.rate_hz))) {
+        return false;
+    }
+    source.model = model;
+    return true;
+}
+
+bool parse_stressor(const std::string &text, InterferenceSource &source) {
+    source = InterferenceSource();
+    std::string kind = text;
+    double threads = 1.0;
+    if (!split_cpu_mask(kind, source.cpu_mask) || !split_value(kind, threads) ||
+        threads > static_cast<double>(INT_MAX) || threads != static_cast<double>(static_cast<int>(threads))) {
+        return false;
+    }
+    source.threads = static_cast<int>(threads);
+    if (kind == "cpu") {
+        source.kind = InterferenceSource::Kind::Cpu;
+    } else if (kind == "membw") {
+        source.kind = InterferenceSource::Kind::MemoryBandwidth;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string format_interference(const std::vector<InterferenceSource> &sources) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const InterferenceSource &source = sources[i];
+        oss << (i > 0 ? ";" : "") << source_name(source);
+        if (source.kind == InterferenceSource::Kind::Model) {
+            if (source.rate_hz > 0.0) {
+                oss << ":" << source.rate_hz;
+            }
+        } else {
+            oss << ":" << source.threads;
+        }
+        if (source.cpu_mask != 0) {
+            oss << "@" << format_cpu_mask(source.cpu_mask);
+        }
+    }
+    return oss.str();
+}
+
+BackgroundLoad::BackgroundLoad(std::vector<InterferenceSource> sources, uint64_t primary_cpu_mask)
+    : sources_(std::move(sources)) {
+    // Stay off the benchmarked model's CPUs unless there is nothing else
+    if (primary_cpu_mask != 0) {
+        default_cpu_mask_ = all_cpus() & ~primary_cpu_mask;
+    }
+}
+
+BackgroundLoad::~BackgroundLoad() {
+    stop();
+}
+
+bool BackgroundLoad::start(std::string &error) {
+    stopping_.store(false);
+    for (const InterferenceSource &source: sources_) {
+        const int threads = source.kind == InterferenceSource::Kind::Model ? 1 : source.threads;
+        for (int i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+            workers_.back()->source = &source;
+        }
+    }
+    for (auto &worker: workers_) {
+        Worker *own = worker.get();
+        own->thread = std::thread([this, own]() { run_worker(*own); });
+    }
+
+    // Co-run sessions load in parallel; the benchmark waits for all of them
+    const auto deadline = clock::now() + std::chrono::seconds(Config::INTERFERENCE_START_TIMEOUT_SECONDS);
+    for (auto &worker: workers_) {
+        while (!worker->ready.load(std::memory_order_acquire) && clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(Config::INTERFERENCE_POLL_MS));
+        }
+        if (!worker->ready.load(std::memory_order_acquire)) {
+            error = source_name(*worker->source) + " did not start within " +
+                    std::to_string(Config::INTERFERENCE_START_TIMEOUT_SECONDS) + "s";
+        } else if (!worker->error.empty()) {
+            error = source_name(*worker->source) + ": " + worker->error;
+        }
+        if (!error.empty()) {
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void BackgroundLoad::begin_window() {
+    window_start_ = clock::now();
+    for (auto &worker: workers_) {
+        worker->window_start_work = worker->work.load(std::memory_order_relaxed);
+    }
+}
+
+void BackgroundLoad::stop() {
+    if (workers_.empty() || stopping_.exchange(true)) {
+        return;
+    }
+    window_seconds_ = std::chrono::duration<double>(clock::now() - window_start_).count();
+    for (auto &worker: workers_) {
+        worker->window_work = worker->work.load(std::memory_order_relaxed) - worker->window_start_work;
+    }
+    for (auto &worker: workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::string BackgroundLoad::achieved_load() const {
+    if (window_seconds_ <= 0.0) {
+        return "";
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        const InterferenceSource &source = sources_[i];
+        uint64_t work = 0;
+        for (const auto &worker: workers_) {
+            if (worker->source == &source) {
+                work += worker->window_work;
+            }
+        }
+        const double per_second = static_cast<double>(work) / window_seconds_;
+        oss << (i > 0 ? ";" : "") << source_name(source) << "=";
+        switch (source.kind) {
+            case InterferenceSource::Kind::Model: oss << per_second << "Hz"; break;
+            case InterferenceSource::Kind::Cpu: oss << per_second / 1e9 << "Gop/s"; break;
+            case InterferenceSource::Kind::MemoryBandwidth: oss << per_second / 1e9 << "GB/s"; break;
+        }
+    }
+    return oss.str();
+}
+
+bool BackgroundLoad::wait_until(clock::time_point scheduled) const {
+    // Slept in slices so that stop() is not held up by a low-rate schedule
+    const auto slice = std::chrono::milliseconds(Config::INTERFERENCE_POLL_MS);
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        const auto now = clock::now();
+        if (now >= scheduled) {
+            return true;
+        }
+        sleep_until_absolute(std::min(scheduled, now + slice));
+    }
+    return false;
+}
+
+void BackgroundLoad::run_worker(Worker &worker) {
+    const InterferenceSource &source = *worker.source;
+    std::string affinity_error;
+    if (!apply_cpu_affinity(source.cpu_mask != 0 ? source.cpu_mask : default_cpu_mask_, affinity_error)) {
+        worker.error = "CPU affinity: " + affinity_error;
+        worker.ready.store(true, std::memory_order_release);
+        return;
+    }
+
+    switch (source.kind) {
+        case InterferenceSource::Kind::Model: {
+            // Default session options: one intra-op thread, on this thread's CPUs
+            std::unique_ptr<InferenceSession> session;
+            try {
+                session = std::make_unique<InferenceSession>(source.model_path, SessionConfig(), InputConfig());
+            } catch (const std::exception &e) {
+                worker.error = e.what();
+                worker.ready.store(true, std::memory_order_release);
+                return;
+            }
+            worker.ready.store(true, std::memory_order_release);
+            std::unique_ptr<RatePacer> pacer;
+            if (source.rate_hz > 0.0) {
+                pacer = std::make_unique<RatePacer>(source.rate_hz, clock::now());
+            }
+            try {
+                while (!stopping_.load(std::memory_order_relaxed)) {
+                    if (pacer && !wait_until(pacer->advance())) {
+                        break;
+                    }
+                    session->run();
+                    worker.work.fetch_add(1, std::memory_order_relaxed);
+                }
+            } catch (const std::exception &e) {
+                // The load then ends early; achieved_load() shows it
+                worker.error = e.what();
+            }
+            break;
+        }
+        case InterferenceSource::Kind::Cpu: {
+            // Dependent multiply-adds: keeps one core's FP pipeline busy without memory traffic
+            double value = 1.0;
+            worker.ready.store(true, std::memory_order_release);
+            while (!stopping_.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < Config::STRESS_CPU_BATCH; ++i) {
+                    value = value * 0.999999 + 1e-6;
+                }
+                worker.work.fetch_add(2 * static_cast<uint64_t>(Config::STRESS_CPU_BATCH),
+                                      std::memory_order_relaxed);
+            }
+            volatile double sink = value;
+            (void) sink;
+            break;
+        }
+        case InterferenceSource::Kind::MemoryBandwidth: {
+            // Copy one half of the buffer over the other; faulted in before ready
+            const size_t half = static_cast<size_t>(Config::STRESS_MEMBW_BUFFER_MB) * 1024 * 1024 / 2;
+            std::vector<char> buffer(2 * half, 1);
+            worker.ready.store(true, std::memory_order_release);
+            bool forward = true;
+            while (!stopping_.load(std::memory_order_relaxed)) {
+                char *from = buffer.data() + (forward ? 0 : half);
+                char *to = buffer.data() + (forward ? half : 0);
+                std::memcpy(to, from, half);
+                forward = !forward;
+                worker.work.fetch_add(half, std::memory_order_relaxed);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One source of background load next to the benchmarked model (--co-run, --stress)
+struct InterferenceSource {
+    enum class Kind {
+        Model,            // Another ONNX model running its own inference loop
+        Cpu,              // Arithmetic spin loop per thread
+        MemoryBandwidth,  // Streaming copies through a buffer far larger than the caches
+    };
+
+    Kind kind = Kind::Cpu;
+    std::string model;       // Kind::Model: relative to model_base_path(), as reported
+    std::string model_path;  // Kind::Model: full path on the device
+    double rate_hz = 0.0;    // Kind::Model: request rate; 0 = back to back
+    int threads = 1;         // Stressor threads (a co-run model runs one inference thread)
+    uint64_t cpu_mask = 0;   // 0 = the CPUs the benchmarked model is not pinned to (all if unpinned)
+};
+
+// Parse "MODEL[:HZ][@MASK]" (--co-run) or "cpu|membw[:THREADS][@MASK]" (--stress).
+// Returns false on malformed input.
+bool parse_co_run(const std::string &text, InterferenceSource &source);
+bool parse_stressor(const std::string &text, InterferenceSource &source);
+
+// "<model>[:<Hz>]@<mask>;cpu:<threads>@<mask>;..." for the CSV and the console
+std::string format_interference(const std::vector<InterferenceSource> &sources);
+
+// Background threads that run the interference sources from start() to stop(),
+// each pinned to its source's CPUs. Co-run sessions are built on their own
+// (pinned) thread, so ONNX Runtime's threads inherit its CPUs as in the driver,
+// with default session options and generated inputs.
+// The work done between begin_window() and stop() is reported per source.
+class BackgroundLoad {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // primary_cpu_mask: the benchmarked model's CPUs, which sources without a
+    // mask of their own stay off
+    BackgroundLoad(std::vector<InterferenceSource> sources, uint64_t primary_cpu_mask);
+    ~BackgroundLoad();
+
+    BackgroundLoad(const BackgroundLoad &) = delete;
+    BackgroundLoad &operator=(const BackgroundLoad &) = delete;
+
+    // Start every thread and wait until each has done one unit of work (co-run
+    // sessions are built by then). On failure stops what was started, returns
+    // false and sets error.
+    bool start(std::string &error);
+
+    // Start counting the work reported by achieved_load() (measurement window)
+    void begin_window();
+
+    void stop();
+
+    // Work per source between begin_window() and stop(), e.g.
+    // "zi_t/audio.onnx:49.8Hz;cpu:2x1.02Gop/s;membw:1x3.41GB/s"
+    std::string achieved_load() const;
+
+private:
+    struct Worker {
+        const InterferenceSource *source = nullptr;
+        std::thread thread;
+        std::atomic<uint64_t> work{0};  // Inferences, arithmetic ops or bytes copied
+        std::atomic<bool> ready{false};
+        std::string error;              // Set before ready when the worker failed
+        uint64_t window_start_work = 0;
+        uint64_t window_work = 0;
+    };
+
+    void run_worker(Worker &worker);
+    // Sleep until scheduled; false if stop() was called first
+    bool wait_until(clock::time_point scheduled) const;
+
+    std::vector<InterferenceSource> sources_;
+    uint64_t default_cpu_mask_ = 0;
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::atomic<bool> stopping_{false};
+    clock::time_point window_start_;
+    double window_seconds_ = 0.0;
+};
@@ -0,0 +1,494 @@
+#include "job_server.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "benchmark_job.hpp"
+#include "config.hpp"
+#include "json.hpp"
+#include "results_csv.hpp"
+#include "runner_paths.hpp"
+#include "session_cache.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+
+    // Bind and listen on "tcp:PORT" (loopback only; reach it with adb forward),
+    // "unix:PATH" or "unix:@NAME" (abstract namespace, adb forward localabstract:NAME)
+    int open_listener(const std::string &endpoint, std::string &error) {
+        int fd = -1;
+        if (endpoint.compare(0, 4, "tcp:") == 0) {
+            char *end = nullptr;
+            const long port = std::strtol(endpoint.c_str() + 4, &end, 10);
+            if (endpoint.size() == 4 || *end != '\0' || port <= 0 || port > 65535) {
+                error = "Invalid TCP port in " + endpoint;
+                return -1;
+            }
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                error = std::strerror(errno);
+                return -1;
+            }
+            const int reuse = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+                error = std::strerror(errno);
+                close(fd);
+                return -1;
+            }
+        } else {
+            const std::string path = endpoint.substr(5);
+            sockaddr_un address{};
+            if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                error = "Invalid socket path in " + endpoint;
+                return -1;
+            }
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                error = std::strerror(errno);
+                return -1;
+            }
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path.data(), path.size());
+            if (path[0] == '@') {
+                address.sun_path[0] = '\0';
+            } else {
+                unlink(path.c_str());  // Left over from a previous server
+            }
+            const socklen_t length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() +
+                                                            (path[0] == '@' ? 0 : 1));
+            if (bind(fd, reinterpret_cast<const sockaddr *>(&address), length) != 0) {
+                error = std::strerror(errno);
+                close(fd);
+                return -1;
+            }
+        }
+        if (listen(fd, Config::SERVER_LISTEN_BACKLOG) != 0) {
+            error = std::strerror(errno);
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // One client connection: newline-delimited JSON in both directions. A client
+    // that goes away mid-job only stops receiving events; the job runs to the end.
+    class Connection {
+    public:
+        explicit Connection(int fd) : fd_(fd) {}
+        ~Connection() { close(fd_); }
+
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+
+        bool read_line(std::string &line) {
+            for (;;) {
+                const size_t newline = buffer_.find('\n');
+                if (newline != std::string::npos) {
+                    line = buffer_.substr(0, newline);
+                    buffer_.erase(0, newline + 1);
+                    return true;
+                }
+                if (buffer_.size() > MAX_REQUEST_BYTES) {
+                    return false;
+                }
+                char chunk[4096];
+                const ssize_t received = recv(fd_, chunk, sizeof(chunk), 0);
+                if (received < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (received <= 0) {
+                    return false;
+                }
+                buffer_.append(chunk, static_cast<size_t>(received));
+            }
+        }
+
+        void send(const JsonValue &event) {
+            if (!connected_) {
+                return;
+            }
+            const std::string text = event.dump() + "\n";
+            size_t sent = 0;
+            while (sent < text.size()) {
+                const ssize_t written = ::send(fd_, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    connected_ = false;
+                    return;
+                }
+                sent += static_cast<size_t>(written);
+            }
+        }
+
+    private:
+        int fd_;
+        bool connected_ = true;
+        std::string buffer_;
+    };
+
+    JsonValue make_event(const char *name, const JsonValue &id) {
+        JsonValue event = JsonValue::object();
+        event.set("event", JsonValue(std::string(name)));
+        if (!id.is_null()) {
+            event.set("id", id);
+        }
+        return event;
+    }
+
+    // Copies console output to the real stream and sends every complete line
+    // to the client as a "log" event, so scripts can keep parsing RESULT_FILE=...
+    class LogRelay : public std::streambuf {
+    public:
+        LogRelay(std::ostream &stream, const char *name, Connection &connection, const JsonValue &id)
+            : stream_(stream), console_(stream.rdbuf()), name_(name), connection_(connection), id_(id) {
+            stream_.rdbuf(this);
+        }
+
+        ~LogRelay() override {
+            if (!line_.empty()) {
+                flush_line();
+            }
+            stream_.rdbuf(console_);
+        }
+
+        LogRelay(const LogRelay &) = delete;
+        LogRelay &operator=(const LogRelay &) = delete;
+
+    protected:
+        int overflow(int c) override {
+            if (c == traits_type::eof()) {
+                return traits_type::not_eof(c);
+            }
+            console_->sputc(static_cast<char>(c));
+            if (c == '\n') {
+                flush_line();
+            } else {
+                line_.push_back(static_cast<char>(c));
+            }
+            return c;
+        }
+
+        int sync() override {
+            return console_->pubsync();
+        }
+
+    private:
+        void flush_line() {
+            JsonValue event = make_event("log", id_);
+            event.set("stream", JsonValue(std::string(name_)));
+            event.set("line", JsonValue(line_));
+            connection_.send(event);
+            line_.clear();
+        }
+
+        std::ostream &stream_;
+        std::streambuf *console_;
+        const char *name_;
+        Connection &connection_;
+        const JsonValue &id_;
+        std::string line_;
+    };
+
+    std::string base64_encode(const std::string &data) {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        encoded.reserve((data.size() + 2) / 3 * 4);
+        for (size_t i = 0; i < data.size(); i += 3) {
+            const size_t remaining = data.size() - i;
+            uint32_t triple = static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << 16;
+            if (remaining > 1) {
+                triple |= static_cast<uint32_t>(static_cast<unsigned char>(data[i + 1])) << 8;
+            }
+            if (remaining > 2) {
+                triple |= static_cast<uint32_t>(static_cast<unsigned char>(data[i + 2]));
+            }
+            encoded.push_back(ALPHABET[(triple >> 18) & 0x3f]);
+            encoded.push_back(ALPHABET[(triple >> 12) & 0x3f]);
+            encoded.push_back(remaining > 1 ? ALPHABET[(triple >> 6) & 0x3f] : '=');
+            encoded.push_back(remaining > 2 ? ALPHABET[triple & 0x3f] : '=');
+        }
+        return encoded;
+    }
+
+    // Command-line value of a JSON number or string
+    std::string argument_text(const JsonValue &value) {
+        return value.is_string() ? value.as_string() : value.dump();
+    }
+
+    // Turn a job into the arguments of the command line, so that it goes through
+    // the same parsing and validation as a direct invocation
+    bool job_arguments(const JsonValue &job, std::vector<std::string> &args, std::string &error) {
+        if (!job.get("model").is_string()) {
+            error = "Job needs a \"model\"";
+            return false;
+        }
+        args = {"onnx_runner", job.get("model").as_string()};
+        for (const char *phase: {"warmup", "silence", "measurement"}) {
+            if (!job.get(phase).is_number()) {
+                error = std::string("Job needs a number of seconds for \"") + phase + "\"";
+                return false;
+            }
+            args.push_back(argument_text(job.get(phase)));
+        }
+
+        const JsonValue &options = job.get("options");
+        if (options.is_array()) {
+            for (const auto &item: options.items()) {
+                if (!item.is_string()) {
+                    error = "\"options\" must be strings";
+                    return false;
+                }
+                args.push_back(item.as_string());
+            }
+        } else if (options.is_object()) {
+            for (const auto &member: options.members()) {
+                const std::string name = "--" + member.first;
+                if (member.second.is_bool()) {
+                    if (member.second.as_bool()) {
+                        args.push_back(name);
+                    }
+                } else if (member.second.is_array()) {
+                    // Repeatable options, e.g. "input-file": ["a=a.npy", "b=b.npy"]
+                    for (const auto &item: member.second.items()) {
+                        args.push_back(name + "=" + argument_text(item));
+                    }
+                } else {
+                    args.push_back(name + "=" + argument_text(member.second));
+                }
+            }
+        } else if (!options.is_null()) {
+            error = "\"options\" must be an array or an object";
+            return false;
+        }
+
+        // Every job uses the server's session cache, which is sized at --serve
+        for (size_t i = 5; i < args.size(); ++i) {
+            const std::string name = args[i].substr(0, args[i].find('='));
+            if (name == "--session-cache" || name == "--session-cache-mb") {
+                error = name + " applies to the server (--serve), not to a job";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Result files of a finished window that exist on the device
+    JsonValue window_files(const BenchmarkCase &bench_case) {
+        JsonValue files = JsonValue::array();
+        for (const std::string *path: {&bench_case.batterystats_file, &bench_case.placement_file,
+                                       &bench_case.profile_file, &bench_case.telemetry_file,
+                                       &bench_case.workers_file, &bench_case.iteration_log_file}) {
+            std::error_code ec;
+            if (!path->empty() && fs::exists(*path, ec)) {
+                files.push_back(JsonValue(*path));
+            }
+        }
+        return files;
+    }
+
+    // Cache contents and activity, for "done" and "status"
+    void set_cache_stats(JsonValue &event, const SessionCache &session_cache) {
+        const SessionCacheStats &stats = session_cache.stats();
+        JsonValue cache = JsonValue::object();
+        cache.set("entries", JsonValue(static_cast<double>(stats.entries)));
+        cache.set("capacity", JsonValue(static_cast<double>(session_cache.capacity())));
+        cache.set("resident_kb", JsonValue(static_cast<double>(stats.resident_kb)));
+        cache.set("budget_kb", JsonValue(static_cast<double>(session_cache.budget_kb())));
+        cache.set("hits", JsonValue(static_cast<double>(stats.hits)));
+        cache.set("misses", JsonValue(static_cast<double>(stats.misses)));
+        cache.set("evictions", JsonValue(static_cast<double>(stats.evictions)));
+        cache.set("setup_saved_ms", JsonValue(stats.setup_saved_ms));
+        event.set("cached_sessions", JsonValue(static_cast<double>(stats.entries)));
+        event.set("session_cache", cache);
+    }
+
+    void run_job(const JsonValue &request, Connection &connection, SessionCache &session_cache) {
+        const JsonValue &id = request.get("id");
+        std::vector<std::string> args;
+        std::string error;
+        BenchmarkOptions options;
+        BenchmarkJob job;
+        if (job_arguments(request, args, error)) {
+            std::vector<char *> argv;
+            for (auto &arg: args) {
+                argv.push_back(&arg[0]);
+            }
+            if (parse_options(static_cast<int>(argv.size()), argv.data(), options, error)) {
+                prepare_benchmark_job(options, true, job, error);
+            }
+        }
+        if (!error.empty()) {
+            JsonValue event = make_event("error", id);
+            event.set("message", JsonValue(error));
+            connection.send(event);
+            std::cerr << "  ✗ Rejected job: " << error << "\n";
+            return;
+        }
+        for (auto &bench_case: job.plan) {
+            bench_case.session_cache = &session_cache;
+        }
+
+        JsonValue accepted = make_event("accepted", id);
+        accepted.set("timestamp", JsonValue(job.timestamp));
+        accepted.set("windows", JsonValue(static_cast<double>(job.plan.size())));
+        connection.send(accepted);
+
+        std::ostringstream header;
+        write_performance_csv_header(header);
+        JsonValue files = JsonValue::array();
+        bool ok = false;
+        {
+            LogRelay stdout_relay(std::cout, "stdout", connection, id);
+            LogRelay stderr_relay(std::cerr, "stderr", connection, id);
+            print_benchmark_job(job);
+            ok = run_benchmark_job(job, [&](const BenchmarkResult &result) {
+                std::ostringstream row;
+                write_performance_csv_row(row, job.timestamp, result);
+                JsonValue event = make_event("window", id);
+                event.set("index", JsonValue(static_cast<double>(result.config_index)));
+                event.set("model", JsonValue(result.bench_case.model_filename));
+                event.set("csv_header", JsonValue(header.str()));
+                event.set("csv_row", JsonValue(row.str()));
+                const JsonValue result_files = window_files(result.bench_case);
+                event.set("files", result_files);
+                connection.send(event);
+                for (const auto &file: result_files.items()) {
+                    files.push_back(file);
+                }
+            });
+        }
+
+        JsonValue done = make_event("done", id);
+        done.set("ok", JsonValue(ok));
+        done.set("performance_file", JsonValue(job.performance_file));
+        done.set("files", files);
+        set_cache_stats(done, session_cache);
+        connection.send(done);
+    }
+
+    // Send a result file, restricted to the measurements directory
+    void fetch_file(const JsonValue &request, Connection &connection) {
+        const JsonValue &id = request.get("id");
+        std::string error;
+        std::error_code ec;
+        const fs::path base = fs::weakly_canonical(measurements_dir(), ec);
+        const fs::path path = fs::weakly_canonical(request.get("path").is_string()
+                                                       ? request.get("path").as_string() : "", ec);
+        const std::string base_text = base.string() + "/";
+        std::string data;
+        if (ec || path.string().compare(0, base_text.size(), base_text) != 0) {
+            error = "Only files under " + measurements_dir() + " can be fetched";
+        } else {
+            std::ifstream file(path, std::ios::binary);
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            if (!file) {
+                error = "Cannot read " + path.string();
+            }
+            data = contents.str();
+        }
+        if (!error.empty()) {
+            JsonValue event = make_event("error", id);
+            event.set("message", JsonValue(error));
+            connection.send(event);
+            return;
+        }
+        JsonValue event = make_event("file", id);
+        event.set("path", JsonValue(path.string()));
+        event.set("size", JsonValue(static_cast<double>(data.size())));
+        event.set("data", JsonValue(base64_encode(data)));
+        connection.send(event);
+    }
+}
+
+bool serve_jobs(const ServeOptions &options) {
+    std::string error;
+    const int listener = open_listener(options.endpoint, error);
+    if (listener < 0) {
+        std::cerr << "Error: Cannot listen on " << options.endpoint << ": " << error << "\n";
+        return false;
+    }
+    std::cout << "=== onnx_runner server ===\n";
+    std::cout << "Listening on " << options.endpoint << " (session cache: " << options.session_cache_size
+            << ", budget " << options.session_cache_budget_mb << " MB)\n";
+    std::cout << "SERVER_READY=" << options.endpoint << "\n" << std::flush;  // For script parsing
+
+    SessionCache session_cache(options.session_cache_size,
+                               static_cast<int64_t>(options.session_cache_budget_mb) * 1024);
+    size_t jobs = 0;
+    bool shutdown = false;
+    while (!shutdown) {
+        const int client = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: accept failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+        Connection connection(client);
+        std::string line;
+        while (!shutdown && connection.read_line(line)) {
+            if (line.empty()) {
+                continue;
+            }
+            JsonValue request;
+            if (!parse_json(line, request, error) || !request.is_object()) {
+                JsonValue event = make_event("error", JsonValue());
+                event.set("message", JsonValue("Invalid request: " + (error.empty() ? "not an object" : error)));
+                connection.send(event);
+                continue;
+            }
+            const std::string command = request.get("command").is_string()
+                                            ? request.get("command").as_string() : "run";
+            if (command == "run") {
+                ++jobs;
+                run_job(request, connection, session_cache);
+                std::cout << std::flush;
+            } else if (command == "fetch") {
+                fetch_file(request, connection);
+            } else if (command == "status") {
+                JsonValue event = make_event("status", request.get("id"));
+                event.set("jobs", JsonValue(static_cast<double>(jobs)));
+                set_cache_stats(event, session_cache);
+                connection.send(event);
+            } else if (command == "shutdown") {
+                connection.send(make_event("bye", request.get("id")));
+                shutdown = true;
+            } else {
+                JsonValue event = make_event("error", request.get("id"));
+                event.set("message", JsonValue("Unknown command: " + command));
+                connection.send(event);
+            }
+        }
+    }
+    session_cache.clear();
+    close(listener);
+    if (options.endpoint.compare(0, 5, "unix:") == 0 && options.endpoint.size() > 5 && options.endpoint[5] != '@') {
+        unlink(options.endpoint.c_str() + 5);
+    }
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "options.hpp"
+
+// Long-lived runner (--serve): listens on a local socket and runs one job at a
+// time, so that a sweep pays for process startup, dynamic linking and model
+// loading once instead of per data point.
+//
+// Requests and responses are JSON objects, one per line. A job
+//   {"id": 1, "model": "zi_t/model.onnx", "warmup": 6, "silence": 6,
+//    "measurement": 48, "options": ["--intra-op-threads=4"]}
+// takes the same model argument and options as the command line ("options" may
+// also be an object such as {"intra-op-threads": 4, "cold-load": true}). The
+// server answers with "accepted", then "log" events for every console line,
+// a "window" event with the performance CSV row of each finished window, and
+// finally "done" (or "error"). {"command": "fetch", "path": ...} returns a file
+// under measurements_dir() base64-encoded; "status" and "shutdown" are the
+// other commands. Warm sessions are kept in a SessionCache between jobs.
+//
+// Returns false if the endpoint cannot be opened.
+bool serve_jobs(const ServeOptions &options);
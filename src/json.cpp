@@ -0,0 +1,391 @@
+#include "json.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    class JsonParser {
+    public:
+        explicit JsonParser(const std::string &text) : text_(text) {}
+
+        bool parse(JsonValue &value, std::string &error) {
+            if (!parse_value(value, 0)) {
+                error = error_ + " at offset " + std::to_string(pos_);
+                return false;
+            }
+            skip_whitespace();
+            if (pos_ != text_.size()) {
+                error = "Trailing characters at offset " + std::to_string(pos_);
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr int MAX_DEPTH = 256;
+
+        void skip_whitespace() {
+            while (pos_ < text_.size() &&
+                   (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+                ++pos_;
+            }
+        }
+
+        bool fail(const char *message) {
+            error_ = message;
+            return false;
+        }
+
+        bool consume_literal(const char *literal) {
+            const std::string expected(literal);
+            if (text_.compare(pos_, expected.size(), expected) != 0) {
+                return fail("Invalid literal");
+            }
+            pos_ += expected.size();
+            return true;
+        }
+
+        bool parse_value(JsonValue &value, int depth) {
+            if (depth > MAX_DEPTH) {
+                return fail("Nesting too deep");
+            }
+            skip_whitespace();
+            if (pos_ >= text_.size()) {
+                return fail("Unexpected end of input");
+            }
+
+            const char c = text_[pos_];
+            if (c == '{') {
+                return parse_object(value, depth);
+            }
+            if (c == '[') {
+                return parse_array(value, depth);
+            }
+            if (c == '"') {
+                std::string text;
+                if (!parse_string(text)) {
+                    return false;
+                }
+                value = JsonValue(std::move(text));
+                return true;
+            }
+            if (c == 't') {
+                value = JsonValue(true);
+                return consume_literal("true");
+            }
+            if (c == 'f') {
+                value = JsonValue(false);
+                return consume_literal("false");
+            }
+            if (c == 'n') {
+                value = JsonValue();
+                return consume_literal("null");
+            }
+            return parse_number(value);
+        }
+
+        bool parse_object(JsonValue &value, int depth) {
+            value = JsonValue::object();
+            ++pos_;  // '{'
+            skip_whitespace();
+            if (pos_ < text_.size() && text_[pos_] == '}') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                skip_whitespace();
+                if (pos_ >= text_.size() || text_[pos_] != '"') {
+                    return fail("Expected object key");
+                }
+                std::string key;
+                if (!parse_string(key)) {
+                    return false;
+                }
+                skip_whitespace();
+                if (pos_ >= text_.size() || text_[pos_] != ':') {
+                    return fail("Expected ':'");
+                }
+                ++pos_;
+                JsonValue member;
+                if (!parse_value(member, depth + 1)) {
+                    return false;
+                }
+                value.set(key, std::move(member));
+                skip_whitespace();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                if (pos_ < text_.size() && text_[pos_] == '}') {
+                    ++pos_;
+                    return true;
+                }
+                return fail("Expected ',' or '}'");
+            }
+        }
+
+        bool parse_array(JsonValue &value, int depth) {
+            value = JsonValue::array();
+            ++pos_;  // '['
+            skip_whitespace();
+            if (pos_ < text_.size() && text_[pos_] == ']') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                JsonValue item;
+                if (!parse_value(item, depth + 1)) {
+                    return false;
+                }
+                value.push_back(std::move(item));
+                skip_whitespace();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                if (pos_ < text_.size() && text_[pos_] == ']') {
+                    ++pos_;
+                    return true;
+                }
+                return fail("Expected ',' or ']'");
+            }
+        }
+
+        static void append_utf8(std::string &out, uint32_t code_point) {
+            if (code_point < 0x80) {
+                out += static_cast<char>(code_point);
+            } else if (code_point < 0x800) {
+                out += static_cast<char>(0xC0 | (code_point >> 6));
+                out += static_cast<char>(0x80 | (code_point & 0x3F));
+            } else if (code_point < 0x10000) {
+                out += static_cast<char>(0xE0 | (code_point >> 12));
+                out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code_point & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code_point >> 18));
+                out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code_point & 0x3F));
+            }
+        }
+
+        bool parse_hex4(uint32_t &code_unit) {
+            if (pos_ + 4 > text_.size()) {
+                return fail("Truncated \\u escape");
+            }
+            code_unit = 0;
+            for (int i = 0; i < 4; ++i) {
+                const char h = text_[pos_++];
+                code_unit <<= 4;
+                if (h >= '0' && h <= '9') {
+                    code_unit |= static_cast<uint32_t>(h - '0');
+                } else if (h >= 'a' && h <= 'f') {
+                    code_unit |= static_cast<uint32_t>(h - 'a' + 10);
+                } else if (h >= 'A' && h <= 'F') {
+                    code_unit |= static_cast<uint32_t>(h - 'A' + 10);
+                } else {
+                    return fail("Invalid \\u escape");
+                }
+            }
+            return true;
+        }
+
+        bool parse_string(std::string &out) {
+            ++pos_;  // opening quote
+            while (pos_ < text_.size()) {
+                const char c = text_[pos_++];
+                if (c == '"') {
+                    return true;
+                }
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos_ >= text_.size()) {
+                    break;
+                }
+                const char escape = text_[pos_++];
+                switch (escape) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t code_point = 0;
+                        if (!parse_hex4(code_point)) {
+                            return false;
+                        }
+                        // Combine UTF-16 surrogate pairs
+                        if (code_point >= 0xD800 && code_point < 0xDC00 &&
+                            text_.compare(pos_, 2, "\\u") == 0) {
+                            pos_ += 2;
+                            uint32_t low = 0;
+                            if (!parse_hex4(low)) {
+                                return false;
+                            }
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        append_utf8(out, code_point);
+                        break;
+                    }
+                    default:
+                        return fail("Invalid escape sequence");
+                }
+            }
+            return fail("Unterminated string");
+        }
+
+        bool parse_number(JsonValue &value) {
+            const char *start = text_.c_str() + pos_;
+            char *end = nullptr;
+            const double number = std::strtod(start, &end);
+            if (end == start) {
+                return fail("Unexpected character");
+            }
+            pos_ += static_cast<size_t>(end - start);
+            value = JsonValue(number);
+            return true;
+        }
+
+        const std::string &text_;
+        size_t pos_ = 0;
+        std::string error_;
+    };
+
+    void dump_value(const JsonValue &value, std::ostringstream &out) {
+        switch (value.type()) {
+            case JsonValue::Type::Null:
+                out << "null";
+                break;
+            case JsonValue::Type::Bool:
+                out << (value.as_bool() ? "true" : "false");
+                break;
+            case JsonValue::Type::Number: {
+                const double number = value.as_number();
+                if (!std::isfinite(number)) {
+                    out << "null";
+                } else if (number == std::floor(number) && std::fabs(number) < 1e15) {
+                    out << static_cast<int64_t>(number);
+                } else {
+                    char buffer[32];
+                    std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+                    out << buffer;
+                }
+                break;
+            }
+            case JsonValue::Type::String:
+                out << '"' << json_escape(value.as_string()) << '"';
+                break;
+            case JsonValue::Type::Array: {
+                out << '[';
+                bool first = true;
+                for (const auto &item: value.items()) {
+                    if (!first) {
+                        out << ',';
+                    }
+                    first = false;
+                    dump_value(item, out);
+                }
+                out << ']';
+                break;
+            }
+            case JsonValue::Type::Object: {
+                out << '{';
+                bool first = true;
+                for (const auto &member: value.members()) {
+                    if (!first) {
+                        out << ',';
+                    }
+                    first = false;
+                    out << '"' << json_escape(member.first) << "\":";
+                    dump_value(member.second, out);
+                }
+                out << '}';
+                break;
+            }
+        }
+    }
+}
+
+JsonValue JsonValue::array() {
+    JsonValue value;
+    value.type_ = Type::Array;
+    return value;
+}
+
+JsonValue JsonValue::object() {
+    JsonValue value;
+    value.type_ = Type::Object;
+    return value;
+}
+
+const std::string &JsonValue::as_string() const {
+    static const std::string empty;
+    return is_string() ? string_ : empty;
+}
+
+void JsonValue::push_back(JsonValue value) {
+    items_.push_back(std::move(value));
+}
+
+const JsonValue &JsonValue::get(const std::string &key) const {
+    static const JsonValue null_value;
+    const auto it = members_.find(key);
+    return it == members_.end() ? null_value : it->second;
+}
+
+void JsonValue::set(const std::string &key, JsonValue value) {
+    members_[key] = std::move(value);
+}
+
+std::string JsonValue::dump() const {
+    std::ostringstream out;
+    dump_value(*this, out);
+    return out.str();
+}
+
+bool parse_json(const std::string &text, JsonValue &value, std::string &error) {
+    JsonParser parser(text);
+    return parser.parse(value, error);
+}
+
+bool parse_json_file(const std::string &path, JsonValue &value, std::string &error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "Could not open " + path;
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return parse_json(contents.str(), value, error);
+}
+
+std::string json_escape(const std::string &text) {
+    std::string out;
+    out.reserve(text.size());
+    for (const char c: text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Minimal JSON document model, enough for ONNX Runtime profile traces and
+// job descriptions. Numbers are stored as double.
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    JsonValue() = default;
+    explicit JsonValue(bool value) : type_(Type::Bool), bool_(value) {}
+    explicit JsonValue(double value) : type_(Type::Number), number_(value) {}
+    explicit JsonValue(std::string value) : type_(Type::String), string_(std::move(value)) {}
+
+    static JsonValue array();
+    static JsonValue object();
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+    bool is_bool() const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_array() const { return type_ == Type::Array; }
+    bool is_object() const { return type_ == Type::Object; }
+
+    bool as_bool(bool fallback = false) const { return is_bool() ? bool_ : fallback; }
+    double as_number(double fallback = 0.0) const { return is_number() ? number_ : fallback; }
+    const std::string &as_string() const;
+
+    // Array access
+    const std::vector<JsonValue> &items() const { return items_; }
+    void push_back(JsonValue value);
+
+    // Object access; get() returns a null value for missing keys
+    const std::map<std::string, JsonValue> &members() const { return members_; }
+    const JsonValue &get(const std::string &key) const;
+    bool has(const std::string &key) const { return members_.count(key) != 0; }
+    void set(const std::string &key, JsonValue value);
+
+    // Serialize to compact JSON text
+    std::string dump() const;
+
+private:
+    Type type_ = Type::Null;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> items_;
+    std::map<std::string, JsonValue> members_;
+};
+
+// Parse JSON text. On failure returns false and sets error.
+bool parse_json(const std::string &text, JsonValue &value, std::string &error);
+
+// Read and parse a JSON file
+bool parse_json_file(const std::string &path, JsonValue &value, std::string &error);
+
+// Escape a string for inclusion in JSON output (without surrounding quotes)
+std::string json_escape(const std::string &text);
@@ -0,0 +1,81 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (auto &bucket: counts_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_ns_.store(0, std::memory_order_relaxed);
+    sum_sq_ns_.store(0.0, std::memory_order_relaxed);
+    min_ns_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::min_ns() const {
+    return count() == 0 ? 0 : min_ns_.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean_ns() const {
+    const uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(sum_ns()) / static_cast<double>(n);
+}
+
+double LatencyHistogram::stddev_ns() const {
+    const uint64_t n = count();
+    if (n < 2) {
+        return 0.0;
+    }
+    const double mean = mean_ns();
+    const double sum_sq = sum_sq_ns_.load(std::memory_order_relaxed);
+    const double variance = (sum_sq - static_cast<double>(n) * mean * mean) /
+                            static_cast<double>(n - 1);
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile_ns(double percentile) const {
+    const uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const auto rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(n))));
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        cumulative += counts_[i].load(std::memory_order_relaxed);
+        if (cumulative >= rank) {
+            // Report the bucket midpoint, clamped to the exact observed range
+            const uint64_t lower = bucket_lower_bound(i);
+            const uint64_t midpoint = lower + (bucket_upper_bound(i) - lower) / 2;
+            return std::clamp(midpoint, min_ns(), max_ns());
+        }
+    }
+    return max_ns();
+}
+
+uint64_t LatencyHistogram::bucket_lower_bound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const size_t shift = index / SUB_BUCKET_COUNT - 1;
+    const size_t sub_bucket = index % SUB_BUCKET_COUNT;
+    return static_cast<uint64_t>(SUB_BUCKET_COUNT + sub_bucket) << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const size_t shift = index / SUB_BUCKET_COUNT - 1;
+    return bucket_lower_bound(index) + ((uint64_t{1} << shift) - 1);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size, lock-free latency histogram with HDR-style logarithmic buckets.
+//
+// Values below SUB_BUCKET_COUNT nanoseconds are stored exactly. Larger values
+// fall into one of SUB_BUCKET_COUNT linear sub-buckets per power of two, which
+// bounds the relative error of any reported percentile to 1/SUB_BUCKET_COUNT
+// (about 3%). record() never allocates and only uses relaxed atomics, so it
+// is safe to call from the timed loop and from several threads at once.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    // Record one latency sample in nanoseconds
+    void record(uint64_t value_ns) {
+        counts_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+
+        const double value = static_cast<double>(value_ns);
+        double sum_sq = sum_sq_ns_.load(std::memory_order_relaxed);
+        while (!sum_sq_ns_.compare_exchange_weak(sum_sq, sum_sq + value * value,
+                                                 std::memory_order_relaxed)) {
+        }
+
+        uint64_t current_min = min_ns_.load(std::memory_order_relaxed);
+        while (value_ns < current_min &&
+               !min_ns_.compare_exchange_weak(current_min, value_ns, std::memory_order_relaxed)) {
+        }
+        uint64_t current_max = max_ns_.load(std::memory_order_relaxed);
+        while (value_ns > current_max &&
+               !max_ns_.compare_exchange_weak(current_max, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Clear all recorded samples
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t min_ns() const;
+    uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+    double mean_ns() const;
+    double stddev_ns() const;
+
+    // Value at the given percentile (0-100), accurate to the bucket resolution
+    uint64_t percentile_ns(double percentile) const;
+
+private:
+    static size_t bucket_index(uint64_t value_ns) {
+        if (value_ns < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value_ns);
+        }
+        const unsigned magnitude = 63u - static_cast<unsigned>(__builtin_clzll(value_ns));
+        const unsigned shift = magnitude - SUB_BUCKET_BITS;
+        const size_t sub_bucket = static_cast<size_t>(value_ns >> shift) - SUB_BUCKET_COUNT;
+        return (static_cast<size_t>(shift) + 1) * SUB_BUCKET_COUNT + sub_bucket;
+    }
+
+    static uint64_t bucket_lower_bound(size_t index);
+    static uint64_t bucket_upper_bound(size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<double> sum_sq_ns_;
+    std::atomic<uint64_t> min_ns_;
+    std::atomic<uint64_t> max_ns_;
+};
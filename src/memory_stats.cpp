@@ -0,0 +1,96 @@
+#include "memory_stats.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    // Value of a "Name:   1234 kB" line in a /proc status buffer
+    int64_t status_value_kb(const char *status, const char *name) {
+        const char *line = std::strstr(status, name);
+        if (line == nullptr) {
+            return -1;
+        }
+        char *end = nullptr;
+        const long long value = std::strtoll(line + std::strlen(name), &end, 10);
+        return end == line + std::strlen(name) ? -1 : static_cast<int64_t>(value);
+    }
+}
+
+ProcessMemory read_process_memory() {
+    ProcessMemory memory;
+    const int fd = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return memory;
+    }
+    char status[4096];
+    size_t length = 0;
+    ssize_t count = 0;
+    while (length < sizeof(status) - 1 && (count = read(fd, status + length, sizeof(status) - 1 - length)) > 0) {
+        length += static_cast<size_t>(count);
+    }
+    close(fd);
+    status[length] = '\0';
+
+    memory.rss_kb = status_value_kb(status, "VmRSS:");
+    memory.hwm_kb = status_value_kb(status, "VmHWM:");
+    return memory;
+}
+
+bool reset_peak_rss() {
+    const int fd = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    const bool written = write(fd, "5", 1) == 1;
+    close(fd);
+    return written;
+}
+
+MemorySampler::MemorySampler(std::chrono::milliseconds interval)
+    : interval_(interval) {
+}
+
+MemorySampler::~MemorySampler() {
+    stop();
+}
+
+void MemorySampler::start() {
+    stopping_ = false;
+    thread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        do {
+            sample();
+        } while (!stop_requested_.wait_for(lock, interval_, [this]() { return stopping_; }));
+    });
+}
+
+void MemorySampler::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stop_requested_.notify_one();
+    thread_.join();
+    sample();  // The end of the phase counts too
+}
+
+double MemorySampler::mean_rss_kb() const {
+    return samples_ == 0 ? -1.0 : static_cast<double>(sum_rss_kb_) / static_cast<double>(samples_);
+}
+
+void MemorySampler::sample() {
+    const int64_t rss_kb = read_process_memory().rss_kb;
+    if (rss_kb < 0) {
+        return;
+    }
+    ++samples_;
+    sum_rss_kb_ += rss_kb;
+    if (rss_kb > peak_rss_kb_) {
+        peak_rss_kb_ = rss_kb;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Resident set size of this process from /proc/self/status, in kB (-1 = unavailable)
+struct ProcessMemory {
+    int64_t rss_kb = -1;  // VmRSS: current
+    int64_t hwm_kb = -1;  // VmHWM: peak since process start or the last reset_peak_rss()
+};
+
+// Read VmRSS and VmHWM. Does not allocate, so it can run next to the allocation counter.
+ProcessMemory read_process_memory();
+
+// Reset VmHWM to the current RSS (/proc/self/clear_refs, Linux 4.0+). Returns false if unsupported.
+bool reset_peak_rss();
+
+// Samples VmRSS on a background thread between start() and stop(), to catch
+// peaks inside a phase that the phase-boundary readings miss
+class MemorySampler {
+public:
+    explicit MemorySampler(std::chrono::milliseconds interval);
+    ~MemorySampler();
+
+    MemorySampler(const MemorySampler &) = delete;
+    MemorySampler &operator=(const MemorySampler &) = delete;
+
+    void start();
+    void stop();
+
+    // Valid after stop(); -1 if no sample was taken
+    int64_t peak_rss_kb() const { return peak_rss_kb_; }
+    double mean_rss_kb() const;
+
+private:
+    void sample();
+
+    std::chrono::milliseconds interval_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_requested_;
+    bool stopping_ = false;
+
+    uint64_t samples_ = 0;
+    int64_t sum_rss_kb_ = 0;
+    int64_t peak_rss_kb_ = -1;
+};
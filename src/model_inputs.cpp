@@ -0,0 +1,540 @@
+#include "model_inputs.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include "config.hpp"
+
+namespace {
+    // Stateless 32-bit integer hash (lowbias32); hash(seed + i) gives
+    // independent uniform bits per element without a sequential RNG state
+    inline uint32_t hash32(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    // Uniform float in [0, 1) from the top 24 bits
+    inline float unit_float(uint32_t bits) {
+        return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Round-to-nearest-even conversion of a float to IEEE half precision bits
+    uint16_t float_to_half(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+
+        if (exponent >= 31) {
+            // Overflow, infinity or NaN
+            const bool is_nan = ((bits >> 23) & 0xFFu) == 0xFFu && mantissa != 0;
+            return static_cast<uint16_t>(sign | 0x7C00u | (is_nan ? 0x200u : 0u));
+        }
+        if (exponent <= 0) {
+            // Subnormal or zero
+            if (exponent < -10) {
+                return static_cast<uint16_t>(sign);
+            }
+            mantissa |= 0x800000u;
+            const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            uint32_t half_mantissa = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u))) {
+                ++half_mantissa;
+            }
+            return static_cast<uint16_t>(sign | half_mantissa);
+        }
+
+        uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        const uint32_t remainder = mantissa & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+            ++half;  // May carry into the exponent, which is the correct rounding
+        }
+        return static_cast<uint16_t>(half);
+    }
+
+    // bfloat16 keeps the top 16 bits of a float (round-to-nearest-even)
+    uint16_t float_to_bfloat16(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits += 0x7FFFu + ((bits >> 16) & 1u);
+        return static_cast<uint16_t>(bits >> 16);
+    }
+
+    template<typename T>
+    void fill_floating(T *out, size_t count, const ValueRange &range, uint32_t seed) {
+        const float min = static_cast<float>(range.min);
+        const float scale = static_cast<float>(range.max - range.min);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<T>(min + scale * unit_float(hash32(seed + static_cast<uint32_t>(i))));
+        }
+    }
+
+    template<typename Convert>
+    void fill_half(uint16_t *out, size_t count, const ValueRange &range, uint32_t seed, Convert convert) {
+        const float min = static_cast<float>(range.min);
+        const float scale = static_cast<float>(range.max - range.min);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = convert(min + scale * unit_float(hash32(seed + static_cast<uint32_t>(i))));
+        }
+    }
+
+    // Saturating conversion of an integral double; 2^63 does not fit in int64_t
+    int64_t to_int64(double value) {
+        if (value >= 0x1p63) {
+            return std::numeric_limits<int64_t>::max();
+        }
+        if (value <= -0x1p63) {
+            return std::numeric_limits<int64_t>::min();
+        }
+        return static_cast<int64_t>(value);
+    }
+
+    // The range must hold an integer inside T (range_for_input clamps it)
+    template<typename T>
+    void fill_integer(T *out, size_t count, const ValueRange &range, uint32_t seed) {
+        const int64_t min = to_int64(std::ceil(range.min));
+        const int64_t max = to_int64(std::floor(range.max));
+        // Wraps to 0 for the full int64 range, where every 64-bit value is valid
+        const uint64_t span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+
+        if (span != 0 && span <= std::numeric_limits<uint32_t>::max()) {
+            // Multiply-shift maps 32 random bits onto [0, span) without division
+            for (size_t i = 0; i < count; ++i) {
+                const uint64_t r = hash32(seed + static_cast<uint32_t>(i));
+                out[i] = static_cast<T>(min + static_cast<int64_t>((r * span) >> 32));
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t index = static_cast<uint32_t>(i);
+                const uint64_t r = (static_cast<uint64_t>(hash32(seed + index)) << 32) |
+                                   hash32(~seed - index);
+                out[i] = static_cast<T>(static_cast<uint64_t>(min) + (span != 0 ? r % span : r));
+            }
+        }
+    }
+
+    bool is_floating(ONNXTensorElementDataType type) {
+        return type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT ||
+               type == ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE ||
+               type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 ||
+               type == ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16;
+    }
+
+    // Default integer range when none is set on the command line
+    ValueRange default_int_range(ONNXTensorElementDataType type) {
+        switch (type) {
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+                return {0.0, 255.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+                return {-128.0, 127.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+                return {0.0, 1.0};
+            default:
+                return {0.0, static_cast<double>(Config::RANDOM_INT_MAX)};
+        }
+    }
+
+    // Values an integer element type can hold; uint64 stops at the int64 maximum
+    ValueRange int_type_range(ONNXTensorElementDataType type) {
+        switch (type) {
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+                return {0.0, 1.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+                return {-128.0, 127.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+                return {0.0, 255.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+                return {-32768.0, 32767.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+                return {0.0, 65535.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+                return {-2147483648.0, 2147483647.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+                return {0.0, 4294967295.0};
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+                return {0.0, 0x1p63};
+            default:
+                return {-0x1p63, 0x1p63};
+        }
+    }
+
+    ValueRange select_range(const std::string &name, ONNXTensorElementDataType type, const InputConfig &config) {
+        const auto it = config.input_ranges.find(name);
+        if (it != config.input_ranges.end()) {
+            return it->second;
+        }
+        if (is_floating(type)) {
+            return config.float_range;
+        }
+        if (config.has_int_range && type != ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL) {
+            return config.int_range;
+        }
+        return default_int_range(type);
+    }
+
+    // Integer ranges are rounded inwards and clamped to the element type (one
+    // --int-range applies to every integer input); a range left without an
+    // integer value is an error rather than a silently wrapped fill
+    ValueRange range_for_input(const std::string &name, ONNXTensorElementDataType type,
+                               const InputConfig &config) {
+        ValueRange range = select_range(name, type, config);
+        if (is_floating(type)) {
+            return range;
+        }
+        const ValueRange limits = int_type_range(type);
+        range.min = std::max(std::ceil(range.min), limits.min);
+        range.max = std::min(std::floor(range.max), limits.max);
+        if (!(range.min <= range.max)) {
+            throw std::runtime_error("Input '" + name + "': value range holds no " + element_type_name(type) +
+                                     " value");
+        }
+        return range;
+    }
+
+    // Replace dynamic dimensions by their override or the default; returns the element count
+    size_t resolve_shape(ModelInput &input, const InputConfig &config) {
+        size_t element_count = 1;
+        for (size_t d = 0; d < input.shape.size(); ++d) {
+            int64_t &dim = input.shape[d];
+            if (dim < 0) {
+                const auto it = config.dim_overrides.find(input.symbolic_dims[d]);
+                dim = it != config.dim_overrides.end() ? it->second : Config::DEFAULT_DYNAMIC_DIM;
+            }
+            element_count *= static_cast<size_t>(dim);
+        }
+        return element_count;
+    }
+
+    // Wrap the samples of a .npy or raw file as tensors over the mapped pages (no copy).
+    // A .npy array with the input's rank is one sample; one extra leading dimension
+    // makes it a dataset of shape[0] samples. Raw files hold whole samples of the
+    // resolved input shape back to back.
+    void map_input_file(ModelInput &input, const std::string &path, const InputConfig &config,
+                        const Ort::MemoryInfo &memory_info) {
+        TensorFile file;
+        std::string error;
+        if (!open_tensor_file(path, file, error)) {
+            throw std::runtime_error("Input '" + input.name + "': " + error);
+        }
+        const std::string context = "Input '" + input.name + "' (" + path + "): ";
+        const size_t bytes_per_element = element_size(input.element_type);
+
+        size_t sample_count = 0;
+        size_t sample_elements = 1;
+        if (file.is_npy) {
+            if (file.element_type != input.element_type) {
+                throw std::runtime_error(context + "file has type " + element_type_name(file.element_type) +
+                                         ", input is " + element_type_name(input.element_type));
+            }
+
+            const size_t rank = input.shape.size();
+            std::vector<int64_t> sample_shape;
+            if (file.shape.size() == rank) {
+                sample_count = 1;
+                sample_shape = file.shape;
+            } else if (file.shape.size() == rank + 1) {
+                sample_count = static_cast<size_t>(file.shape.front());
+                sample_shape.assign(file.shape.begin() + 1, file.shape.end());
+            } else {
+                throw std::runtime_error(context + "array rank " + std::to_string(file.shape.size()) +
+                                         " does not match input rank " + std::to_string(rank));
+            }
+
+            for (size_t d = 0; d < rank; ++d) {
+                if (input.shape[d] >= 0 && input.shape[d] != sample_shape[d]) {
+                    throw std::runtime_error(context + "dimension " + std::to_string(d) + " is " +
+                                             std::to_string(sample_shape[d]) + ", model expects " +
+                                             std::to_string(input.shape[d]));
+                }
+                sample_elements *= static_cast<size_t>(sample_shape[d]);
+            }
+            input.shape = sample_shape;
+
+            if (file.data_size < sample_count * sample_elements * bytes_per_element) {
+                throw std::runtime_error(context + "file is shorter than its header shape");
+            }
+        } else {
+            sample_elements = resolve_shape(input, config);
+            const size_t sample_bytes = sample_elements * bytes_per_element;
+            if (sample_bytes == 0 || file.data_size % sample_bytes != 0) {
+                throw std::runtime_error(context + "size " + std::to_string(file.data_size) +
+                                         " is not a multiple of the sample size " + std::to_string(sample_bytes));
+            }
+            sample_count = file.data_size / sample_bytes;
+        }
+        if (sample_count == 0 || sample_elements == 0) {
+            throw std::runtime_error(context + "file holds no samples");
+        }
+
+        // ONNX Runtime only reads input buffers, so the read-only mapping can back them
+        const size_t sample_bytes = sample_elements * bytes_per_element;
+        auto *base = const_cast<uint8_t *>(file.mapping->data() + file.data_offset);
+        input.tensors.reserve(sample_count);
+        for (size_t s = 0; s < sample_count; ++s) {
+            input.tensors.push_back(Ort::Value::CreateTensor(
+                memory_info,
+                base + s * sample_bytes,
+                sample_bytes,
+                input.shape.data(),
+                input.shape.size(),
+                input.element_type));
+        }
+        input.mapping = file.mapping;
+        input.source = path;
+    }
+}
+
+size_t element_size(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+            return 1;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+            return 2;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+            return 4;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+const char *element_type_name(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return "float";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: return "double";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: return "float16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: return "bfloat16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: return "int8";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: return "int16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: return "int32";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: return "int64";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return "uint8";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: return "uint16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: return "uint32";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: return "uint64";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL: return "bool";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING: return "string";
+        default: return "unsupported";
+    }
+}
+
+bool fill_random(void *data, size_t count, ONNXTensorElementDataType type,
+                 const ValueRange &range, uint64_t seed) {
+    // Fold the 64-bit seed into the 32-bit counter offset
+    const auto seed32 = static_cast<uint32_t>(seed ^ (seed >> 32));
+
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+            fill_floating(static_cast<float *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+            fill_floating(static_cast<double *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+            fill_half(static_cast<uint16_t *>(data), count, range, seed32, float_to_half);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+            fill_half(static_cast<uint16_t *>(data), count, range, seed32, float_to_bfloat16);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+            fill_integer(static_cast<int8_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+            fill_integer(static_cast<int16_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+            fill_integer(static_cast<int32_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+            fill_integer(static_cast<int64_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+            fill_integer(static_cast<uint8_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+            fill_integer(static_cast<uint16_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+            fill_integer(static_cast<uint32_t *>(data), count, range, seed32);
+            return true;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+            fill_integer(static_cast<uint64_t *>(data), count, range, seed32);
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t dataset_size(const std::vector<ModelInput> &inputs) {
+    size_t samples = 1;
+    for (const auto &input: inputs) {
+        samples = std::max(samples, input.tensors.size());
+    }
+    return samples;
+}
+
+size_t samples_per_inference(const std::vector<ModelInput> &inputs) {
+    if (inputs.empty() || inputs.front().shape.empty()) {
+        return 1;
+    }
+    return static_cast<size_t>(inputs.front().shape.front());
+}
+
+std::string format_input_shapes(const std::vector<ModelInput> &inputs) {
+    std::string text;
+    for (const auto &input: inputs) {
+        if (!text.empty()) {
+            text += ";";
+        }
+        text += input.name + "=";
+        for (size_t d = 0; d < input.shape.size(); ++d) {
+            text += (d == 0 ? "" : "x") + std::to_string(input.shape[d]);
+        }
+    }
+    return text;
+}
+
+std::string format_dim_overrides(const std::map<std::string, int64_t> &dim_overrides) {
+    std::string text;
+    for (const auto &entry: dim_overrides) {
+        if (!text.empty()) {
+            text += ";";
+        }
+        text += entry.first + "=" + std::to_string(entry.second);
+    }
+    return text;
+}
+
+std::string describe_input_config(const InputConfig &config) {
+    std::ostringstream description;
+    description << "float " << config.float_range.min << ":" << config.float_range.max;
+    if (config.has_int_range) {
+        description << "|int " << config.int_range.min << ":" << config.int_range.max;
+    }
+    for (const auto &entry: config.input_ranges) {
+        description << "|range " << entry.first << "=" << entry.second.min << ":" << entry.second.max;
+    }
+    for (const auto &entry: config.input_files) {
+        // A rewritten file gets a new size or modification time
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(entry.second, ec);
+        const auto modified = std::filesystem::last_write_time(entry.second, ec);
+        description << "|file " << entry.first << "=" << entry.second << "@" << (ec ? 0 : size) << ":"
+                << (ec ? 0 : modified.time_since_epoch().count());
+    }
+    description << "|shape " << format_dim_overrides(config.dim_overrides) << "|seed " << config.seed;
+    return description.str();
+}
+
+std::vector<std::string> unmatched_dim_overrides(const std::vector<ModelInput> &inputs,
+                                                 const InputConfig &config) {
+    std::set<std::string> symbolic_dims;
+    for (const auto &input: inputs) {
+        symbolic_dims.insert(input.symbolic_dims.begin(), input.symbolic_dims.end());
+    }
+
+    std::vector<std::string> unmatched;
+    for (const auto &entry: config.dim_overrides) {
+        if (symbolic_dims.count(entry.first) == 0) {
+            unmatched.push_back(entry.first);
+        }
+    }
+    return unmatched;
+}
+
+std::vector<ModelInput> create_model_inputs(const Ort::Session &session, const InputConfig &config) {
+    Ort::AllocatorWithDefaultOptions allocator;
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    uint64_t seed = config.seed;
+    if (seed == 0) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    const size_t num_input_nodes = session.GetInputCount();
+    std::vector<ModelInput> inputs(num_input_nodes);
+
+    for (size_t i = 0; i < num_input_nodes; ++i) {
+        ModelInput &input = inputs[i];
+        input.name = session.GetInputNameAllocated(i, allocator).get();
+
+        auto input_type_info = session.GetInputTypeInfo(i);
+        if (input_type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+            throw std::runtime_error("Input '" + input.name + "' is not a tensor");
+        }
+        auto tensor_info = input_type_info.GetTensorTypeAndShapeInfo();
+        input.element_type = tensor_info.GetElementType();
+        input.shape = tensor_info.GetShape();
+
+        std::vector<const char *> symbolic_names(input.shape.size(), nullptr);
+        tensor_info.GetSymbolicDimensions(symbolic_names.data(), symbolic_names.size());
+        input.symbolic_dims.reserve(input.shape.size());
+        for (const char *symbolic_name: symbolic_names) {
+            input.symbolic_dims.emplace_back(symbolic_name ? symbolic_name : "");
+        }
+
+        const size_t bytes_per_element = element_size(input.element_type);
+        if (bytes_per_element == 0) {
+            throw std::runtime_error("Input '" + input.name + "' has unsupported element type " +
+                                     element_type_name(input.element_type));
+        }
+
+        const auto file_it = config.input_files.find(input.name);
+        if (file_it != config.input_files.end()) {
+            map_input_file(input, file_it->second, config, memory_info);
+            continue;
+        }
+
+        // Calculate input size (resolve dynamic dimensions by symbolic name)
+        const size_t input_tensor_size = resolve_shape(input, config);
+
+        // Each input gets its own stream so that same-shaped inputs differ
+        input.data.resize(input_tensor_size * bytes_per_element);
+        input.range = range_for_input(input.name, input.element_type, config);
+        fill_random(input.data.data(), input_tensor_size, input.element_type, input.range,
+                    seed + 0x9E3779B97F4A7C15ull * (i + 1));
+
+        input.tensors.push_back(Ort::Value::CreateTensor(
+            memory_info,
+            input.data.data(),
+            input.data.size(),
+            input.shape.data(),
+            input.shape.size(),
+            input.element_type));
+    }
+
+    // Inputs with a single sample are shared by every dataset sample
+    const size_t samples = dataset_size(inputs);
+    for (const auto &input: inputs) {
+        if (input.tensors.size() != 1 && input.tensors.size() != samples) {
+            throw std::runtime_error("Input '" + input.name + "' has " + std::to_string(input.tensors.size()) +
+                                     " samples, other inputs have " + std::to_string(samples));
+        }
+    }
+    return inputs;
+}
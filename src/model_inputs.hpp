@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "config.hpp"
+#include "tensor_file.hpp"
+
+// Inclusive value range for generated input data
+struct ValueRange {
+    double min = 0.0;
+    double max = 0.0;
+};
+
+// How model inputs are generated
+struct InputConfig {
+    // Range for floating-point inputs (float, double, float16, bfloat16)
+    ValueRange float_range{Config::RANDOM_MIN, Config::RANDOM_MAX};
+
+    // Range for integer inputs; unset = the type's natural range for 8-bit
+    // types and [0, Config::RANDOM_INT_MAX] for wider ones
+    bool has_int_range = false;
+    ValueRange int_range{0.0, 0.0};
+
+    // Per-input overrides by input name
+    std::map<std::string, ValueRange> input_ranges;
+
+    // Inputs read from .npy or raw files by input name, instead of random data
+    std::map<std::string, std::string> input_files;
+
+    // Values for symbolic (dynamic) dimensions by name, e.g. batch=8, seq=128.
+    // Dynamic dimensions without an override use Config::DEFAULT_DYNAMIC_DIM.
+    std::map<std::string, int64_t> dim_overrides;
+
+    // Seed for the input generator; 0 = random seed per session
+    uint64_t seed = 0;
+};
+
+// One model input: its metadata, backing storage and the tensor that wraps it
+struct ModelInput {
+    std::string name;
+    ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape;          // Resolved shape (no dynamic dimensions left)
+    std::vector<std::string> symbolic_dims;  // Per-dimension symbolic name ("" if unnamed or fixed)
+    std::vector<uint8_t> data;                // Generated data (empty for file-backed inputs)
+    std::shared_ptr<MappedFile> mapping;      // Mapped file the tensors point into
+    std::string source = "random";            // "random" or the input file path
+    ValueRange range;                         // Range of generated data
+
+    // One tensor per dataset sample; generated inputs have exactly one
+    std::vector<Ort::Value> tensors;
+};
+
+// Size in bytes of one element of the given type (0 for unsupported types)
+size_t element_size(ONNXTensorElementDataType type);
+
+// Name of an element type, e.g. "float", "int64"
+const char *element_type_name(ONNXTensorElementDataType type);
+
+// Fill count elements of the given type with uniform random values in range.
+// Uses a counter-based generator with no loop-carried state, so the fill
+// loops vectorize. Returns false for unsupported types.
+bool fill_random(void *data, size_t count, ONNXTensorElementDataType type,
+                 const ValueRange &range, uint64_t seed);
+
+// Number of dataset samples: the largest sample count of any input
+size_t dataset_size(const std::vector<ModelInput> &inputs);
+
+// Samples per inference: the leading dimension of the first input (1 for scalars)
+size_t samples_per_inference(const std::vector<ModelInput> &inputs);
+
+// "name=1x128;..." summary of the resolved input shapes for the performance CSV
+std::string format_input_shapes(const std::vector<ModelInput> &inputs);
+
+// "batch=8;seq=128" summary of dimension overrides (empty if none)
+std::string format_dim_overrides(const std::map<std::string, int64_t> &dim_overrides);
+
+// Everything the input tensors depend on: value ranges, input files (path, size
+// and modification time), dimension overrides and seed. Equal descriptions give
+// equal inputs when the seed is set or every input is file-backed.
+std::string describe_input_config(const InputConfig &config);
+
+// Dimension overrides that match no symbolic dimension of the inputs
+std::vector<std::string> unmatched_dim_overrides(const std::vector<ModelInput> &inputs,
+                                                 const InputConfig &config);
+
+// Build tensors for every input of the session: random data, or the samples of the
+// input's file. Throws std::runtime_error for inputs that cannot be generated
+// (non-tensor or unsupported element type) or whose file does not fit the input.
+std::vector<ModelInput> create_model_inputs(const Ort::Session &session, const InputConfig &config);
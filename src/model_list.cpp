@@ -0,0 +1,139 @@
+#include "model_list.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include "config.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    std::string trim(const std::string &text) {
+        const size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            return "";
+        }
+        const size_t last = text.find_last_not_of(" \t\r\n");
+        return text.substr(first, last - first + 1);
+    }
+
+    // The variant suffix of a model's stem, or nullptr for an original
+    const char *variant_suffix(const std::string &model) {
+        const std::string stem = fs::path(model).stem().string();
+        for (const char *variant: Config::MODEL_VARIANTS) {
+            const std::string suffix = std::string("_") + variant;
+            if (stem.size() > suffix.size() && stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                return variant;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string variant_path(const std::string &original, const char *variant) {
+        const fs::path path(original);
+        return (path.parent_path() / (path.stem().string() + "_" + variant + path.extension().string()))
+            .generic_string();
+    }
+}
+
+bool resolve_model_list(const std::string &base_dir, const std::string &model_arg,
+                        std::vector<std::string> &models, bool &is_batch, std::string &error) {
+    const fs::path base_path(base_dir);
+    const fs::path arg_path = base_path / model_arg;
+    models.clear();
+    is_batch = false;
+
+    std::error_code ec;
+    if (fs::is_directory(arg_path, ec)) {
+        is_batch = true;
+        for (fs::recursive_directory_iterator it(arg_path, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec) && it->path().extension() == ".onnx") {
+                models.push_back(fs::relative(it->path(), base_path, ec).generic_string());
+            }
+        }
+        if (ec) {
+            error = "Failed to scan " + arg_path.string() + ": " + ec.message();
+            return false;
+        }
+        std::sort(models.begin(), models.end());
+    } else if (!fs::exists(arg_path, ec)) {
+        error = "Model file not found at '" + arg_path.string() + "'";
+        return false;
+    } else if (arg_path.extension() == ".onnx") {
+        models.push_back(model_arg);
+    } else {
+        is_batch = true;
+        std::ifstream manifest(arg_path);
+        if (!manifest.is_open()) {
+            error = "Could not open manifest " + arg_path.string();
+            return false;
+        }
+        std::string line;
+        while (std::getline(manifest, line)) {
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) {
+                continue;
+            }
+            if (!fs::exists(base_path / line, ec)) {
+                error = "Model listed in manifest not found: '" + (base_path / line).string() + "'";
+                return false;
+            }
+            models.push_back(line);
+        }
+    }
+
+    if (models.empty()) {
+        error = "No .onnx models found for '" + model_arg + "'";
+        return false;
+    }
+    return true;
+}
+
+void expand_model_variants(const std::string &base_dir, std::vector<std::string> &models) {
+    const fs::path base_path(base_dir);
+    std::vector<std::string> expanded;
+    std::set<std::string> families;
+    std::error_code ec;
+    for (const std::string &model: models) {
+        const std::string original = variant_original(model);
+        if (!families.insert(original).second) {
+            continue;
+        }
+        if (fs::exists(base_path / original, ec)) {
+            expanded.push_back(original);
+        }
+        for (const char *variant: Config::MODEL_VARIANTS) {
+            const std::string path = variant_path(original, variant);
+            if (path == model || fs::exists(base_path / path, ec)) {
+                expanded.push_back(path);
+            }
+        }
+    }
+    models.swap(expanded);
+}
+
+std::string variant_original(const std::string &model) {
+    const char *variant = variant_suffix(model);
+    if (variant == nullptr) {
+        return model;
+    }
+    const fs::path path(model);
+    const std::string stem = path.stem().string();
+    return (path.parent_path() / (stem.substr(0, stem.size() - std::strlen(variant) - 1) +
+                                  path.extension().string())).generic_string();
+}
+
+std::string model_variant_name(const std::string &model) {
+    const char *variant = variant_suffix(model);
+    return variant != nullptr ? variant : Config::ORIGINAL_VARIANT;
+}
+
+std::string batch_run_name(const std::string &model_arg) {
+    std::string name = fs::path(model_arg).lexically_normal().generic_string();
+    while (!name.empty() && name.back() == '/') {
+        name.pop_back();
+    }
+    return name.empty() || name == "." ? "batch" : "batch_" + fs::path(name).stem().generic_string();
+}
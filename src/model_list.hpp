@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Resolve the model argument to the list of models to benchmark, as paths
+// relative to base_dir:
+// - a .onnx file is benchmarked on its own
+// - a directory is searched recursively for .onnx files (sorted)
+// - any other file is a manifest with one model path per line ('#' starts a comment)
+// Sets is_batch when the argument named a directory or manifest.
+bool resolve_model_list(const std::string &base_dir, const std::string &model_arg,
+                        std::vector<std::string> &models, bool &is_batch, std::string &error);
+
+// Precision variants of a model next to it, as written by scripts/make_variants.py:
+// "<stem>_<variant>.onnx" for each of Config::MODEL_VARIANTS. The original is
+// reported as Config::ORIGINAL_VARIANT.
+
+// Expand every model to its family in place (the original first, then the variants
+// that exist under base_dir); each family appears once however many of its
+// members were listed
+void expand_model_variants(const std::string &base_dir, std::vector<std::string> &models);
+
+// The original a variant was made from ("zi_t/model_fp16.onnx" → "zi_t/model.onnx");
+// any other model is its own original
+std::string variant_original(const std::string &model);
+
+// The variant a model file is ("fp16", ...), or Config::ORIGINAL_VARIANT
+std::string model_variant_name(const std::string &model);
+
+// Name for consolidated batch output files: "batch" or "batch_<dir or manifest>"
+std::string batch_run_name(const std::string &model_arg);
@@ -0,0 +1,77 @@
+#include "node_placement.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include "config.hpp"
+#include "inference_session.hpp"
+
+bool collect_node_placement(const std::string &model_path, const SessionConfig &config,
+                            const InputConfig &input_config, const std::string &profile_prefix, NodePlacement &placement,
+                            std::string &error) {
+    std::string profile_path;
+    try {
+        // The constructor's priming run is the single profiled run we need
+        InferenceSession session(model_path, config, input_config, profile_prefix);
+        profile_path = session.end_profiling();
+    } catch (const Ort::Exception &e) {
+        error = e.what();
+        return false;
+    } catch (const std::exception &e) {
+        error = e.what();
+        return false;
+    }
+
+    ProfileTrace trace;
+    const bool loaded = load_profile_trace(profile_path, trace, error);
+    std::remove(profile_path.c_str());
+    if (!loaded) {
+        return false;
+    }
+
+    // Keep each node once, in execution order
+    std::set<std::string> seen;
+    for (auto &node: trace.nodes) {
+        if (seen.insert(node.node_name).second) {
+            ++placement.provider_node_counts[node.provider];
+            placement.nodes.push_back(std::move(node));
+        }
+    }
+    return true;
+}
+
+std::string format_provider_counts(const NodePlacement &placement) {
+    std::string summary;
+    for (const auto &entry: placement.provider_node_counts) {
+        if (!summary.empty()) {
+            summary += ";";
+        }
+        summary += entry.first + ":" + std::to_string(entry.second);
+    }
+    return summary;
+}
+
+bool export_node_placement_csv(const std::string &output_file, const NodePlacement &placement) {
+    std::ofstream file(output_file);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not create node placement file: " << output_file << "\n";
+        return false;
+    }
+
+    file << "node" << Config::CSV_DELIMITER
+            << "op_type" << Config::CSV_DELIMITER
+            << "provider" << "\n";
+    for (const auto &node: placement.nodes) {
+        file << node.node_name << Config::CSV_DELIMITER
+                << node.op_type << Config::CSV_DELIMITER
+                << node.provider << "\n";
+    }
+
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Warning: Error writing to node placement file\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "model_inputs.hpp"
+#include "profile_trace.hpp"
+#include "session_config.hpp"
+
+// Which execution provider each node was assigned to
+struct NodePlacement {
+    std::vector<ProfileNodeEvent> nodes;
+    std::map<std::string, size_t> provider_node_counts;
+};
+
+// Build a profiling session with the given configuration, run it once and read
+// the provider of every executed node from the trace. Nodes an EP compiled into
+// one partition show up as a single fused node.
+bool collect_node_placement(const std::string &model_path, const SessionConfig &config,
+                            const InputConfig &input_config, const std::string &profile_prefix, NodePlacement &placement,
+                            std::string &error);
+
+// "<provider>:<count>;..." summary for the performance CSV
+std::string format_provider_counts(const NodePlacement &placement);
+
+// Write one row per node (node, op type, provider) to a CSV file
+bool export_node_placement_csv(const std::string &output_file, const NodePlacement &placement);
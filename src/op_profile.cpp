@@ -0,0 +1,146 @@
+#include "op_profile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "config.hpp"
+#include "inference_session.hpp"
+#include "profile_trace.hpp"
+
+namespace {
+    // Accumulate events into one entry per key, in first-seen order
+    void add_timing(std::vector<OpTiming> &timings, std::map<std::string, size_t> &index, const std::string &key,
+                    const ProfileNodeEvent &event) {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            found = index.emplace(key, timings.size()).first;
+            OpTiming timing;
+            timing.name = key;
+            timing.op_type = event.op_type;
+            timing.provider = event.provider;
+            timings.push_back(timing);
+        }
+        OpTiming &timing = timings[found->second];
+        if ((";" + timing.provider + ";").find(";" + event.provider + ";") == std::string::npos) {
+            timing.provider += ";" + event.provider;
+        }
+        ++timing.calls;
+        timing.total_us += event.duration_us;
+    }
+
+    void sort_by_total(std::vector<OpTiming> &timings) {
+        std::stable_sort(timings.begin(), timings.end(), [](const OpTiming &a, const OpTiming &b) {
+            return a.total_us > b.total_us;
+        });
+    }
+
+    void write_rows(std::ofstream &file, const char *level, const std::vector<OpTiming> &timings,
+                    const OpProfile &profile) {
+        for (const auto &timing: timings) {
+            file << level << Config::CSV_DELIMITER
+                    << timing.name << Config::CSV_DELIMITER
+                    << timing.op_type << Config::CSV_DELIMITER
+                    << timing.provider << Config::CSV_DELIMITER
+                    << timing.calls << Config::CSV_DELIMITER
+                    << timing.total_us << Config::CSV_DELIMITER
+                    << timing.total_us / static_cast<double>(timing.calls) << Config::CSV_DELIMITER
+                    << timing.total_us / static_cast<double>(profile.runs) << Config::CSV_DELIMITER
+                    << (profile.kernel_total_us > 0.0 ? timing.total_us / profile.kernel_total_us : 0.0) << "\n";
+        }
+    }
+}
+
+bool collect_op_profile(const std::string &model_path, const SessionConfig &config, const InputConfig &input_config,
+                        const std::string &profile_prefix, size_t runs, OpProfile &profile, std::string &error) {
+    std::string profile_path;
+    try {
+        InferenceSession session(model_path, config, input_config, profile_prefix);
+        for (size_t i = 0; i < runs; ++i) {
+            session.run();
+        }
+        profile_path = session.end_profiling();
+    } catch (const Ort::Exception &e) {
+        error = e.what();
+        return false;
+    } catch (const std::exception &e) {
+        error = e.what();
+        return false;
+    }
+
+    ProfileTrace trace;
+    const bool loaded = load_profile_trace(profile_path, trace, error);
+    std::remove(profile_path.c_str());
+    if (!loaded) {
+        return false;
+    }
+
+    // Kernels that started before the first model_run ended belong to the priming run
+    double priming_end_us = 0.0;
+    for (const auto &event: trace.session_events) {
+        if (event.name == "model_run") {
+            priming_end_us = event.start_us + event.duration_us;
+            break;
+        }
+    }
+
+    profile.runs = runs;
+    std::map<std::string, size_t> node_index;
+    std::map<std::string, size_t> op_type_index;
+    for (const auto &event: trace.nodes) {
+        if (event.start_us < priming_end_us) {
+            continue;
+        }
+        add_timing(profile.nodes, node_index, event.node_name, event);
+        add_timing(profile.op_types, op_type_index, event.op_type, event);
+        profile.kernel_total_us += event.duration_us;
+    }
+    if (profile.nodes.empty()) {
+        error = "No kernel events in the profile trace";
+        return false;
+    }
+    sort_by_total(profile.nodes);
+    sort_by_total(profile.op_types);
+    return true;
+}
+
+std::string format_top_op_types(const OpProfile &profile, size_t count) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < profile.op_types.size() && i < count; ++i) {
+        const OpTiming &timing = profile.op_types[i];
+        oss << (i == 0 ? "" : ";") << timing.name << ":" << 100.0 * timing.total_us / profile.kernel_total_us;
+    }
+    return oss.str();
+}
+
+bool export_op_profile_csv(const std::string &output_file, const OpProfile &profile) {
+    std::ofstream file(output_file);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not create op profile file: " << output_file << "\n";
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(Config::FLOAT_PRECISION);
+    file << "level" << Config::CSV_DELIMITER
+            << "name" << Config::CSV_DELIMITER
+            << "op_type" << Config::CSV_DELIMITER
+            << "provider" << Config::CSV_DELIMITER
+            << "calls" << Config::CSV_DELIMITER
+            << "total_us" << Config::CSV_DELIMITER
+            << "mean_us" << Config::CSV_DELIMITER
+            << "us_per_run" << Config::CSV_DELIMITER
+            << "share" << "\n";
+    write_rows(file, "op_type", profile.op_types, profile);
+    write_rows(file, "node", profile.nodes, profile);
+
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Warning: Error writing to op profile file\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "model_inputs.hpp"
+#include "session_config.hpp"
+
+// Kernel time of one node, or of all nodes of one operator type
+struct OpTiming {
+    std::string name;      // Node name, or the op type for op-type rows
+    std::string op_type;
+    std::string provider;  // "A;B" if nodes of one op type ran on several providers
+    uint64_t calls = 0;
+    double total_us = 0.0;
+};
+
+// Per-node and per-op-type kernel time over the profiled runs, most expensive first
+struct OpProfile {
+    size_t runs = 0;
+    double kernel_total_us = 0.0;
+    std::vector<OpTiming> nodes;
+    std::vector<OpTiming> op_types;
+};
+
+// Build a profiling session with the given configuration and profile `runs`
+// inferences. The priming run in the session constructor is left out.
+bool collect_op_profile(const std::string &model_path, const SessionConfig &config, const InputConfig &input_config,
+                        const std::string &profile_prefix, size_t runs, OpProfile &profile, std::string &error);
+
+// "<op type>:<share %>;..." of the top op types for the performance CSV
+std::string format_top_op_types(const OpProfile &profile, size_t count);
+
+// Write op-type rows, then node rows (level, name, op_type, provider, calls,
+// total_us, mean_us, us_per_run, share) to a CSV file
+bool export_op_profile_csv(const std::string &output_file, const OpProfile &profile);
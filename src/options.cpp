@@ -0,0 +1,571 @@
+#include "options.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "config.hpp"
+#include "cpu_affinity.hpp"
+#include "rate_pacer.hpp"
+
+namespace {
+    constexpr int POSITIONAL_ARGS = 4;
+
+    // Parse a non-negative integer that fits an int (durations, counts, sizes)
+    bool parse_non_negative_int(const std::string &text, int &value) {
+        char *end = nullptr;
+        errno = 0;
+        const long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || errno == ERANGE || parsed < 0 || parsed > INT_MAX) {
+            return false;
+        }
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // Parse a thread count; 0 lets ONNX Runtime pick its default
+    bool parse_thread_count(const std::string &text, int &value) {
+        return parse_non_negative_int(text, value);
+    }
+
+    bool parse_on_off(const std::string &text, bool &value) {
+        if (text == "on" || text == "1" || text == "true") {
+            value = true;
+        } else if (text == "off" || text == "0" || text == "false") {
+            value = false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Parse a count of at least 1 (workers, profiled runs)
+    bool parse_positive_count(const std::string &text, int &value) {
+        return parse_non_negative_int(text, value) && value > 0;
+    }
+
+    // Parse a sampling interval in ms; 0 turns sampling off
+    bool parse_interval_ms(const std::string &text, int &value) {
+        return parse_non_negative_int(text, value);
+    }
+
+    // Parse a finite floating-point number (no inf or nan)
+    bool parse_finite_double(const std::string &text, double &value) {
+        char *end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && std::isfinite(value);
+    }
+
+    bool parse_non_negative_double(const std::string &text, double &value) {
+        return parse_finite_double(text, value) && value >= 0.0;
+    }
+
+    bool parse_positive_double(const std::string &text, double &value) {
+        return parse_finite_double(text, value) && value > 0.0;
+    }
+
+    // Parse a request rate in Hz (fractional allowed) that a schedule can represent
+    bool parse_rate(const std::string &text, double &value) {
+        return parse_finite_double(text, value) && valid_request_rate(value);
+    }
+
+    // Parse "MIN:MAX" with finite MIN <= MAX
+    bool parse_range(const std::string &text, ValueRange &range) {
+        const size_t colon = text.find(':', 1);  // Skip a leading minus sign
+        if (colon == std::string::npos) {
+            return false;
+        }
+        const std::string min_text = text.substr(0, colon);
+        const std::string max_text = text.substr(colon + 1);
+        char *min_end = nullptr;
+        char *max_end = nullptr;
+        range.min = std::strtod(min_text.c_str(), &min_end);
+        range.max = std::strtod(max_text.c_str(), &max_end);
+        return !min_text.empty() && !max_text.empty() && *min_end == '\0' && *max_end == '\0' &&
+               std::isfinite(range.min) && std::isfinite(range.max) && range.min <= range.max;
+    }
+
+    // Parse "NAME=MIN:MAX" into a per-input range override
+    bool parse_input_range(const std::string &text, std::map<std::string, ValueRange> &ranges) {
+        const size_t eq = text.rfind('=');
+        if (eq == std::string::npos || eq == 0) {
+            return false;
+        }
+        ValueRange range;
+        if (!parse_range(text.substr(eq + 1), range)) {
+            return false;
+        }
+        ranges[text.substr(0, eq)] = range;
+        return true;
+    }
+
+    // Parse "KEY=VALUE" into a session config entry
+    bool parse_config_entry(const std::string &text, std::vector<std::pair<std::string, std::string> > &entries) {
+        const size_t eq = text.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            return false;
+        }
+        entries.emplace_back(text.substr(0, eq), text.substr(eq + 1));
+        return true;
+    }
+
+    // Parse "NAME=PATH" into a per-input data file
+    bool parse_input_file(const std::string &text, std::map<std::string, std::string> &files) {
+        const size_t eq = text.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == text.size()) {
+            return false;
+        }
+        files[text.substr(0, eq)] = text.substr(eq + 1);
+        return true;
+    }
+
+    // Parse "name=N,name=N" symbolic dimension values (N > 0)
+    bool parse_dim_overrides(const std::string &text, std::map<std::string, int64_t> &dims) {
+        std::stringstream ss(text);
+        std::string item;
+        bool any = false;
+        while (std::getline(ss, item, ',')) {
+            const size_t eq = item.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                return false;
+            }
+            char *end = nullptr;
+            const long long value = std::strtoll(item.c_str() + eq + 1, &end, 10);
+            if (eq + 1 == item.size() || *end != '\0' || value <= 0) {
+                return false;
+            }
+            dims[item.substr(0, eq)] = value;
+            any = true;
+        }
+        return any;
+    }
+
+    // Parse "shape/shape/..." where each shape is a dimension override list
+    bool parse_shape_list(const std::string &text, std::vector<std::map<std::string, int64_t> > &shapes) {
+        shapes.clear();
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, '/')) {
+            std::map<std::string, int64_t> dims;
+            if (!parse_dim_overrides(item, dims)) {
+                return false;
+            }
+            shapes.push_back(std::move(dims));
+        }
+        return !shapes.empty();
+    }
+
+    // Parse a generator seed; 0 keeps the per-run random seed
+    bool parse_seed(const std::string &text, uint64_t &value) {
+        char *end = nullptr;
+        value = std::strtoull(text.c_str(), &end, 0);
+        return !text.empty() && text[0] != '-' && *end == '\0';
+    }
+
+    // Parse a comma-separated (or `separator`-separated) list with the given element parser
+    template<typename T, typename Parser>
+    bool parse_list(const std::string &text, std::vector<T> &values, Parser parse_element, char separator = ',') {
+        values.clear();
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, separator)) {
+            T value{};
+            if (!parse_element(item, value)) {
+                return false;
+            }
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    // Split "--name=value" into name and value; value is empty for plain flags
+    void split_option(const std::string &arg, std::string &name, std::string &value) {
+        const size_t eq = arg.find('=');
+        name = arg.substr(0, eq);
+        value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    }
+}
+
+void print_usage() {
+    std::cerr << "Usage: ./onnx_runner <onnx_filename> <warmup_seconds> <silence_seconds> <measurement_seconds> [options]\n"
+            << "       ./onnx_runner --serve=ENDPOINT [--session-cache=N] [--session-cache-mb=MB]\n"
+            << "\n"
+            << "Server mode (jobs as JSON lines over a socket, see README):\n"
+            << "  --serve=ENDPOINT            Listen on tcp:PORT (localhost), unix:PATH or unix:@NAME (abstract)\n"
+            << "  --session-cache=N           Sessions kept between jobs (default: " << Config::SESSION_CACHE_SIZE
+            << ", 0 = off)\n"
+            << "  --session-cache-mb=MB       Resident memory budget of the cached sessions (default: "
+            << Config::SESSION_CACHE_BUDGET_MB << ", 0 = unlimited)\n"
+            << "\n"
+            << "Options:\n"
+            << "  --cold-load                 Rebuild environment and session on every iteration (measures load cost)\n"
+            << "  --intra-op-threads=N        Intra-op thread pool size (default: 1, 0 = ORT default)\n"
+            << "  --inter-op-threads=N        Inter-op thread pool size for parallel mode (default: 1)\n"
+            << "  --execution-mode=MODE       sequential | parallel (default: sequential)\n"
+            << "  --graph-opt=LEVEL           Graph optimization: disabled | basic | extended | all (default: all)\n"
+            << "  --mem-pattern=on|off        Memory pattern planning (default: on)\n"
+            << "  --cpu-arena=on|off          CPU memory arena (default: on)\n"
+            << "  --shared-arena              One CPU arena in the environment, shared by all sessions\n"
+            << "  --session-config=KEY=VALUE  Extra session config entry (AddConfigEntry, repeatable)\n"
+            << "  --spinning=on|off           Let idle ORT worker threads spin (default: on)\n"
+            << "  --cpu-mask=MASK             Pin driver and ORT worker threads, e.g. 0xf0 or 4-7\n"
+            << "  --workers=N                 Concurrent threads calling Run() (default: 1)\n"
+            << "  --worker-sessions=MODE      shared | per-worker: one session for all workers or one each (default: shared)\n"
+            << "  --target-rate=HZ            Issue inferences at a fixed rate (open loop), e.g. 30 (default: as fast as possible)\n"
+            << "  --prep=MODE                 Prepare every inference's inputs: none | serial | pipelined (producer thread,\n"
+            << "                              double-buffered) (default: none, inputs prepared once)\n"
+            << "  --prep-passes=N             Repeat each input's preparation N times, a heavier preprocessing stand-in\n"
+            << "                              (default: 1)\n"
+            << "  --ep=EP                     Execution provider: cpu | xnnpack | nnapi (default: cpu)\n"
+            << "  --xnnpack-threads=N         XNNPACK thread pool size (default: intra-op threads)\n"
+            << "  --nnapi-fp16                NNAPI: relax fp32 computation to fp16\n"
+            << "  --nnapi-nchw                NNAPI: use NCHW layout\n"
+            << "  --nnapi-cpu-disabled        NNAPI: do not use the NNAPI CPU reference device\n"
+            << "  --nnapi-cpu-only            NNAPI: only use the NNAPI CPU device\n"
+            << "  --placement-report          Write node placement CSV for the CPU provider too\n"
+            << "  --load=MODE                 Model loading: file | buffer | mmap (default: file)\n"
+            << "  --optimized-cache           Save the optimized model (ORT format) once, load it afterwards (CPU EP)\n"
+            << "  --startup-profile           Profile session creation (model loading vs. initialization)\n"
+            << "  --profile=N                 Profile N inferences after each window; per-operator times to _ops.csv\n"
+            << "  --variants                  Also benchmark the model's _fp16 / _int8_dynamic / _int8_static variants,\n"
+            << "                              validated against the original (see scripts/make_variants.py)\n"
+            << "  --validate                  Compare outputs with a CPU fp32 reference after each window\n"
+            << "  --reference-model=PATH      Reference model relative to models/, e.g. the fp32 original (implies --validate)\n"
+            << "  --reference-dir=DIR         Save reference outputs as .npy once and reuse them (implies --validate)\n"
+            << "  --max-abs-error=E           Largest absolute output error that passes (default: "
+            << Config::VALIDATION_MAX_ABS_ERROR << ")\n"
+            << "  --min-cosine=C              Smallest per-output cosine similarity that passes (default: "
+            << Config::VALIDATION_MIN_COSINE << ")\n"
+            << "  --power-interval=MS         Fuel-gauge (RAPL on a Linux host) sampling interval during measurement\n"
+            << "                              (default: " << Config::POWER_SAMPLE_INTERVAL_MS << ", 0 = off)\n"
+            << "  --batterystats=on|off       Reset and dump batterystats around each window (default: "
+            << (Config::BATTERYSTATS_DEFAULT ? "on" : "off") << ")\n"
+            << "  --perf-counters             Count cycles, instructions, cache/branch misses during measurement\n"
+            << "  --telemetry[=MS]            Sample CPU frequencies and temperatures every MS ms to _telemetry.csv\n"
+            << "                              (default: " << Config::TELEMETRY_SAMPLE_INTERVAL_MS << ")\n"
+            << "  --iteration-log             Write every measured iteration (start, latency, worker) to _iterations.bin\n"
+            << "  --adaptive-warmup[=CV]      End warmup once the latency CV stays below CV (default: "
+            << Config::WARMUP_CV_THRESHOLD << "); warmup_seconds is the cap\n"
+            << "  --warmup-window=N           Runs per rolling window of --adaptive-warmup (default: "
+            << Config::WARMUP_WINDOW_RUNS << ")\n"
+            << "  --ci-target=REL             End measurement once the 95% CI is within ±REL of the mean, e.g. 0.01;\n"
+            << "                              measurement_seconds is the cap\n"
+            << "  --ci-metric=METRIC          latency | energy: quantity of --ci-target (default: latency)\n"
+            << "  --min-measurement=S         Shortest measurement with --ci-target (default: "
+            << Config::CI_MIN_MEASUREMENT_SECONDS << ")\n"
+            << "  --co-run=MODEL[:HZ][@MASK]  Run another model (relative to models/) in the background, at HZ or back\n"
+            << "                              to back, on MASK (default: CPUs the benchmark is not pinned to; repeatable)\n"
+            << "  --stress=KIND[:N][@MASK]    Background stressor: cpu (spin loop) or membw (memory copies), N threads\n"
+            << "                              (default: 1; repeatable)\n"
+            << "  --interference-baseline=on|off  Run each configuration alone before it runs under load (default: on)\n"
+            << "  --session-cache=N           Keep up to N sessions warm across batch and sweep windows (default: 0)\n"
+            << "  --session-cache-mb=MB       Resident memory budget of the cached sessions (default: "
+            << Config::SESSION_CACHE_BUDGET_MB << ", 0 = unlimited)\n"
+            << "  --float-range=MIN:MAX       Value range for float/double/fp16/bf16 inputs (default: 0:1)\n"
+            << "  --int-range=MIN:MAX         Value range for integer inputs (default: full range for 8-bit, 0:100 otherwise)\n"
+            << "  --input-range=NAME=MIN:MAX  Value range for one input by name (repeatable)\n"
+            << "  --seed=N                    Seed for generated inputs (default: random per session)\n"
+            << "  --input-file=NAME=PATH      Read an input from a .npy or raw file (mmap, repeatable); a leading\n"
+            << "                              sample dimension makes a dataset that runs cycle through\n"
+            << "  --shape=DIM=N,DIM=N         Values for dynamic dimensions by name, e.g. batch=8,seq=128 (default: 1)\n"
+            << "\n"
+            << "Sweep (every combination runs warmup/silence/measurement in one process):\n"
+            << "  --sweep-threads=N,N,...     Intra-op thread counts to benchmark\n"
+            << "  --sweep-workers=N,N,...     Worker counts to benchmark (saturation curve)\n"
+            << "  --sweep-target-rates=R,R,.. Request rates in Hz to benchmark, e.g. 10,30,60\n"
+            << "  --sweep-prep=M,M            Input preparation modes to benchmark, e.g. serial,pipelined\n"
+            << "  --sweep-cpu-masks=M/M/...   CPU masks to benchmark (hex masks or CPU lists, e.g. 0x0f/0xf0/0-1,4-5)\n"
+            << "  --sweep-eps=EP,EP,...       Execution providers to benchmark, e.g. cpu,xnnpack,nnapi\n"
+            << "  --sweep-shapes=S/S/...      Input shapes to benchmark, e.g. batch=1,seq=128/batch=8,seq=128\n"
+            << "  --sweep-execution-modes=M,M Execution modes to benchmark, e.g. sequential,parallel\n"
+            << "  --sweep-graph-opt=L,L,...   Graph optimization levels to benchmark, e.g. disabled,basic,all\n"
+            << "  --sweep-mem-pattern=on,off  Memory pattern settings to benchmark\n"
+            << "  --sweep-cpu-arena=on,off    CPU arena settings to benchmark\n"
+            << "\n"
+            << "Environment:\n"
+            << "  " << Config::MODEL_BASE_PATH_ENV << "           Model directory (default: " << Config::MODEL_BASE_PATH << ")\n"
+            << "  " << Config::MEASUREMENTS_DIR_ENV << "    Output directory (default: " << Config::MEASUREMENTS_DIR << ")\n"
+            << "  " << Config::OPTIMIZED_MODEL_DIR_ENV << " Optimized-model cache (default: "
+            << Config::OPTIMIZED_MODEL_DIR << ")\n";
+}
+
+bool parse_options(int argc, char **argv, BenchmarkOptions &options, std::string &error) {
+    if (argc < POSITIONAL_ARGS + 1) {
+        error = "Missing required arguments";
+        return false;
+    }
+
+    options.model_filename = argv[1];
+    if (!parse_non_negative_int(argv[2], options.warmup_seconds) ||
+        !parse_non_negative_int(argv[3], options.silence_seconds) ||
+        !parse_non_negative_int(argv[4], options.measurement_seconds) ||
+        options.measurement_seconds == 0) {
+        error = "Durations must be non-negative (measurement must be positive)";
+        return false;
+    }
+
+    for (int i = POSITIONAL_ARGS + 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string name;
+        std::string value;
+        split_option(arg, name, value);
+
+        bool valid = true;
+        if (name == "--cold-load") {
+            options.cold_load = true;
+        } else if (name == "--intra-op-threads") {
+            valid = parse_thread_count(value, options.session.intra_op_threads);
+        } else if (name == "--inter-op-threads") {
+            valid = parse_thread_count(value, options.session.inter_op_threads);
+        } else if (name == "--execution-mode") {
+            valid = parse_execution_mode(value, options.session.execution_mode);
+        } else if (name == "--graph-opt") {
+            valid = parse_graph_optimization_level(value, options.session.graph_optimization_level);
+        } else if (name == "--mem-pattern") {
+            valid = parse_on_off(value, options.session.mem_pattern);
+        } else if (name == "--cpu-arena") {
+            valid = parse_on_off(value, options.session.cpu_arena);
+        } else if (name == "--shared-arena") {
+            options.session.shared_arena = true;
+        } else if (name == "--session-config") {
+            valid = parse_config_entry(value, options.session.config_entries);
+        } else if (name == "--spinning") {
+            valid = parse_on_off(value, options.session.allow_spinning);
+        } else if (name == "--cpu-mask") {
+            valid = parse_cpu_mask(value, options.session.cpu_mask);
+        } else if (name == "--workers") {
+            valid = parse_positive_count(value, options.workers);
+        } else if (name == "--worker-sessions") {
+            if (value == "shared") {
+                options.per_worker_sessions = false;
+            } else if (value == "per-worker") {
+                options.per_worker_sessions = true;
+            } else {
+                valid = false;
+            }
+        } else if (name == "--target-rate") {
+            valid = parse_rate(value, options.target_rate_hz);
+        } else if (name == "--prep") {
+            valid = parse_prep_mode(value, options.prep_mode);
+        } else if (name == "--prep-passes") {
+            valid = parse_positive_count(value, options.prep_passes);
+        } else if (name == "--ep") {
+            valid = parse_execution_provider(value, options.session.execution_provider);
+        } else if (name == "--xnnpack-threads") {
+            valid = parse_thread_count(value, options.session.xnnpack_threads);
+        } else if (name == "--nnapi-fp16") {
+            options.session.nnapi_fp16 = true;
+        } else if (name == "--nnapi-nchw") {
+            options.session.nnapi_nchw = true;
+        } else if (name == "--nnapi-cpu-disabled") {
+            options.session.nnapi_cpu_disabled = true;
+        } else if (name == "--nnapi-cpu-only") {
+            options.session.nnapi_cpu_only = true;
+        } else if (name == "--placement-report") {
+            options.placement_report = true;
+        } else if (name == "--load") {
+            valid = parse_load_mode(value, options.session.load_mode);
+        } else if (name == "--optimized-cache") {
+            options.optimized_cache = true;
+        } else if (name == "--startup-profile") {
+            options.startup_profile = true;
+        } else if (name == "--power-interval") {
+            valid = parse_interval_ms(value, options.power_interval_ms);
+        } else if (name == "--batterystats") {
+            valid = parse_on_off(value, options.batterystats);
+        } else if (name == "--perf-counters") {
+            options.perf_counters = true;
+        } else if (name == "--telemetry") {
+            options.telemetry_interval_ms = Config::TELEMETRY_SAMPLE_INTERVAL_MS;
+            if (!value.empty()) {
+                valid = parse_positive_count(value, options.telemetry_interval_ms);
+            }
+        } else if (name == "--iteration-log") {
+            options.iteration_log = true;
+        } else if (name == "--profile") {
+            valid = parse_positive_count(value, options.profile_runs);
+        } else if (name == "--variants") {
+            options.variants = true;
+            options.validate = true;
+        } else if (name == "--validate") {
+            options.validate = true;
+        } else if (name == "--reference-model") {
+            options.reference_model = value;
+            options.validate = true;
+            valid = !value.empty();
+        } else if (name == "--reference-dir") {
+            options.reference_dir = value;
+            options.validate = true;
+            valid = !value.empty();
+        } else if (name == "--max-abs-error") {
+            valid = parse_non_negative_double(value, options.validation_max_abs_error);
+        } else if (name == "--min-cosine") {
+            valid = parse_non_negative_double(value, options.validation_min_cosine) && options.validation_min_cosine <= 1.0;
+        } else if (name == "--float-range") {
+            valid = parse_range(value, options.inputs.float_range);
+        } else if (name == "--int-range") {
+            valid = parse_range(value, options.inputs.int_range);
+            options.inputs.has_int_range = valid;
+        } else if (name == "--input-range") {
+            valid = parse_input_range(value, options.inputs.input_ranges);
+        } else if (name == "--input-file") {
+            valid = parse_input_file(value, options.inputs.input_files);
+        } else if (name == "--seed") {
+            valid = parse_seed(value, options.inputs.seed);
+        } else if (name == "--shape") {
+            valid = parse_dim_overrides(value, options.inputs.dim_overrides);
+        } else if (name == "--adaptive-warmup") {
+            options.warmup_cv_threshold = Config::WARMUP_CV_THRESHOLD;
+            if (!value.empty()) {
+                valid = parse_positive_double(value, options.warmup_cv_threshold) && options.warmup_cv_threshold < 1.0;
+            }
+        } else if (name == "--warmup-window") {
+            valid = parse_positive_count(value, options.warmup_window) && options.warmup_window > 1;
+        } else if (name == "--ci-target") {
+            valid = parse_positive_double(value, options.ci_target) && options.ci_target < 1.0;
+        } else if (name == "--ci-metric") {
+            valid = parse_ci_metric(value, options.ci_metric);
+        } else if (name == "--min-measurement") {
+            valid = parse_non_negative_int(value, options.ci_min_seconds);
+        } else if (name == "--sweep-threads") {
+            valid = parse_list(value, options.sweep_intra_op_threads, parse_thread_count);
+        } else if (name == "--sweep-workers") {
+            valid = parse_list(value, options.sweep_workers, parse_positive_count);
+        } else if (name == "--sweep-target-rates") {
+            valid = parse_list(value, options.sweep_target_rates, parse_rate);
+        } else if (name == "--sweep-prep") {
+            valid = parse_list(value, options.sweep_prep_modes, parse_prep_mode);
+        } else if (name == "--sweep-cpu-masks") {
+            // '/' between masks: a CPU list such as 0-1,4-5 has commas of its own
+            valid = parse_list(value, options.sweep_cpu_masks, parse_cpu_mask, '/');
+        } else if (name == "--sweep-eps") {
+            valid = parse_list(value, options.sweep_execution_providers, parse_execution_provider);
+        } else if (name == "--sweep-execution-modes") {
+            valid = parse_list(value, options.sweep_execution_modes, parse_execution_mode);
+        } else if (name == "--sweep-graph-opt") {
+            valid = parse_list(value, options.sweep_graph_optimization_levels, parse_graph_optimization_level);
+        } else if (name == "--sweep-mem-pattern") {
+            valid = parse_list(value, options.sweep_mem_pattern, parse_on_off);
+        } else if (name == "--sweep-cpu-arena") {
+            valid = parse_list(value, options.sweep_cpu_arena, parse_on_off);
+        } else if (name == "--session-cache") {
+            int size = 0;
+            valid = parse_non_negative_int(value, size);
+            options.session_cache_size = static_cast<size_t>(size);
+        } else if (name == "--session-cache-mb") {
+            valid = parse_non_negative_int(value, options.session_cache_budget_mb);
+        } else if (name == "--co-run" || name == "--stress") {
+            InterferenceSource source;
+            valid = name == "--co-run" ? parse_co_run(value, source) : parse_stressor(value, source);
+            options.interference.push_back(source);
+        } else if (name == "--interference-baseline") {
+            valid = parse_on_off(value, options.interference_baseline);
+        } else if (name == "--sweep-shapes") {
+            valid = parse_shape_list(value, options.sweep_shapes);
+        } else {
+            error = "Unknown option: " + arg;
+            return false;
+        }
+
+        if (!valid) {
+            error = "Invalid value for " + name + ": '" + value + "'";
+            return false;
+        }
+    }
+
+    // Cold loads rebuild the session per iteration; there is nothing to share between workers
+    if (options.cold_load && (options.workers > 1 || !options.sweep_workers.empty())) {
+        error = "--cold-load cannot be combined with --workers or --sweep-workers";
+        return false;
+    }
+
+    // Prepared inputs are bound to the driver thread's session; a cold load prepares its own
+    const bool prepares = options.prep_mode != PrepMode::None ||
+                          std::any_of(options.sweep_prep_modes.begin(), options.sweep_prep_modes.end(),
+                                      [](PrepMode mode) { return mode != PrepMode::None; });
+    if (prepares && (options.cold_load || options.workers > 1 || !options.sweep_workers.empty())) {
+        error = "--prep cannot be combined with --cold-load, --workers or --sweep-workers";
+        return false;
+    }
+
+    // An open loop issues each frame at its time; a producer would prepare it ahead of that
+    const bool pipelined = options.prep_mode == PrepMode::Pipelined ||
+                           std::find(options.sweep_prep_modes.begin(), options.sweep_prep_modes.end(),
+                                     PrepMode::Pipelined) != options.sweep_prep_modes.end();
+    if (pipelined && (options.target_rate_hz > 0.0 || !options.sweep_target_rates.empty())) {
+        error = "--prep=pipelined cannot be combined with --target-rate or --sweep-target-rates";
+        return false;
+    }
+
+    // The positional warmup seconds cap the adaptive warmup
+    if (options.warmup_cv_threshold > 0.0 && options.warmup_seconds == 0) {
+        error = "--adaptive-warmup needs warmup_seconds > 0 (its time limit)";
+        return false;
+    }
+
+    // Energy batches come from the in-process fuel gauge, which must sample
+    // several times per batch for the batch energies to be distinguishable
+    if (options.ci_target > 0.0 && options.ci_metric == CiMetric::Energy &&
+        (options.power_interval_ms == 0 || options.power_interval_ms > Config::CI_BATCH_MS / 4)) {
+        error = "--ci-metric=energy needs fuel-gauge sampling at --power-interval=1.." +
+                std::to_string(Config::CI_BATCH_MS / 4) + " (a quarter of the " +
+                std::to_string(Config::CI_BATCH_MS) + " ms batch)";
+        return false;
+    }
+
+    // Saved reference outputs only match runs that feed the same inputs; without a
+    // seed every input must be file-backed, which validation checks per model
+    if (!options.reference_dir.empty() && options.inputs.seed == 0 && options.inputs.input_files.empty()) {
+        error = "--reference-dir needs reproducible inputs (--seed, or --input-file for every input)";
+        return false;
+    }
+
+    // The shared arena replaces the per-session one; it cannot be switched off per session
+    if (options.session.shared_arena &&
+        (!options.session.cpu_arena ||
+         std::find(options.sweep_cpu_arena.begin(), options.sweep_cpu_arena.end(), false) !=
+         options.sweep_cpu_arena.end())) {
+        error = "--shared-arena requires --cpu-arena=on";
+        return false;
+    }
+
+    return true;
+}
+
+bool is_serve_command(const std::string &arg) {
+    return arg.compare(0, 8, "--serve=") == 0;
+}
+
+bool parse_serve_options(int argc, char **argv, ServeOptions &options, std::string &error) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string name;
+        std::string value;
+        split_option(arg, name, value);
+
+        bool valid = true;
+        if (name == "--serve") {
+            options.endpoint = value;
+            valid = value.compare(0, 4, "tcp:") == 0 || value.compare(0, 5, "unix:") == 0;
+        } else if (name == "--session-cache") {
+            int size = 0;
+            valid = parse_non_negative_int(value, size);
+            options.session_cache_size = static_cast<size_t>(size);
+        } else if (name == "--session-cache-mb") {
+            valid = parse_non_negative_int(value, options.session_cache_budget_mb);
+        } else {
+            error = "Unknown option: " + arg;
+            return false;
+        }
+
+        if (!valid) {
+            error = "Invalid value for " + name + ": '" + value + "'";
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "confidence_monitor.hpp"
+#include "config.hpp"
+#include "input_pipeline.hpp"
+#include "interference.hpp"
+#include "model_inputs.hpp"
+#include "session_config.hpp"
+
+// Command-line options for a benchmark run
+struct BenchmarkOptions {
+    std::string model_filename;
+    int warmup_seconds = 0;
+    int silence_seconds = 0;
+    int measurement_seconds = 0;
+
+    // Rebuild the environment and session on every iteration (measures load cost)
+    bool cold_load = false;
+
+    // Threading and CPU placement
+    SessionConfig session;
+
+    // Concurrent throughput mode: worker threads and whether they share one session
+    int workers = 1;
+    bool per_worker_sessions = false;
+
+    // Open-loop request rate in Hz; 0 = closed loop (as fast as possible)
+    double target_rate_hz = 0.0;
+
+    // Per-inference input preparation (--prep) and its cost in passes over the inputs
+    PrepMode prep_mode = PrepMode::None;
+    int prep_passes = 1;
+
+    // Energy sources: fuel-gauge sampling interval in ms (0 = off) and whether to
+    // reset / dump batterystats around each window
+    int power_interval_ms = Config::POWER_SAMPLE_INTERVAL_MS;
+    bool batterystats = Config::BATTERYSTATS_DEFAULT;
+
+    // Value ranges and seed for the generated input tensors
+    InputConfig inputs;
+
+    // Sweep lists: every combination is benchmarked in this process (empty = use session)
+    std::vector<int> sweep_intra_op_threads;
+    std::vector<int> sweep_workers;
+    std::vector<double> sweep_target_rates;
+    std::vector<PrepMode> sweep_prep_modes;
+    std::vector<uint64_t> sweep_cpu_masks;
+    std::vector<ExecutionProvider> sweep_execution_providers;
+    std::vector<ExecutionMode> sweep_execution_modes;
+    std::vector<GraphOptimizationLevel> sweep_graph_optimization_levels;
+    std::vector<bool> sweep_mem_pattern;
+    std::vector<bool> sweep_cpu_arena;
+    std::vector<std::map<std::string, int64_t> > sweep_shapes;  // Merged over inputs.dim_overrides
+
+    // Write a node → execution provider report even for the CPU provider
+    bool placement_report = false;
+
+    // Save the optimized graph (ORT format) on the first load and load it after that
+    bool optimized_cache = false;
+
+    // Split session creation into model loading and initialization with the profiler
+    bool startup_profile = false;
+
+    // Hardware/software performance counters during measurement
+    bool perf_counters = false;
+
+    // CPU frequency / thermal sampling interval in ms (--telemetry[=MS]); 0 = off
+    int telemetry_interval_ms = 0;
+
+    // Inferences to profile per operator after each window (--profile=N); 0 = off
+    int profile_runs = 0;
+
+    // Benchmark each model's precision variants (scripts/make_variants.py) next to it,
+    // validated against the original (--variants)
+    bool variants = false;
+
+    // Compare the outputs with a CPU fp32 reference after each window (--validate).
+    // reference_model is relative to the models directory (empty = the model under
+    // test); reference_dir keeps the reference outputs as .npy files between runs.
+    bool validate = false;
+    std::string reference_model;
+    std::string reference_dir;
+    double validation_max_abs_error = Config::VALIDATION_MAX_ABS_ERROR;
+    double validation_min_cosine = Config::VALIDATION_MIN_COSINE;
+
+    // Stream every measured iteration to a binary _iterations.bin file
+    bool iteration_log = false;
+
+    // Adaptive warmup (--adaptive-warmup[=CV]): end warmup once the latency CV over
+    // the last warmup_window runs stays below the threshold; 0 = fixed warmup_seconds
+    double warmup_cv_threshold = 0.0;
+    int warmup_window = Config::WARMUP_WINDOW_RUNS;
+
+    // Confidence-interval termination (--ci-target=REL): end the measurement once the
+    // 95% CI of ci_metric is within ±REL of the mean, after ci_min_seconds; 0 = off
+    double ci_target = 0.0;
+    CiMetric ci_metric = CiMetric::Latency;
+    int ci_min_seconds = Config::CI_MIN_MEASUREMENT_SECONDS;
+
+    // Background load during warmup and measurement (--co-run, --stress); each
+    // configuration then runs alone first unless interference_baseline is off
+    std::vector<InterferenceSource> interference;
+    bool interference_baseline = true;
+
+    // Keep up to N sessions warm across the windows of a batch or sweep
+    // (--session-cache=N; 0 = off), within a resident memory budget in MB (0 = unlimited)
+    size_t session_cache_size = 0;
+    int session_cache_budget_mb = Config::SESSION_CACHE_BUDGET_MB;
+};
+
+// Options of the long-lived server mode (--serve=ENDPOINT)
+struct ServeOptions {
+    std::string endpoint;  // "tcp:PORT", "unix:PATH" or "unix:@NAME" (abstract)
+    size_t session_cache_size = Config::SESSION_CACHE_SIZE;  // Sessions kept between jobs
+    int session_cache_budget_mb = Config::SESSION_CACHE_BUDGET_MB;  // Their resident memory; 0 = unlimited
+};
+
+// Print command-line usage to stderr
+void print_usage();
+
+// Whether the first argument selects the server mode
+bool is_serve_command(const std::string &arg);
+
+// Parse the server-mode arguments. On failure returns false and sets error.
+bool parse_serve_options(int argc, char **argv, ServeOptions &options, std::string &error);
+
+// Parse command-line arguments. On failure returns false and sets error.
+bool parse_options(int argc, char **argv, BenchmarkOptions &options, std::string &error);
@@ -0,0 +1,314 @@
+#include "output_validation.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <onnxruntime_cxx_api.h>
+#include "inference_session.hpp"
+#include "tensor_file.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+    // One output of one run, as float
+    struct OutputTensor {
+        std::string name;
+        std::vector<int64_t> shape;
+        std::vector<float> values;
+    };
+
+    float half_to_float(uint16_t half) {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+        uint32_t exponent = (half >> 10) & 0x1fu;
+        uint32_t mantissa = half & 0x3ffu;
+        uint32_t bits = 0;
+        if (exponent == 0x1fu) {
+            bits = sign | 0x7f800000u | (mantissa << 13);  // Inf / NaN
+        } else if (exponent != 0) {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        } else if (mantissa != 0) {
+            // Subnormal: normalize into a float exponent
+            exponent = 113;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+        } else {
+            bits = sign;
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    float bfloat16_to_float(uint16_t bfloat) {
+        const uint32_t bits = static_cast<uint32_t>(bfloat) << 16;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    void convert(const void *data, size_t count, std::vector<float> &values) {
+        const T *typed = static_cast<const T *>(data);
+        values.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = static_cast<float>(typed[i]);
+        }
+    }
+
+    // False for outputs that are not numeric tensors (sequences, maps, strings)
+    bool tensor_to_float(const Ort::Value &value, const std::string &name, OutputTensor &tensor) {
+        if (!value.IsTensor()) {
+            return false;
+        }
+        const auto info = value.GetTensorTypeAndShapeInfo();
+        const size_t count = info.GetElementCount();
+        const void *data = value.GetTensorRawData();
+        tensor.name = name;
+        tensor.shape = info.GetShape();
+        switch (info.GetElementType()) {
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: convert<float>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: convert<double>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: convert<int8_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: convert<uint8_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL: convert<uint8_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: convert<int16_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: convert<uint16_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: convert<int32_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: convert<uint32_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: convert<int64_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: convert<uint64_t>(data, count, tensor.values); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: {
+                const bool is_half = info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+                const uint16_t *bits = static_cast<const uint16_t *>(data);
+                tensor.values.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    tensor.values[i] = is_half ? half_to_float(bits[i]) : bfloat16_to_float(bits[i]);
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    // The outputs of one run of session on sample `sample` of inputs
+    std::vector<OutputTensor> capture_outputs(InferenceSession &session, const std::vector<ModelInput> &inputs,
+                                              size_t sample) {
+        const std::vector<Ort::Value> values = session.run_outputs(inputs, sample);
+        std::vector<OutputTensor> outputs;
+        for (size_t i = 0; i < values.size(); ++i) {
+            OutputTensor tensor;
+            if (tensor_to_float(values[i], session.output_names()[i], tensor)) {
+                outputs.push_back(std::move(tensor));
+            }
+        }
+        return outputs;
+    }
+
+    std::string reference_file(const ValidationSettings &settings, size_t sample, const std::string &output) {
+        std::string name = output;
+        for (auto &c: name) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') {
+                c = '_';
+            }
+        }
+        return (fs::path(settings.reference_dir) /
+                (settings.file_prefix + "_s" + std::to_string(sample) + "_" + name + ".npy")).string();
+    }
+
+    // Float32, C order, NumPy format 1.0; readable by open_tensor_file() and np.load()
+    bool write_npy(const std::string &path, const OutputTensor &tensor, std::string &error) {
+        std::ostringstream shape;
+        shape << "(";
+        for (size_t i = 0; i < tensor.shape.size(); ++i) {
+            shape << (i > 0 ? ", " : "") << tensor.shape[i];
+        }
+        if (tensor.shape.size() == 1) {
+            shape << ",";  // One-element tuple
+        }
+        std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': " + shape.str() + "), }";
+        // Magic (6) + version (2) + length (2) + header + '\n' is a multiple of 64
+        header.append(63 - (10 + header.size()) % 64, ' ');
+        header += '\n';
+
+        std::ofstream file(path, std::ios::binary);
+        const uint16_t header_size = static_cast<uint16_t>(header.size());
+        file.write("\x93NUMPY\x01\x00", 8);
+        file.put(static_cast<char>(header_size & 0xff));
+        file.put(static_cast<char>(header_size >> 8));
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char *>(tensor.values.data()),
+                   static_cast<std::streamsize>(tensor.values.size() * sizeof(float)));
+        if (!file) {
+            error = "Cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    bool read_npy(const std::string &path, const std::string &name, OutputTensor &tensor, std::string &error) {
+        TensorFile file;
+        if (!open_tensor_file(path, file, error)) {
+            return false;
+        }
+        if (!file.is_npy || file.element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            error = path + " is not a float32 .npy file";
+            return false;
+        }
+        tensor.name = name;
+        tensor.shape = file.shape;
+        tensor.values.resize(file.data_size / sizeof(float));
+        std::memcpy(tensor.values.data(), file.mapping->data() + file.data_offset, tensor.values.size() * sizeof(float));
+        return true;
+    }
+
+    // Saved references for every compared output of every sample, or false
+    bool load_references(const ValidationSettings &settings, const std::vector<std::vector<OutputTensor> > &tested,
+                         std::vector<std::vector<OutputTensor> > &reference) {
+        std::error_code ec;
+        for (size_t sample = 0; sample < tested.size(); ++sample) {
+            for (const auto &output: tested[sample]) {
+                if (!fs::exists(reference_file(settings, sample, output.name), ec)) {
+                    return false;
+                }
+            }
+        }
+        reference.assign(tested.size(), {});
+        for (size_t sample = 0; sample < tested.size(); ++sample) {
+            for (const auto &output: tested[sample]) {
+                OutputTensor tensor;
+                std::string error;
+                if (!read_npy(reference_file(settings, sample, output.name), output.name, tensor, error)) {
+                    return false;
+                }
+                reference[sample].push_back(std::move(tensor));
+            }
+        }
+        return true;
+    }
+}
+
+bool validate_outputs(const std::string &model_path, const SessionConfig &config, const InputConfig &input_config,
+                      const ValidationSettings &settings, OutputValidation &validation, std::string &error) {
+    std::vector<std::vector<OutputTensor> > tested;
+    std::vector<std::vector<OutputTensor> > reference;
+    validation.reference = "cpu_fp32" + (settings.reference_name.empty() ? "" : ":" + settings.reference_name);
+    try {
+        InferenceSession session(model_path, config, input_config);
+        // Saved references only hold for reproducible inputs
+        if (!settings.reference_dir.empty() && input_config.seed == 0) {
+            for (const auto &input: session.inputs()) {
+                if (!input.mapping) {
+                    error = "--reference-dir needs --seed: input " + input.name + " is generated";
+                    return false;
+                }
+            }
+        }
+        const size_t samples = std::max<size_t>(1, std::min(settings.samples, dataset_size(session.inputs())));
+        for (size_t sample = 0; sample < samples; ++sample) {
+            tested.push_back(capture_outputs(session, session.inputs(), sample));
+        }
+
+        if (!settings.reference_dir.empty() && load_references(settings, tested, reference)) {
+            validation.reference += ",loaded";
+        } else {
+            // fp32 on the CPU provider; only the threading follows the configuration under test
+            SessionConfig reference_config;
+            reference_config.intra_op_threads = config.intra_op_threads;
+            reference_config.cpu_mask = config.cpu_mask;
+            InferenceSession reference_session(settings.reference_model_path, reference_config, input_config);
+            for (size_t sample = 0; sample < samples; ++sample) {
+                reference.push_back(capture_outputs(reference_session, session.inputs(), sample));
+            }
+            if (!settings.reference_dir.empty()) {
+                std::error_code ec;
+                fs::create_directories(settings.reference_dir, ec);
+                bool saved = true;
+                std::string save_error;
+                for (size_t sample = 0; sample < samples && saved; ++sample) {
+                    for (const auto &output: reference[sample]) {
+                        saved = saved && write_npy(reference_file(settings, sample, output.name), output, save_error);
+                    }
+                }
+                if (saved) {
+                    validation.reference += ",saved";
+                }
+            }
+        }
+    } catch (const Ort::Exception &e) {
+        error = e.what();
+        return false;
+    } catch (const std::exception &e) {
+        error = e.what();
+        return false;
+    }
+
+    double sum_abs_error = 0.0;
+    size_t elements = 0;
+    validation.samples = tested.size();
+    validation.outputs = tested.front().size();
+    validation.max_abs_error = 0.0;
+    validation.min_cosine = 1.0;
+    for (size_t sample = 0; sample < tested.size(); ++sample) {
+        for (const auto &output: tested[sample]) {
+            const auto expected = std::find_if(reference[sample].begin(), reference[sample].end(),
+                                               [&](const OutputTensor &tensor) { return tensor.name == output.name; });
+            if (expected == reference[sample].end()) {
+                error = "Reference has no output '" + output.name + "'";
+                return false;
+            }
+            if (expected->values.size() != output.values.size()) {
+                error = "Output '" + output.name + "' has " + std::to_string(output.values.size()) +
+                        " elements, the reference " + std::to_string(expected->values.size());
+                return false;
+            }
+
+            double dot = 0.0;
+            double norm_tested = 0.0;
+            double norm_expected = 0.0;
+            for (size_t i = 0; i < output.values.size(); ++i) {
+                const double a = output.values[i];
+                const double b = expected->values[i];
+                // NaN where the reference has a number is an infinite error
+                const double abs_error = (std::isnan(a) && std::isnan(b)) ? 0.0
+                                         : (std::isnan(a) || std::isnan(b)) ? std::numeric_limits<double>::infinity()
+                                         : std::fabs(a - b);
+                validation.max_abs_error = std::max(validation.max_abs_error, abs_error);
+                sum_abs_error += abs_error;
+                if (!std::isnan(a) && !std::isnan(b)) {
+                    dot += a * b;
+                    norm_tested += a * a;
+                    norm_expected += b * b;
+                }
+            }
+            elements += output.values.size();
+
+            // Two all-zero outputs agree; one all-zero output does not
+            double cosine = 1.0;
+            if (norm_tested > 0.0 || norm_expected > 0.0) {
+                cosine = (norm_tested > 0.0 && norm_expected > 0.0) ? dot / std::sqrt(norm_tested * norm_expected)
+                                                                     : 0.0;
+            }
+            if (cosine < validation.min_cosine || validation.worst_output.empty()) {
+                validation.min_cosine = std::min(validation.min_cosine, cosine);
+                validation.worst_output = output.name;
+            }
+        }
+    }
+    validation.mean_abs_error = elements > 0 ? sum_abs_error / static_cast<double>(elements) : 0.0;
+    validation.passed = validation.max_abs_error <= settings.max_abs_error && validation.min_cosine >= settings.min_cosine;
+    return true;
+}
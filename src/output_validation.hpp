@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "model_inputs.hpp"
+#include "session_config.hpp"
+
+// What to compare a configuration's outputs with (--validate)
+struct ValidationSettings {
+    // Reference model; the model under test itself, or e.g. the fp32 original of a
+    // quantized variant. It runs on the CPU provider with default session options.
+    std::string reference_model_path;
+    std::string reference_name;  // Reported with the result; empty = the model under test
+
+    // Reference outputs as <reference_dir>/<file_prefix>_s<sample>_<output>.npy: read
+    // if present, written after computing them otherwise; empty = always compute
+    std::string reference_dir;
+    std::string file_prefix;
+
+    size_t samples = 1;  // Dataset samples to compare (generated inputs have one)
+    double max_abs_error = 0.0;
+    double min_cosine = 0.0;
+};
+
+// Error of the outputs under test against the reference, over all outputs and
+// compared samples (-1 = not computed)
+struct OutputValidation {
+    std::string reference;        // "cpu_fp32[:<model>]", with ",saved" / ",loaded" for reference files
+    size_t samples = 0;
+    size_t outputs = 0;           // Tensor outputs compared per sample
+    double max_abs_error = -1.0;
+    double mean_abs_error = -1.0;
+    double min_cosine = -1.0;     // Cosine similarity of the worst output
+    std::string worst_output;     // The output with that similarity
+    bool passed = false;          // Within max_abs_error and min_cosine
+};
+
+// Run model_path with config and the reference configuration on identical inputs
+// (the reference session reads the test session's input tensors), convert every
+// tensor output to float and compare them element-wise. Both sessions are built
+// here, so this can run after the measurement window like the op profile. On
+// failure (missing input, output shape mismatch, ORT error) returns false and
+// sets error.
+bool validate_outputs(const std::string &model_path, const SessionConfig &config, const InputConfig &input_config,
+                      const ValidationSettings &settings, OutputValidation &validation, std::string &error);
@@ -0,0 +1,249 @@
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sstream>
+#include <sys/ioctl.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "cpu_affinity.hpp"
+
+namespace {
+    constexpr int MAX_CPUS = 64;
+
+    long perf_event_open(perf_event_attr *attr, pid_t pid, int cpu, int group_fd, unsigned long flags) {
+        return syscall(__NR_perf_event_open, attr, pid, cpu, group_fd, flags);
+    }
+
+    // Thread ids of this process
+    std::vector<int> process_threads() {
+        std::vector<int> threads;
+        DIR *dir = opendir("/proc/self/task");
+        if (dir == nullptr) {
+            threads.push_back(static_cast<int>(syscall(SYS_gettid)));
+            return threads;
+        }
+        while (const dirent *entry = readdir(dir)) {
+            const int tid = std::atoi(entry->d_name);
+            if (tid > 0) {
+                threads.push_back(tid);
+            }
+        }
+        closedir(dir);
+        return threads;
+    }
+
+    // Counter value extrapolated over the time it was not scheduled on the PMU
+    uint64_t read_scaled(int fd) {
+        uint64_t values[3] = {0, 0, 0};  // value, time enabled, time running
+        if (::read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) {
+            return 0;
+        }
+        if (values[2] < values[1]) {
+            return static_cast<uint64_t>(static_cast<double>(values[0]) * static_cast<double>(values[1]) /
+                                         static_cast<double>(values[2]));
+        }
+        return values[0];
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (const auto &counter: counters_) {
+        close(counter.fd);
+    }
+}
+
+bool PerfCounters::open(uint64_t cpu_mask, std::string &error) {
+    for (uint64_t cluster: read_cpu_clusters()) {
+        if (cpu_mask != 0) {
+            cluster &= cpu_mask;
+        }
+        if (cluster != 0) {
+            clusters_.push_back(cluster);
+        }
+    }
+
+    const Event hardware_events[] = {Event::Cycles, Event::Instructions, Event::CacheMisses, Event::BranchMisses};
+    const Event software_events[] = {Event::TaskClock, Event::ContextSwitches, Event::CpuMigrations};
+    for (const int tid: process_threads()) {
+        for (size_t cluster = 0; cluster < clusters_.size(); ++cluster) {
+            for (int cpu = 0; cpu < MAX_CPUS; ++cpu) {
+                if (!(clusters_[cluster] & (uint64_t{1} << cpu))) {
+                    continue;
+                }
+                for (const Event event: hardware_events) {
+                    if (!open_counter(event, tid, cpu, cluster, error)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        for (const Event event: software_events) {
+            if (!open_counter(event, tid, -1, 0, error)) {
+                return false;
+            }
+        }
+    }
+
+    if (counters_.empty()) {
+        error = "No performance counter is supported";
+        return false;
+    }
+    return true;
+}
+
+bool PerfCounters::open_counter(Event event, int tid, int cpu, size_t cluster, std::string &error) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch (event) {
+        case Event::Cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Event::Instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case Event::CacheMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case Event::BranchMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case Event::TaskClock:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            break;
+        case Event::ContextSwitches:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+            break;
+        case Event::CpuMigrations:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CPU_MIGRATIONS;
+            break;
+    }
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_hv = 1;
+    attr.exclude_kernel = user_space_only_ ? 1 : 0;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    long fd = perf_event_open(&attr, tid, cpu, -1, PERF_FLAG_FD_CLOEXEC);
+    if (fd < 0 && (errno == EACCES || errno == EPERM) && !user_space_only_) {
+        // perf_event_paranoid 2 still allows user-space-only counting
+        user_space_only_ = true;
+        attr.exclude_kernel = 1;
+        fd = perf_event_open(&attr, tid, cpu, -1, PERF_FLAG_FD_CLOEXEC);
+    }
+    if (fd < 0) {
+        if (errno == ESRCH) {
+            return true;  // The thread exited in the meantime
+        }
+        if (errno == EACCES || errno == EPERM || errno == EMFILE || errno == ENFILE) {
+            error = std::string("perf_event_open: ") + std::strerror(errno);
+            return false;
+        }
+        ++failed_;  // Event not supported by this PMU
+        return true;
+    }
+
+    Counter counter;
+    counter.fd = static_cast<int>(fd);
+    counter.event = event;
+    counter.cluster = cluster;
+    counters_.push_back(counter);
+    return true;
+}
+
+void PerfCounters::start() {
+    for (const auto &counter: counters_) {
+        ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+    }
+    // Enables every counter this thread opened in one call
+    prctl(PR_TASK_PERF_EVENTS_ENABLE, 0, 0, 0, 0);
+}
+
+void PerfCounters::stop() {
+    prctl(PR_TASK_PERF_EVENTS_DISABLE, 0, 0, 0, 0);
+}
+
+PerfCounterResults PerfCounters::read() const {
+    PerfCounterResults results;
+    for (const uint64_t cluster: clusters_) {
+        ClusterCounts counts;
+        counts.cpu_mask = cluster;
+        results.clusters.push_back(counts);
+        results.total.cpu_mask |= cluster;
+    }
+
+    for (const auto &counter: counters_) {
+        const uint64_t value = read_scaled(counter.fd);
+        ClusterCounts &cluster = results.clusters[counter.cluster];
+        if (counter.event == Event::Cycles || counter.event == Event::Instructions) {
+            results.has_hardware_counts = true;
+        }
+        switch (counter.event) {
+            case Event::Cycles:
+                cluster.cycles += value;
+                break;
+            case Event::Instructions:
+                cluster.instructions += value;
+                break;
+            case Event::CacheMisses:
+                cluster.cache_misses += value;
+                break;
+            case Event::BranchMisses:
+                cluster.branch_misses += value;
+                break;
+            case Event::TaskClock:
+                results.task_clock_ms += static_cast<double>(value) / 1e6;
+                break;
+            case Event::ContextSwitches:
+                results.context_switches += value;
+                break;
+            case Event::CpuMigrations:
+                results.cpu_migrations += value;
+                break;
+        }
+    }
+
+    for (const auto &cluster: results.clusters) {
+        results.total.cycles += cluster.cycles;
+        results.total.instructions += cluster.instructions;
+        results.total.cache_misses += cluster.cache_misses;
+        results.total.branch_misses += cluster.branch_misses;
+    }
+    return results;
+}
+
+double instructions_per_cycle(const ClusterCounts &counts) {
+    return counts.cycles > 0 ? static_cast<double>(counts.instructions) / static_cast<double>(counts.cycles) : 0.0;
+}
+
+std::string format_cluster_cycles(const PerfCounterResults &results) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < results.clusters.size(); ++i) {
+        oss << (i == 0 ? "" : ";") << format_cpu_mask(results.clusters[i].cpu_mask) << ":"
+                << results.clusters[i].cycles;
+    }
+    return oss.str();
+}
+
+std::string format_cluster_ipc(const PerfCounterResults &results) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < results.clusters.size(); ++i) {
+        oss << (i == 0 ? "" : ";") << format_cpu_mask(results.clusters[i].cpu_mask) << ":"
+                << instructions_per_cycle(results.clusters[i]);
+    }
+    return oss.str();
+}
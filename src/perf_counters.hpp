@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hardware counts of one CPU cluster, scaled for counter multiplexing
+struct ClusterCounts {
+    uint64_t cpu_mask = 0;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+};
+
+struct PerfCounterResults {
+    bool has_hardware_counts = false;  // False if the PMU refused every hardware event
+    std::vector<ClusterCounts> clusters;
+    ClusterCounts total;  // Sum over the clusters (cpu_mask = all counted CPUs)
+
+    // Software events over all threads
+    double task_clock_ms = 0.0;
+    uint64_t context_switches = 0;
+    uint64_t cpu_migrations = 0;
+};
+
+// perf_event_open counters for every thread of this process. Hardware events
+// are opened per (thread, CPU) so that the counts can be attributed to CPU
+// clusters; software events per thread. All counters inherit to threads created
+// after open() (e.g. worker pool threads), and are started and stopped together.
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // Open disabled counters for the threads that exist now, on the CPUs in
+    // cpu_mask (0 = all). Returns false (setting error) if the kernel refuses
+    // them, e.g. because perf_event_paranoid or security.perf_harden forbids it.
+    bool open(uint64_t cpu_mask, std::string &error);
+
+    void start();
+    void stop();
+
+    // Counts between start() and stop()
+    PerfCounterResults read() const;
+
+    // Counters that could not be opened (unsupported events are skipped)
+    size_t failed_counters() const { return failed_; }
+
+    // Whether the kernel only allowed counting user space (perf_event_paranoid 2)
+    bool user_space_only() const { return user_space_only_; }
+
+private:
+    enum class Event {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        TaskClock,
+        ContextSwitches,
+        CpuMigrations
+    };
+
+    struct Counter {
+        int fd = -1;
+        Event event = Event::Cycles;
+        size_t cluster = 0;  // Hardware events only
+    };
+
+    bool open_counter(Event event, int tid, int cpu, size_t cluster, std::string &error);
+
+    std::vector<Counter> counters_;
+    std::vector<uint64_t> clusters_;
+    size_t failed_ = 0;
+    bool user_space_only_ = false;
+};
+
+// Instructions per cycle (0 without cycles)
+double instructions_per_cycle(const ClusterCounts &counts);
+
+// "<cluster mask>:<value>;..." summaries for the performance CSV
+std::string format_cluster_cycles(const PerfCounterResults &results);
+std::string format_cluster_ipc(const PerfCounterResults &results);
@@ -0,0 +1,318 @@
+#include "power_sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+#include "device_telemetry.hpp"
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    constexpr const char *POWER_SUPPLY_DIR = "/sys/class/power_supply";
+    constexpr const char *IIO_DEVICES_DIR = "/sys/bus/iio/devices";
+    constexpr const char *POWERCAP_DIR = "/sys/class/powercap";
+    constexpr const char *RAPL_ZONE_PREFIX = "intel-rapl:";  // AMD's RAPL driver registers these too
+
+    std::string read_line(const std::string &path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    std::vector<std::string> directory_entries(const char *dir_path, const std::string &prefix) {
+        std::vector<std::string> names;
+        DIR *dir = opendir(dir_path);
+        if (dir == nullptr) {
+            return names;
+        }
+        while (const dirent *entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name != "." && name != ".." && name.compare(0, prefix.size(), prefix) == 0) {
+                names.push_back(name);
+            }
+        }
+        closedir(dir);
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    // "battery" on most devices; otherwise the first supply of type Battery
+    std::string find_battery_supply() {
+        const std::string preferred = std::string(POWER_SUPPLY_DIR) + "/battery";
+        if (access((preferred + "/current_now").c_str(), R_OK) == 0) {
+            return preferred;
+        }
+        for (const auto &name: directory_entries(POWER_SUPPLY_DIR, "")) {
+            const std::string path = std::string(POWER_SUPPLY_DIR) + "/" + name;
+            if (read_line(path + "/type") == "Battery" && access((path + "/current_now").c_str(), R_OK) == 0) {
+                return path;
+            }
+        }
+        return "";
+    }
+
+    // "intel-rapl:0" is a package; "intel-rapl:0:1" is a domain inside it
+    bool is_top_level_zone(const std::string &zone) {
+        return zone.find(':') == zone.rfind(':');
+    }
+
+    // The package zones, or the platform zone (psys) where there are none. psys
+    // covers the packages too, so the two are never summed.
+    std::vector<std::string> rapl_package_zones() {
+        std::vector<std::string> packages;
+        std::vector<std::string> platform;
+        for (const auto &zone: directory_entries(POWERCAP_DIR, RAPL_ZONE_PREFIX)) {
+            if (!is_top_level_zone(zone)) {
+                continue;
+            }
+            const std::string name = read_line(std::string(POWERCAP_DIR) + "/" + zone + "/name");
+            (name.compare(0, 7, "package") == 0 ? packages : platform).push_back(zone);
+        }
+        return packages.empty() ? platform : packages;
+    }
+
+    void append_rapl_rails(std::vector<PowerRailEnergy> &rails) {
+        for (const auto &zone: directory_entries(POWERCAP_DIR, RAPL_ZONE_PREFIX)) {
+            const std::string path = std::string(POWERCAP_DIR) + "/" + zone;
+            const std::string energy = read_line(path + "/energy_uj");
+            if (energy.empty()) {
+                continue;  // Not readable (root only on current kernels)
+            }
+            PowerRailEnergy rail;
+            rail.name = read_line(path + "/name");
+            if (!is_top_level_zone(zone)) {
+                const std::string parent = zone.substr(0, zone.rfind(':'));
+                rail.name = read_line(std::string(POWERCAP_DIR) + "/" + parent + "/name") + "/" + rail.name;
+            }
+            rail.energy_uj = std::atof(energy.c_str());
+            rail.range_uj = std::atof(read_line(path + "/max_energy_range_uj").c_str());
+            rails.push_back(rail);
+        }
+    }
+}
+
+std::vector<PowerRailEnergy> read_power_rails() {
+    // Lines look like "CH0(T=473133)[S10M_VDD_TPU], 3564654" (µWs = µJ) after a "t=<ms>" line
+    std::vector<PowerRailEnergy> rails;
+    for (const auto &device: directory_entries(IIO_DEVICES_DIR, "iio:device")) {
+        std::ifstream file(std::string(IIO_DEVICES_DIR) + "/" + device + "/energy_value");
+        std::string line;
+        while (std::getline(file, line)) {
+            const size_t open = line.find('[');
+            const size_t close = line.find(']', open);
+            const size_t comma = line.find(',', close);
+            if (open == std::string::npos || close == std::string::npos || comma == std::string::npos) {
+                continue;
+            }
+            PowerRailEnergy rail;
+            rail.name = line.substr(open + 1, close - open - 1);
+            rail.energy_uj = std::atof(line.c_str() + comma + 1);
+            rails.push_back(rail);
+        }
+    }
+    append_rapl_rails(rails);
+    return rails;
+}
+
+std::string format_rail_energy(const std::vector<PowerRailEnergy> &start, const std::vector<PowerRailEnergy> &end) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const auto &rail: end) {
+        const auto before = std::find_if(start.begin(), start.end(), [&rail](const PowerRailEnergy &candidate) {
+            return candidate.name == rail.name;
+        });
+        if (before == start.end()) {
+            continue;
+        }
+        double energy_uj = rail.energy_uj - before->energy_uj;
+        if (energy_uj < 0.0 && rail.range_uj > 0.0) {
+            energy_uj += rail.range_uj;  // Wrapped once during the window
+        }
+        oss << (first ? "" : ";") << rail.name << ":" << energy_uj / 1e6;
+        first = false;
+    }
+    return oss.str();
+}
+
+PowerSampler::PowerSampler(std::chrono::milliseconds interval)
+    : interval_(interval) {
+}
+
+PowerSampler::~PowerSampler() {
+    stop();
+    if (current_fd_ >= 0) {
+        close(current_fd_);
+    }
+    if (voltage_fd_ >= 0) {
+        close(voltage_fd_);
+    }
+    for (const auto &counter: rapl_) {
+        close(counter.fd);
+    }
+}
+
+bool PowerSampler::open(std::string &error) {
+    const std::string supply = find_battery_supply();
+    if (supply.empty()) {
+        return open_rapl(error);
+    }
+    current_fd_ = ::open((supply + "/current_now").c_str(), O_RDONLY | O_CLOEXEC);
+    voltage_fd_ = ::open((supply + "/voltage_now").c_str(), O_RDONLY | O_CLOEXEC);
+    long long value = 0;
+    if (current_fd_ < 0 || voltage_fd_ < 0 || !read_sysfs_integer(current_fd_, value) ||
+        !read_sysfs_integer(voltage_fd_, value)) {
+        error = "Cannot read current_now / voltage_now of " + supply;
+        return false;
+    }
+    const std::string status = read_line(supply + "/status");
+    charging_ = status == "Charging" || status == "Full";
+    source_ = "fuel_gauge";
+    return true;
+}
+
+bool PowerSampler::open_rapl(std::string &error) {
+    const std::vector<std::string> zones = rapl_package_zones();
+    if (zones.empty()) {
+        error = std::string("No battery with current_now under ") + POWER_SUPPLY_DIR + " and no RAPL zone under " +
+                POWERCAP_DIR;
+        return false;
+    }
+    for (const auto &zone: zones) {
+        const std::string path = std::string(POWERCAP_DIR) + "/" + zone;
+        RaplCounter counter;
+        counter.fd = ::open((path + "/energy_uj").c_str(), O_RDONLY | O_CLOEXEC);
+        if (counter.fd < 0 || !read_sysfs_integer(counter.fd, counter.last_uj)) {
+            if (counter.fd >= 0) {
+                close(counter.fd);
+            }
+            error = "Cannot read " + path + "/energy_uj (root only on current kernels)";
+            return false;
+        }
+        counter.range_uj = std::atoll(read_line(path + "/max_energy_range_uj").c_str());
+        rapl_.push_back(counter);
+    }
+    source_ = "rapl";
+    return true;
+}
+
+void PowerSampler::start() {
+    stopping_ = false;
+    samples_ = 0;
+    energy_j_ = 0.0;
+    sampled_s_ = 0.0;
+    sum_current_ma_ = 0.0;
+    sum_voltage_mv_ = 0.0;
+    peak_w_ = -1.0;
+    thread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        do {
+            sample();
+        } while (!stop_requested_.wait_for(lock, interval_, [this]() { return stopping_; }));
+    });
+}
+
+void PowerSampler::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stop_requested_.notify_one();
+    thread_.join();
+    sample();  // The end of the window counts too
+}
+
+PowerSummary PowerSampler::summary() const {
+    PowerSummary summary;
+    summary.source = source_;
+    summary.samples = samples_;
+    if (samples_ == 0) {
+        return summary;
+    }
+    const double samples = static_cast<double>(samples_);
+    summary.mean_w = sampled_s_ > 0.0 ? energy_j_ / sampled_s_ : last_power_w_;
+    summary.peak_w = peak_w_;
+    if (rapl_.empty()) {
+        summary.mean_current_ma = sum_current_ma_ / samples;
+        summary.mean_voltage_mv = sum_voltage_mv_ / samples;
+    }
+    return summary;
+}
+
+double PowerSampler::energy_j() const {
+    // The sampling thread holds the lock except while it waits
+    std::lock_guard<std::mutex> lock(mutex_);
+    return energy_j_;
+}
+
+void PowerSampler::sample() {
+    if (!rapl_.empty()) {
+        sample_rapl();
+        return;
+    }
+    long long current_ua = 0;
+    long long voltage_uv = 0;
+    if (!read_sysfs_integer(current_fd_, current_ua) || !read_sysfs_integer(voltage_fd_, voltage_uv)) {
+        return;
+    }
+    const auto now = clock::now();
+
+    // The sign of current_now on discharge differs between gauges
+    const double current_ma = std::fabs(static_cast<double>(current_ua)) / 1000.0;
+    const double voltage_mv = static_cast<double>(voltage_uv) / 1000.0;
+    const double power_w = voltage_mv * current_ma / 1e6;
+
+    // Trapezoidal integration between consecutive readings
+    if (samples_ > 0) {
+        const double dt_s = std::chrono::duration<double>(now - last_time_).count();
+        energy_j_ += 0.5 * (power_w + last_power_w_) * dt_s;
+        sampled_s_ += dt_s;
+    }
+    last_time_ = now;
+    last_power_w_ = power_w;
+    ++samples_;
+    sum_current_ma_ += current_ma;
+    sum_voltage_mv_ += voltage_mv;
+    peak_w_ = std::max(peak_w_, power_w);
+}
+
+void PowerSampler::sample_rapl() {
+    for (auto &counter: rapl_) {
+        if (!read_sysfs_integer(counter.fd, counter.reading_uj)) {
+            return;
+        }
+    }
+    const auto now = clock::now();
+
+    // The counters already integrate energy; only their difference is needed
+    long long energy_uj = 0;
+    for (auto &counter: rapl_) {
+        long long delta_uj = counter.reading_uj - counter.last_uj;
+        if (delta_uj < 0) {
+            delta_uj += counter.range_uj;
+        }
+        energy_uj += delta_uj;
+        counter.last_uj = counter.reading_uj;
+    }
+    if (samples_ > 0) {
+        const double dt_s = std::chrono::duration<double>(now - last_time_).count();
+        energy_j_ += static_cast<double>(energy_uj) / 1e6;
+        sampled_s_ += dt_s;
+        if (dt_s > 0.0) {
+            last_power_w_ = static_cast<double>(energy_uj) / 1e6 / dt_s;
+            peak_w_ = std::max(peak_w_, last_power_w_);
+        }
+    }
+    last_time_ = now;
+    ++samples_;
+}
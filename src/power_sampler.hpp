@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Power over one sampling window (-1 = not sampled)
+struct PowerSummary {
+    std::string source;    // "fuel_gauge" or "rapl"; empty = not sampled
+    uint64_t samples = 0;
+    double mean_w = -1.0;  // Time-weighted over the sampled span
+    double peak_w = -1.0;
+    double mean_current_ma = -1.0;  // Fuel gauge only
+    double mean_voltage_mv = -1.0;
+};
+
+// Cumulative energy of one rail of the on-device power monitor or one RAPL domain
+struct PowerRailEnergy {
+    std::string name;
+    double energy_uj = 0.0;
+    double range_uj = 0.0;  // The counter wraps to 0 here (RAPL); 0 = does not wrap
+};
+
+// Rails of the on-device power monitor (ODPM on Pixel 6 and later, read from
+// /sys/bus/iio/devices/iio:device*/energy_value), and the RAPL domains of a
+// Linux host (/sys/class/powercap/intel-rapl:*, e.g. "package-0",
+// "package-0/core", "package-0/dram"); empty where there are none
+std::vector<PowerRailEnergy> read_power_rails();
+
+// "<rail>:<joules>;..." for the rails present in both readings
+std::string format_rail_energy(const std::vector<PowerRailEnergy> &start, const std::vector<PowerRailEnergy> &end);
+
+// Samples the fuel gauge (voltage_now and current_now of the battery power
+// supply) on a background thread and integrates power in place, so the
+// window's energy needs neither a batterystats dump nor any storage per sample.
+// Where there is no battery, as on a Linux host, it reads the RAPL package
+// energy counters instead, which the CPU integrates itself.
+class PowerSampler {
+public:
+    explicit PowerSampler(std::chrono::milliseconds interval);
+    ~PowerSampler();
+
+    PowerSampler(const PowerSampler &) = delete;
+    PowerSampler &operator=(const PowerSampler &) = delete;
+
+    // Find and open the battery's sysfs files, else the RAPL packages. Returns
+    // false (setting error) if neither is readable.
+    bool open(std::string &error);
+
+    // Whether the battery reported Charging or Full when opened; the gauge then
+    // measures the charger's current too
+    bool charging() const { return charging_; }
+
+    void start();
+    void stop();
+
+    // Valid after stop()
+    PowerSummary summary() const;
+
+    // Energy integrated since start(), while sampling
+    double energy_j() const;
+
+private:
+    struct RaplCounter {
+        int fd = -1;              // energy_uj of one package
+        long long range_uj = 0;   // max_energy_range_uj
+        long long reading_uj = 0;
+        long long last_uj = 0;
+    };
+
+    bool open_rapl(std::string &error);
+    void sample();
+    void sample_rapl();
+
+    std::chrono::milliseconds interval_;
+    std::string source_;
+    int current_fd_ = -1;  // µA
+    int voltage_fd_ = -1;  // µV
+    bool charging_ = false;
+    std::vector<RaplCounter> rapl_;
+
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable stop_requested_;
+    bool stopping_ = false;
+
+    std::chrono::steady_clock::time_point last_time_;
+    double last_power_w_ = 0.0;
+    double energy_j_ = 0.0;
+    double sampled_s_ = 0.0;
+    uint64_t samples_ = 0;
+    double sum_current_ma_ = 0.0;
+    double sum_voltage_mv_ = 0.0;
+    double peak_w_ = -1.0;
+};
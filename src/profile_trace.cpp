@@ -0,0 +1,58 @@
+#include "profile_trace.hpp"
+
+#include "json.hpp"
+
+namespace {
+    constexpr const char *KERNEL_TIME_SUFFIX = "_kernel_time";
+
+    bool ends_with(const std::string &text, const std::string &suffix) {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+bool load_profile_trace(const std::string &path, ProfileTrace &trace, std::string &error) {
+    JsonValue root;
+    if (!parse_json_file(path, root, error)) {
+        return false;
+    }
+    if (!root.is_array()) {
+        error = "Profile trace is not a JSON array";
+        return false;
+    }
+
+    for (const auto &event: root.items()) {
+        const std::string &category = event.get("cat").as_string();
+        const std::string &name = event.get("name").as_string();
+        const double start_us = event.get("ts").as_number();
+        const double duration_us = event.get("dur").as_number();
+
+        if (category == "Session") {
+            trace.session_events.push_back({name, start_us, duration_us});
+            continue;
+        }
+        if (category != "Node" || !ends_with(name, KERNEL_TIME_SUFFIX)) {
+            continue;
+        }
+
+        const JsonValue &args = event.get("args");
+        ProfileNodeEvent node;
+        node.node_name = name.substr(0, name.size() - std::string(KERNEL_TIME_SUFFIX).size());
+        node.op_type = args.get("op_name").as_string();
+        node.provider = args.get("provider").as_string();
+        node.start_us = start_us;
+        node.duration_us = duration_us;
+        trace.nodes.push_back(std::move(node));
+    }
+    return true;
+}
+
+double session_event_us(const ProfileTrace &trace, const std::string &name) {
+    double total_us = 0.0;
+    for (const auto &event: trace.session_events) {
+        if (event.name == name) {
+            total_us += event.duration_us;
+        }
+    }
+    return total_us;
+}
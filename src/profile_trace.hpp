@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// One kernel execution from an ONNX Runtime profiling trace
+struct ProfileNodeEvent {
+    std::string node_name;
+    std::string op_type;
+    std::string provider;
+    double start_us = 0.0;  // Since profiling started
+    double duration_us = 0.0;
+};
+
+// One session-level event (model loading, session initialization, ...)
+struct ProfileSessionEvent {
+    std::string name;
+    double start_us = 0.0;
+    double duration_us = 0.0;
+};
+
+struct ProfileTrace {
+    std::vector<ProfileNodeEvent> nodes;
+    std::vector<ProfileSessionEvent> session_events;
+};
+
+// Total duration of the session events with the given name (0 if absent)
+double session_event_us(const ProfileTrace &trace, const std::string &name);
+
+// Parse the JSON file written by Ort::Session::EndProfilingAllocated().
+// Only kernel executions ("<node>_kernel_time" events) are kept as node events.
+bool load_profile_trace(const std::string &path, ProfileTrace &trace, std::string &error);
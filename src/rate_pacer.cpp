@@ -0,0 +1,36 @@
+#include "rate_pacer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include "config.hpp"
+
+RatePacer::RatePacer(double rate_hz, clock::time_point start)
+    : start_(start),
+      period_(std::max(clock::duration(1), std::chrono::duration_cast<clock::duration>(
+          std::chrono::duration<double>(1.0 / rate_hz)))) {
+}
+
+bool valid_request_rate(double rate_hz) {
+    return std::isfinite(rate_hz) && rate_hz >= Config::MIN_REQUEST_RATE_HZ &&
+           rate_hz <= Config::MAX_REQUEST_RATE_HZ;
+}
+
+RatePacer::clock::time_point RatePacer::wait() {
+    const clock::time_point scheduled = advance();
+    if (clock::now() < scheduled) {
+        sleep_until_absolute(scheduled);
+    }
+    return scheduled;
+}
+
+void sleep_until_absolute(RatePacer::clock::time_point deadline) {
+    // steady_clock is CLOCK_MONOTONIC, so its epoch is the one clock_nanosleep expects
+    const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(since_epoch.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(since_epoch.count() % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Fixed-rate schedule for open-loop load (--target-rate). Request k is due at
+// start + k * period regardless of when earlier requests finished, so a slow
+// inference delays the ones behind it instead of stretching the schedule.
+class RatePacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // rate_hz within [Config::MIN_REQUEST_RATE_HZ, Config::MAX_REQUEST_RATE_HZ]
+    // (see valid_request_rate); the period is at least one clock tick regardless
+    RatePacer(double rate_hz, clock::time_point start);
+
+    clock::duration period() const { return period_; }
+
+    // Scheduled time of the next request
+    clock::time_point next() const { return start_ + period_ * index_; }
+
+    // Sleep until the next request is due and return its scheduled time. Returns
+    // immediately if the schedule is already behind.
+    clock::time_point wait();
+
+    // Take the next request's scheduled time without sleeping, for callers that
+    // must stay responsive while they wait for it
+    clock::time_point advance() { return start_ + period_ * index_++; }
+
+    // A request misses its deadline if it finishes after the next one is due
+    bool missed(clock::time_point scheduled, clock::time_point finished) const {
+        return finished > scheduled + period_;
+    }
+
+private:
+    clock::time_point start_;
+    clock::duration period_;
+    int64_t index_ = 0;
+};
+
+// Whether a request rate in Hz is finite and within the bounds a schedule can represent
+bool valid_request_rate(double rate_hz);
+
+// Sleep until an absolute steady_clock time with clock_nanosleep(TIMER_ABSTIME),
+// so wake-ups do not drift by the time spent between iterations
+void sleep_until_absolute(RatePacer::clock::time_point deadline);
@@ -0,0 +1,427 @@
+#include "results_csv.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "config.hpp"
+#include "device_identity.hpp"
+#include "runner_paths.hpp"
+
+namespace {
+    // Empty field for metrics that were not collected (negative)
+    std::string optional_metric(double value) {
+        if (value < 0.0) {
+            return "";
+        }
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(Config::FLOAT_PRECISION) << value;
+        return oss.str();
+    }
+
+    std::string optional_metric(int64_t value) {
+        return value < 0 ? "" : std::to_string(value);
+    }
+
+    // Significant digits instead of fixed decimals: output errors of 1e-5 and
+    // cosines of 0.99999 would round to 0.000 and 1.000
+    std::string precise_metric(double value) {
+        std::ostringstream oss;
+        oss << std::setprecision(9) << value;
+        return oss.str();
+    }
+}
+
+std::string get_current_timestamp() {
+    auto now = std::chrono::system_clock::now();
+    auto time_t_now = std::chrono::system_clock::to_time_t(now);
+    std::tm tm_now{};
+
+    if (localtime_r(&time_t_now, &tm_now) == nullptr) {
+        std::cerr << "Warning: Failed to get local time, using epoch\n";
+        return "19700101_000000";
+    }
+
+    std::ostringstream oss;
+    oss << std::put_time(&tm_now, "%Y%m%d_%H%M%S");
+    return oss.str();
+}
+
+std::string sanitize_filename(const std::string &filename) {
+    std::string sanitized = filename;
+    std::replace(sanitized.begin(), sanitized.end(), '/', '_');
+    std::replace(sanitized.begin(), sanitized.end(), '\\', '_');
+    return sanitized;
+}
+
+std::string measurement_file_path(const std::string &name, const std::string &timestamp,
+                                  const std::string &suffix) {
+    return measurements_dir() + "/" + sanitize_filename(name) + "_" +
+           timestamp + suffix;
+}
+
+void write_performance_csv_header(std::ostream &out) {
+    out << "model" << Config::CSV_DELIMITER
+            << "timestamp" << Config::CSV_DELIMITER
+            << "load_mode" << Config::CSV_DELIMITER
+            << "intra_op_threads" << Config::CSV_DELIMITER
+            << "inter_op_threads" << Config::CSV_DELIMITER
+            << "execution_mode" << Config::CSV_DELIMITER
+            << "allow_spinning" << Config::CSV_DELIMITER
+            << "graph_optimization_level" << Config::CSV_DELIMITER
+            << "mem_pattern" << Config::CSV_DELIMITER
+            << "cpu_arena" << Config::CSV_DELIMITER
+            << "shared_arena" << Config::CSV_DELIMITER
+            << "session_config_entries" << Config::CSV_DELIMITER
+            << "cpu_mask" << Config::CSV_DELIMITER
+            << "execution_provider" << Config::CSV_DELIMITER
+            << "workers" << Config::CSV_DELIMITER
+            << "worker_sessions" << Config::CSV_DELIMITER
+            << "target_rate_hz" << Config::CSV_DELIMITER
+            << "nnapi_flags" << Config::CSV_DELIMITER
+            << "provider_node_counts" << Config::CSV_DELIMITER
+            << "top_op_types" << Config::CSV_DELIMITER
+            << "dim_overrides" << Config::CSV_DELIMITER
+            << "input_shapes" << Config::CSV_DELIMITER
+            << "samples_per_inference" << Config::CSV_DELIMITER
+            << "dataset_samples" << Config::CSV_DELIMITER
+            << "measurement_iterations" << Config::CSV_DELIMITER
+            << "measurement_elapsed_ms" << Config::CSV_DELIMITER
+            << "ci_metric" << Config::CSV_DELIMITER
+            << "ci_target" << Config::CSV_DELIMITER
+            << "ci_mean" << Config::CSV_DELIMITER
+            << "ci_low" << Config::CSV_DELIMITER
+            << "ci_high" << Config::CSV_DELIMITER
+            << "ci_relative_half_width" << Config::CSV_DELIMITER
+            << "ci_batches" << Config::CSV_DELIMITER
+            << "ci_reached" << Config::CSV_DELIMITER
+            << "validation_reference" << Config::CSV_DELIMITER
+            << "validation_max_abs_error" << Config::CSV_DELIMITER
+            << "validation_mean_abs_error" << Config::CSV_DELIMITER
+            << "validation_min_cosine" << Config::CSV_DELIMITER
+            << "validation_worst_output" << Config::CSV_DELIMITER
+            << "validation_passed" << Config::CSV_DELIMITER
+            << "interference" << Config::CSV_DELIMITER
+            << "interference_load" << Config::CSV_DELIMITER
+            << "interference_baseline_window" << Config::CSV_DELIMITER
+            << "interference_p50_ratio" << Config::CSV_DELIMITER
+            << "interference_p99_ratio" << Config::CSV_DELIMITER
+            << "interference_energy_ratio" << Config::CSV_DELIMITER
+            << "us_per_inference" << Config::CSV_DELIMITER
+            << "total_time_sec" << Config::CSV_DELIMITER
+            << "us_per_sample" << Config::CSV_DELIMITER
+            << "samples_per_second" << Config::CSV_DELIMITER
+            << "warmup_iterations" << Config::CSV_DELIMITER
+            << "warmup_elapsed_ms" << Config::CSV_DELIMITER
+            << "warmup_converged" << Config::CSV_DELIMITER
+            << "warmup_converged_iterations" << Config::CSV_DELIMITER
+            << "warmup_cv" << Config::CSV_DELIMITER
+            << "model_source" << Config::CSV_DELIMITER
+            << "model_variant" << Config::CSV_DELIMITER
+            << "model_hash" << Config::CSV_DELIMITER
+            << "device_model" << Config::CSV_DELIMITER
+            << "soc" << Config::CSV_DELIMITER
+            << "build_fingerprint" << Config::CSV_DELIMITER
+            << "ort_version" << Config::CSV_DELIMITER
+            << "model_load_method" << Config::CSV_DELIMITER
+            << "optimized_model_saved" << Config::CSV_DELIMITER
+            << "session_reused" << Config::CSV_DELIMITER
+            << "setup_saved_ms" << Config::CSV_DELIMITER
+            << "session_cache_entries" << Config::CSV_DELIMITER
+            << "session_cache_kb" << Config::CSV_DELIMITER
+            << "session_cache_hits" << Config::CSV_DELIMITER
+            << "session_cache_misses" << Config::CSV_DELIMITER
+            << "session_cache_evictions" << Config::CSV_DELIMITER
+            << "session_cache_saved_ms" << Config::CSV_DELIMITER
+            << "setup_ms" << Config::CSV_DELIMITER
+            << "file_read_ms" << Config::CSV_DELIMITER
+            << "session_create_ms" << Config::CSV_DELIMITER
+            << "input_prep_ms" << Config::CSV_DELIMITER
+            << "first_run_ms" << Config::CSV_DELIMITER
+            << "model_load_ms" << Config::CSV_DELIMITER
+            << "session_init_ms" << Config::CSV_DELIMITER
+            << "latency_mean_us" << Config::CSV_DELIMITER
+            << "latency_stddev_us" << Config::CSV_DELIMITER
+            << "latency_min_us" << Config::CSV_DELIMITER
+            << "latency_p50_us" << Config::CSV_DELIMITER
+            << "latency_p90_us" << Config::CSV_DELIMITER
+            << "latency_p99_us" << Config::CSV_DELIMITER
+            << "latency_p999_us" << Config::CSV_DELIMITER
+            << "latency_max_us" << Config::CSV_DELIMITER
+            << "busy_fraction" << Config::CSV_DELIMITER
+            << "missed_deadlines" << Config::CSV_DELIMITER
+            << "queue_delay_mean_us" << Config::CSV_DELIMITER
+            << "queue_delay_p50_us" << Config::CSV_DELIMITER
+            << "queue_delay_p99_us" << Config::CSV_DELIMITER
+            << "queue_delay_max_us" << Config::CSV_DELIMITER
+            << "prep_mode" << Config::CSV_DELIMITER
+            << "prep_passes" << Config::CSV_DELIMITER
+            << "prep_mean_us" << Config::CSV_DELIMITER
+            << "prep_stall_mean_us" << Config::CSV_DELIMITER
+            << "e2e_latency_mean_us" << Config::CSV_DELIMITER
+            << "e2e_latency_p50_us" << Config::CSV_DELIMITER
+            << "e2e_latency_p99_us" << Config::CSV_DELIMITER
+            << "rss_before_setup_kb" << Config::CSV_DELIMITER
+            << "rss_after_setup_kb" << Config::CSV_DELIMITER
+            << "rss_after_warmup_kb" << Config::CSV_DELIMITER
+            << "rss_measurement_mean_kb" << Config::CSV_DELIMITER
+            << "rss_measurement_peak_kb" << Config::CSV_DELIMITER
+            << "vm_hwm_kb" << Config::CSV_DELIMITER
+            << "allocations_per_run" << Config::CSV_DELIMITER
+            << "allocated_bytes_per_run" << Config::CSV_DELIMITER
+            << "perf_ipc" << Config::CSV_DELIMITER
+            << "perf_cycles_per_inference" << Config::CSV_DELIMITER
+            << "perf_instructions_per_inference" << Config::CSV_DELIMITER
+            << "perf_cache_misses_per_inference" << Config::CSV_DELIMITER
+            << "perf_branch_misses_per_inference" << Config::CSV_DELIMITER
+            << "perf_cache_mpki" << Config::CSV_DELIMITER
+            << "perf_task_clock_ms" << Config::CSV_DELIMITER
+            << "perf_context_switches" << Config::CSV_DELIMITER
+            << "perf_cpu_migrations" << Config::CSV_DELIMITER
+            << "perf_cluster_cycles" << Config::CSV_DELIMITER
+            << "perf_cluster_ipc" << Config::CSV_DELIMITER
+            << "cluster_freq_mhz" << Config::CSV_DELIMITER
+            << "throttled_fraction" << Config::CSV_DELIMITER
+            << "temp_start_c" << Config::CSV_DELIMITER
+            << "temp_max_c" << Config::CSV_DELIMITER
+            << "power_source" << Config::CSV_DELIMITER
+            << "power_samples" << Config::CSV_DELIMITER
+            << "power_mean_w" << Config::CSV_DELIMITER
+            << "power_peak_w" << Config::CSV_DELIMITER
+            << "current_mean_ma" << Config::CSV_DELIMITER
+            << "voltage_mean_mv" << Config::CSV_DELIMITER
+            << "window_energy_j" << Config::CSV_DELIMITER
+            << "energy_per_inference_mj" << Config::CSV_DELIMITER
+            << "rail_energy_j" << Config::CSV_DELIMITER
+            << "iteration_log_dropped" << Config::CSV_DELIMITER
+            << "config_index" << Config::CSV_DELIMITER
+            << "batterystats_file" << Config::CSV_DELIMITER
+            << "stats_reset_epoch_ms" << Config::CSV_DELIMITER
+            << "measurement_start_epoch_ms" << Config::CSV_DELIMITER
+            << "measurement_end_epoch_ms" << "\n";
+}
+
+void write_performance_csv_row(std::ostream &out, const std::string &timestamp, const BenchmarkResult &result) {
+    out << std::fixed << std::setprecision(Config::FLOAT_PRECISION);
+    const BenchmarkCase &bench_case = result.bench_case;
+    const SessionConfig &session_config = bench_case.session;
+    const LatencyHistogram &latency = *result.latency;
+    const LatencyHistogram &queue_delay = *result.queue_delay;
+    const bool paced = bench_case.target_rate_hz > 0.0;
+    const bool prepared = bench_case.prep_mode != PrepMode::None;
+    const DeviceIdentity &identity = device_identity();
+    const bool hardware_counts = result.perf_collected && result.perf.has_hardware_counts;
+    const bool adaptive_warmup = bench_case.warmup_cv_threshold > 0.0;
+    const ConfidenceInterval &ci = result.ci;
+    const bool ci_valid = result.ci_collected && ci.relative_half_width >= 0.0;
+    const bool cache_used = result.session_cache_used;
+    const bool validated = result.validation_collected;
+    const OutputValidation &validation = result.validation;
+    const SessionCacheStats &cache = result.session_cache;
+    const ClusterCounts &perf_total = result.perf.total;
+    const double iterations = static_cast<double>(result.measurement_iterations);
+    const auto per_inference = [&](uint64_t count) {
+        return hardware_counts && iterations > 0.0 ? static_cast<double>(count) / iterations : -1.0;
+    };
+    const size_t slash = bench_case.batterystats_file.find_last_of('/');
+    const std::string batterystats_name = slash == std::string::npos
+                                              ? bench_case.batterystats_file
+                                              : bench_case.batterystats_file.substr(slash + 1);
+
+    out << bench_case.model_filename << Config::CSV_DELIMITER
+            << timestamp << Config::CSV_DELIMITER
+            << (bench_case.cold_load ? "cold" : "warm") << Config::CSV_DELIMITER
+            << session_config.intra_op_threads << Config::CSV_DELIMITER
+            << session_config.inter_op_threads << Config::CSV_DELIMITER
+            << execution_mode_name(session_config.execution_mode) << Config::CSV_DELIMITER
+            << (session_config.allow_spinning ? 1 : 0) << Config::CSV_DELIMITER
+            << graph_optimization_level_name(session_config.graph_optimization_level) << Config::CSV_DELIMITER
+            << (session_config.mem_pattern ? 1 : 0) << Config::CSV_DELIMITER
+            << (session_config.cpu_arena ? 1 : 0) << Config::CSV_DELIMITER
+            << (session_config.shared_arena ? 1 : 0) << Config::CSV_DELIMITER
+            << config_entries_name(session_config) << Config::CSV_DELIMITER
+            << cpu_mask_name(session_config.cpu_mask) << Config::CSV_DELIMITER
+            << execution_provider_name(session_config.execution_provider) << Config::CSV_DELIMITER
+            << bench_case.workers << Config::CSV_DELIMITER
+            << (bench_case.per_worker_sessions ? "per_worker" : "shared") << Config::CSV_DELIMITER
+            << optional_metric(paced ? bench_case.target_rate_hz : -1.0) << Config::CSV_DELIMITER
+            << (session_config.execution_provider == ExecutionProvider::Nnapi
+                    ? nnapi_flags_name(session_config) : "") << Config::CSV_DELIMITER
+            << result.provider_node_counts << Config::CSV_DELIMITER
+            << result.top_op_types << Config::CSV_DELIMITER
+            << format_dim_overrides(bench_case.inputs.dim_overrides) << Config::CSV_DELIMITER
+            << result.input_shapes << Config::CSV_DELIMITER
+            << result.samples_per_inference << Config::CSV_DELIMITER
+            << result.dataset_samples << Config::CSV_DELIMITER
+            << result.measurement_iterations << Config::CSV_DELIMITER
+            << result.measurement_elapsed_ms << Config::CSV_DELIMITER
+            << (result.ci_collected ? ci_metric_name(result.ci_metric) : "") << Config::CSV_DELIMITER
+            << optional_metric(result.ci_collected ? bench_case.ci_target : -1.0) << Config::CSV_DELIMITER
+            << optional_metric(ci_valid ? ci.mean : -1.0) << Config::CSV_DELIMITER
+            << (ci_valid ? optional_metric(std::max(ci.low, 0.0)) : "") << Config::CSV_DELIMITER
+            << optional_metric(ci_valid ? ci.high : -1.0) << Config::CSV_DELIMITER
+            << optional_metric(ci_valid ? ci.relative_half_width : -1.0) << Config::CSV_DELIMITER
+            << (result.ci_collected ? std::to_string(ci.batches) : "") << Config::CSV_DELIMITER
+            << (result.ci_collected ? std::to_string(result.ci_reached ? 1 : 0) : "") << Config::CSV_DELIMITER
+            << (validated ? validation.reference : "") << Config::CSV_DELIMITER
+            << (validated ? precise_metric(validation.max_abs_error) : "") << Config::CSV_DELIMITER
+            << (validated ? precise_metric(validation.mean_abs_error) : "") << Config::CSV_DELIMITER
+            << (validated ? precise_metric(validation.min_cosine) : "") << Config::CSV_DELIMITER
+            << (validated ? validation.worst_output : "") << Config::CSV_DELIMITER
+            << (validated ? std::to_string(validation.passed ? 1 : 0) : "") << Config::CSV_DELIMITER
+            << (bench_case.interference_baseline ? "alone" : format_interference(bench_case.interference))
+            << Config::CSV_DELIMITER
+            << result.interference_load << Config::CSV_DELIMITER
+            << optional_metric(static_cast<int64_t>(bench_case.interference_baseline_window)) << Config::CSV_DELIMITER
+            << optional_metric(result.interference_p50_ratio) << Config::CSV_DELIMITER
+            << optional_metric(result.interference_p99_ratio) << Config::CSV_DELIMITER
+            << optional_metric(result.interference_energy_ratio) << Config::CSV_DELIMITER
+            << result.us_per_inference << Config::CSV_DELIMITER
+            << result.total_time_sec << Config::CSV_DELIMITER
+            << result.us_per_sample << Config::CSV_DELIMITER
+            << result.samples_per_second << Config::CSV_DELIMITER
+            << result.warmup_iterations << Config::CSV_DELIMITER
+            << result.warmup_elapsed_ms << Config::CSV_DELIMITER
+            << (adaptive_warmup ? std::to_string(result.warmup_converged ? 1 : 0) : "") << Config::CSV_DELIMITER
+            << (adaptive_warmup && result.warmup_converged ? std::to_string(result.warmup_converged_iterations) : "")
+            << Config::CSV_DELIMITER
+            << optional_metric(adaptive_warmup ? result.warmup_cv : -1.0) << Config::CSV_DELIMITER
+            << result.model_source << Config::CSV_DELIMITER
+            << bench_case.model_variant << Config::CSV_DELIMITER
+            << result.model_hash << Config::CSV_DELIMITER
+            << identity.device_model << Config::CSV_DELIMITER
+            << identity.soc << Config::CSV_DELIMITER
+            << identity.build_fingerprint << Config::CSV_DELIMITER
+            << identity.ort_version << Config::CSV_DELIMITER
+            << load_mode_name(session_config.load_mode) << Config::CSV_DELIMITER
+            << (result.optimized_model_saved ? 1 : 0) << Config::CSV_DELIMITER
+            << (result.session_reused ? 1 : 0) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? result.setup_saved_ms : -1.0) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? static_cast<int64_t>(cache.entries) : -1) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? cache.resident_kb : -1) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? static_cast<int64_t>(cache.hits) : -1) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? static_cast<int64_t>(cache.misses) : -1) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? static_cast<int64_t>(cache.evictions) : -1) << Config::CSV_DELIMITER
+            << optional_metric(cache_used ? cache.setup_saved_ms : -1.0) << Config::CSV_DELIMITER
+            << result.setup_ms << Config::CSV_DELIMITER
+            << result.startup.file_read_ms << Config::CSV_DELIMITER
+            << result.startup.session_create_ms << Config::CSV_DELIMITER
+            << result.startup.input_prep_ms << Config::CSV_DELIMITER
+            << result.startup.first_run_ms << Config::CSV_DELIMITER
+            << optional_metric(result.model_load_ms) << Config::CSV_DELIMITER
+            << optional_metric(result.session_init_ms) << Config::CSV_DELIMITER
+            << ns_to_us(latency.mean_ns()) << Config::CSV_DELIMITER
+            << ns_to_us(latency.stddev_ns()) << Config::CSV_DELIMITER
+            << ns_to_us(static_cast<double>(latency.min_ns())) << Config::CSV_DELIMITER
+            << ns_to_us(static_cast<double>(latency.percentile_ns(50.0))) << Config::CSV_DELIMITER
+            << ns_to_us(static_cast<double>(latency.percentile_ns(90.0))) << Config::CSV_DELIMITER
+            << ns_to_us(static_cast<double>(latency.percentile_ns(99.0))) << Config::CSV_DELIMITER
+            << ns_to_us(static_cast<double>(latency.percentile_ns(99.9))) << Config::CSV_DELIMITER
+            << ns_to_us(static_cast<double>(latency.max_ns())) << Config::CSV_DELIMITER
+            << result.busy_fraction << Config::CSV_DELIMITER
+            << (paced ? std::to_string(result.missed_deadlines) : "") << Config::CSV_DELIMITER
+            << optional_metric(paced ? ns_to_us(queue_delay.mean_ns()) : -1.0) << Config::CSV_DELIMITER
+            << optional_metric(paced ? ns_to_us(static_cast<double>(queue_delay.percentile_ns(50.0))) : -1.0)
+            << Config::CSV_DELIMITER
+            << optional_metric(paced ? ns_to_us(static_cast<double>(queue_delay.percentile_ns(99.0))) : -1.0)
+            << Config::CSV_DELIMITER
+            << optional_metric(paced ? ns_to_us(static_cast<double>(queue_delay.max_ns())) : -1.0)
+            << Config::CSV_DELIMITER
+            << prep_mode_name(bench_case.prep_mode) << Config::CSV_DELIMITER
+            << (prepared ? std::to_string(bench_case.prep_passes) : "") << Config::CSV_DELIMITER
+            << optional_metric(result.prep_mean_us) << Config::CSV_DELIMITER
+            << optional_metric(result.prep_stall_mean_us) << Config::CSV_DELIMITER
+            << optional_metric(result.e2e_latency_mean_us) << Config::CSV_DELIMITER
+            << optional_metric(result.e2e_latency_p50_us) << Config::CSV_DELIMITER
+            << optional_metric(result.e2e_latency_p99_us) << Config::CSV_DELIMITER
+            << optional_metric(result.rss_before_setup_kb) << Config::CSV_DELIMITER
+            << optional_metric(result.rss_after_setup_kb) << Config::CSV_DELIMITER
+            << optional_metric(result.rss_after_warmup_kb) << Config::CSV_DELIMITER
+            << optional_metric(result.rss_measurement_mean_kb) << Config::CSV_DELIMITER
+            << optional_metric(result.rss_measurement_peak_kb) << Config::CSV_DELIMITER
+            << optional_metric(result.vm_hwm_kb) << Config::CSV_DELIMITER
+            << optional_metric(result.allocations_per_run) << Config::CSV_DELIMITER
+            << optional_metric(result.allocated_bytes_per_run) << Config::CSV_DELIMITER
+            << optional_metric(hardware_counts ? instructions_per_cycle(perf_total) : -1.0)
+            << Config::CSV_DELIMITER
+            << optional_metric(per_inference(perf_total.cycles)) << Config::CSV_DELIMITER
+            << optional_metric(per_inference(perf_total.instructions)) << Config::CSV_DELIMITER
+            << optional_metric(per_inference(perf_total.cache_misses)) << Config::CSV_DELIMITER
+            << optional_metric(per_inference(perf_total.branch_misses)) << Config::CSV_DELIMITER
+            << optional_metric(hardware_counts && perf_total.instructions > 0
+                                   ? 1000.0 * static_cast<double>(perf_total.cache_misses) /
+                                     static_cast<double>(perf_total.instructions)
+                                   : -1.0) << Config::CSV_DELIMITER
+            << optional_metric(result.perf_collected ? result.perf.task_clock_ms : -1.0) << Config::CSV_DELIMITER
+            << optional_metric(result.perf_collected ? static_cast<int64_t>(result.perf.context_switches) : -1)
+            << Config::CSV_DELIMITER
+            << optional_metric(result.perf_collected ? static_cast<int64_t>(result.perf.cpu_migrations) : -1)
+            << Config::CSV_DELIMITER
+            << (hardware_counts ? format_cluster_cycles(result.perf) : "") << Config::CSV_DELIMITER
+            << (hardware_counts ? format_cluster_ipc(result.perf) : "") << Config::CSV_DELIMITER
+            << result.telemetry.cluster_freq_mhz << Config::CSV_DELIMITER
+            << optional_metric(result.telemetry.throttled_fraction) << Config::CSV_DELIMITER
+            << optional_metric(result.telemetry.temp_max_c >= 0.0 ? result.telemetry.temp_start_c : -1.0)
+            << Config::CSV_DELIMITER
+            << optional_metric(result.telemetry.temp_max_c) << Config::CSV_DELIMITER
+            << result.power.source << Config::CSV_DELIMITER
+            << optional_metric(result.power_collected ? static_cast<int64_t>(result.power.samples) : -1)
+            << Config::CSV_DELIMITER
+            << optional_metric(result.power.mean_w) << Config::CSV_DELIMITER
+            << optional_metric(result.power.peak_w) << Config::CSV_DELIMITER
+            << optional_metric(result.power.mean_current_ma) << Config::CSV_DELIMITER
+            << optional_metric(result.power.mean_voltage_mv) << Config::CSV_DELIMITER
+            << optional_metric(result.window_energy_j) << Config::CSV_DELIMITER
+            << optional_metric(result.energy_per_inference_j >= 0.0 ? result.energy_per_inference_j * 1000.0 : -1.0)
+            << Config::CSV_DELIMITER
+            << result.rail_energy_j << Config::CSV_DELIMITER
+            << (bench_case.iteration_log_file.empty() ? "" : std::to_string(result.iteration_log_dropped))
+            << Config::CSV_DELIMITER
+            << result.config_index << Config::CSV_DELIMITER
+            << batterystats_name << Config::CSV_DELIMITER
+            << result.stats_reset_epoch_ms << Config::CSV_DELIMITER
+            << result.measurement_start_epoch_ms << Config::CSV_DELIMITER
+            << result.measurement_end_epoch_ms << "\n";
+}
+
+bool export_worker_latency_csv(const std::string &output_file, const BenchmarkResult &result) {
+    std::ofstream file(output_file);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not create worker latency file: " << output_file << "\n";
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(Config::FLOAT_PRECISION);
+    file << "worker" << Config::CSV_DELIMITER
+            << "iterations" << Config::CSV_DELIMITER
+            << "latency_mean_us" << Config::CSV_DELIMITER
+            << "latency_stddev_us" << Config::CSV_DELIMITER
+            << "latency_min_us" << Config::CSV_DELIMITER
+            << "latency_p50_us" << Config::CSV_DELIMITER
+            << "latency_p90_us" << Config::CSV_DELIMITER
+            << "latency_p99_us" << Config::CSV_DELIMITER
+            << "latency_max_us" << "\n";
+
+    for (size_t worker = 0; worker < result.worker_latency.size(); ++worker) {
+        const LatencyHistogram &latency = *result.worker_latency[worker];
+        file << worker << Config::CSV_DELIMITER
+                << latency.count() << Config::CSV_DELIMITER
+                << ns_to_us(latency.mean_ns()) << Config::CSV_DELIMITER
+                << ns_to_us(latency.stddev_ns()) << Config::CSV_DELIMITER
+                << ns_to_us(static_cast<double>(latency.min_ns())) << Config::CSV_DELIMITER
+                << ns_to_us(static_cast<double>(latency.percentile_ns(50.0))) << Config::CSV_DELIMITER
+                << ns_to_us(static_cast<double>(latency.percentile_ns(90.0))) << Config::CSV_DELIMITER
+                << ns_to_us(static_cast<double>(latency.percentile_ns(99.0))) << Config::CSV_DELIMITER
+                << ns_to_us(static_cast<double>(latency.max_ns())) << "\n";
+    }
+
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Warning: Error writing to worker latency file\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "benchmark.hpp"
+
+// Get current timestamp in format: YYYYMMDD_HHMMSS
+std::string get_current_timestamp();
+
+// Helper function to sanitize filename
+std::string sanitize_filename(const std::string &filename);
+
+// Path of a per-run output file: <MEASUREMENTS_DIR>/<sanitized name>_<timestamp><suffix>
+std::string measurement_file_path(const std::string &name, const std::string &timestamp,
+                                  const std::string &suffix);
+
+// Performance CSV header and the row of one benchmark result (see AsyncFileWriter
+// for the file they are streamed to)
+void write_performance_csv_header(std::ostream &out);
+void write_performance_csv_row(std::ostream &out, const std::string &timestamp, const BenchmarkResult &result);
+
+// Export per-worker iteration counts and latency statistics, one row per worker
+bool export_worker_latency_csv(const std::string &output_file, const BenchmarkResult &result);
@@ -0,0 +1,166 @@
+#include "results_sink.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include "config.hpp"
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+bool AsyncFileWriter::open(const std::string &path, std::string &error) {
+    file_ = std::fopen(path.c_str(), "w");
+    if (file_ == nullptr) {
+        error = std::strerror(errno);
+        return false;
+    }
+    closing_ = false;
+    failed_ = false;
+    thread_ = std::thread([this]() { write_loop(); });
+    return true;
+}
+
+void AsyncFileWriter::append(std::string text) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(text));
+    }
+    queued_.notify_one();
+}
+
+bool AsyncFileWriter::close() {
+    if (file_ == nullptr) {
+        return !failed_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
+    queued_.notify_one();
+    thread_.join();
+    if (std::fclose(file_) != 0) {
+        failed_ = true;
+    }
+    file_ = nullptr;
+    return !failed_;
+}
+
+void AsyncFileWriter::write_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        queued_.wait(lock, [this]() { return closing_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;  // Closing, and everything is written
+        }
+        std::string text = std::move(pending_.front());
+        pending_.pop_front();
+
+        // Write outside the lock so that append() never waits on storage
+        lock.unlock();
+        if (std::fwrite(text.data(), 1, text.size(), file_) != text.size() || std::fflush(file_) != 0) {
+            failed_ = true;
+        }
+        lock.lock();
+    }
+}
+
+IterationLog::IterationLog(size_t workers, uint32_t latency_unit_ns)
+    : latency_unit_ns_(latency_unit_ns > 0 ? latency_unit_ns : 1),
+      producers_(std::make_unique<Producer[]>(workers)),
+      worker_count_(workers),
+      free_chunks_(workers * Config::ITERATION_LOG_CHUNKS_PER_WORKER),
+      full_chunks_(workers * Config::ITERATION_LOG_CHUNKS_PER_WORKER) {
+    // All chunks are allocated here, before the measurement window
+    for (size_t i = 0; i < workers * Config::ITERATION_LOG_CHUNKS_PER_WORKER; ++i) {
+        chunks_.push_back(std::make_unique<Chunk>());
+        chunks_.back()->records.resize(Config::ITERATION_LOG_CHUNK_RECORDS);
+        free_chunks_.try_push(chunks_.back().get());
+    }
+}
+
+IterationLog::~IterationLog() {
+    close();
+}
+
+bool IterationLog::open(const std::string &path, clock::time_point window_start, int64_t start_epoch_ns,
+                        std::string &error) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        error = std::strerror(errno);
+        return false;
+    }
+
+    IterationLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "ORITER1", 8);
+    header.header_size = sizeof(IterationLogHeader);
+    header.record_size = sizeof(IterationRecord);
+    header.latency_unit_ns = latency_unit_ns_;
+    header.workers = static_cast<uint32_t>(worker_count_);
+    header.start_epoch_ns = start_epoch_ns;
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        error = std::strerror(errno);
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+
+    window_start_ = window_start;
+    closing_.store(false);
+    writer_ = std::thread([this]() { write_loop(); });
+    return true;
+}
+
+void IterationLog::hand_over(Producer &producer) {
+    // The full queue holds every chunk, so this push cannot fail
+    full_chunks_.try_push(producer.chunk);
+    producer.chunk = nullptr;
+    free_chunks_.try_pop(producer.chunk);
+}
+
+bool IterationLog::close() {
+    if (file_ == nullptr) {
+        return !failed_;
+    }
+    for (size_t worker = 0; worker < worker_count_; ++worker) {
+        Producer &producer = producers_[worker];
+        if (producer.chunk != nullptr && producer.chunk->count > 0) {
+            hand_over(producer);
+        }
+    }
+    closing_.store(true, std::memory_order_release);
+    writer_.join();
+    if (std::fclose(file_) != 0) {
+        failed_ = true;
+    }
+    file_ = nullptr;
+    return !failed_;
+}
+
+void IterationLog::write_loop() {
+    Chunk *chunk = nullptr;
+    for (;;) {
+        // Read before popping: close() hands over the last chunks before setting
+        // the flag, so an empty queue after seeing it means everything is written
+        const bool closing = closing_.load(std::memory_order_acquire);
+        if (full_chunks_.try_pop(chunk)) {
+            if (!write_chunk(chunk)) {
+                failed_ = true;
+            }
+            chunk->count = 0;
+            free_chunks_.try_push(chunk);
+        } else if (closing) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(Config::ITERATION_LOG_WRITER_SLEEP_MS));
+        }
+    }
+}
+
+bool IterationLog::write_chunk(Chunk *chunk) {
+    if (std::fwrite(chunk->records.data(), sizeof(IterationRecord), chunk->count, file_) != chunk->count) {
+        return false;
+    }
+    written_ += chunk->count;
+    return true;
+}
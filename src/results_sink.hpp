@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "work_queue.hpp"
+
+// Append-only text file written by a background thread. append() queues the
+// text and returns; the thread writes and flushes it, so every finished window
+// is on storage even if a later one crashes, and the driver never waits on I/O.
+class AsyncFileWriter {
+public:
+    AsyncFileWriter() = default;
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter &) = delete;
+    AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+    bool open(const std::string &path, std::string &error);
+    bool is_open() const { return file_ != nullptr; }
+
+    void append(std::string text);
+
+    // Write what is queued and close the file. Returns false if a write failed.
+    bool close();
+
+private:
+    void write_loop();
+
+    std::FILE *file_ = nullptr;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable queued_;
+    std::deque<std::string> pending_;
+    bool closing_ = false;
+    bool failed_ = false;
+};
+
+// Per-iteration record of the binary iteration log (native little-endian)
+struct IterationRecord {
+    uint64_t start_ns;    // Since the start of the measurement window
+    uint32_t latency;     // In units of IterationLogHeader::latency_unit_ns, saturating
+    uint16_t worker;
+    uint16_t flags;       // IterationLog::MISSED_DEADLINE, ...
+};
+
+// Header at the start of an iteration log file
+struct IterationLogHeader {
+    char magic[8];           // "ORITER1\0"
+    uint32_t header_size;    // sizeof(IterationLogHeader)
+    uint32_t record_size;    // sizeof(IterationRecord)
+    uint32_t latency_unit_ns;
+    uint32_t workers;
+    int64_t start_epoch_ns;  // Wall-clock start of the measurement window
+};
+
+// Every measured iteration streamed to a binary file. Each worker fills its own
+// preallocated chunk of records and hands full chunks to a writer thread through
+// lock-free queues, so record() never blocks, allocates or touches the file. If
+// the writer falls behind and no free chunk is left, records are dropped and
+// counted rather than stalling the benchmark.
+class IterationLog {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr uint16_t MISSED_DEADLINE = 1;  // Paced run finished after the next one was due
+
+    IterationLog(size_t workers, uint32_t latency_unit_ns);
+    ~IterationLog();
+
+    IterationLog(const IterationLog &) = delete;
+    IterationLog &operator=(const IterationLog &) = delete;
+
+    // Create the file and start the writer; records are relative to window_start
+    bool open(const std::string &path, clock::time_point window_start, int64_t start_epoch_ns,
+              std::string &error);
+
+    // Called only from the given worker's thread
+    void record(size_t worker, clock::time_point start, clock::time_point end, uint16_t flags = 0) {
+        Producer &producer = producers_[worker];
+        if (producer.chunk == nullptr && !free_chunks_.try_pop(producer.chunk)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+                             static_cast<int64_t>(latency_unit_ns_);
+        IterationRecord &entry = producer.chunk->records[producer.chunk->count++];
+        entry.start_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - window_start_).count());
+        entry.latency = latency > static_cast<int64_t>(UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(latency);
+        entry.worker = static_cast<uint16_t>(worker);
+        entry.flags = flags;
+        if (producer.chunk->count == producer.chunk->records.size()) {
+            hand_over(producer);
+        }
+    }
+
+    // After the last record() of every worker: write the partial chunks, stop
+    // the writer, close the file. Returns false if a write failed.
+    bool close();
+
+    uint64_t written() const { return written_; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk {
+        std::vector<IterationRecord> records;
+        size_t count = 0;
+    };
+
+    // One cache line per worker, so that workers do not share their chunk pointers
+    struct alignas(64) Producer {
+        Chunk *chunk = nullptr;
+    };
+
+    void hand_over(Producer &producer);
+    void write_loop();
+    bool write_chunk(Chunk *chunk);
+
+    uint32_t latency_unit_ns_;
+    clock::time_point window_start_;
+    std::vector<std::unique_ptr<Chunk> > chunks_;
+    std::unique_ptr<Producer[]> producers_;
+    size_t worker_count_;
+    WorkQueue<Chunk *> free_chunks_;
+    WorkQueue<Chunk *> full_chunks_;
+
+    std::FILE *file_ = nullptr;
+    std::thread writer_;
+    std::atomic<bool> closing_{false};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t written_ = 0;
+    bool failed_ = false;
+};
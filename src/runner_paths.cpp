@@ -0,0 +1,27 @@
+#include "runner_paths.hpp"
+
+#include <cstdlib>
+#include "config.hpp"
+
+namespace {
+    std::string path_from_environment(const char *variable, const char *fallback) {
+        const char *value = std::getenv(variable);
+        return value != nullptr && value[0] != '\0' ? value : fallback;
+    }
+}
+
+const std::string &model_base_path() {
+    static const std::string path = path_from_environment(Config::MODEL_BASE_PATH_ENV, Config::MODEL_BASE_PATH);
+    return path;
+}
+
+const std::string &measurements_dir() {
+    static const std::string path = path_from_environment(Config::MEASUREMENTS_DIR_ENV, Config::MEASUREMENTS_DIR);
+    return path;
+}
+
+const std::string &optimized_model_dir() {
+    static const std::string path = path_from_environment(Config::OPTIMIZED_MODEL_DIR_ENV,
+                                                          Config::OPTIMIZED_MODEL_DIR);
+    return path;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+// Directories the runner reads models from and writes results to: the
+// Config defaults, or ONNX_RUNNER_MODEL_DIR / ONNX_RUNNER_MEASUREMENTS_DIR /
+// ONNX_RUNNER_OPTIMIZED_MODEL_DIR when set. Read once; later calls return
+// the same values.
+const std::string &model_base_path();
+const std::string &measurements_dir();
+const std::string &optimized_model_dir();
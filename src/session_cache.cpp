@@ -0,0 +1,67 @@
+#include "session_cache.hpp"
+
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+const CachedSession *SessionCache::find(const std::string &key) {
+    const auto found = index_.find(key);
+    if (found == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    stats_.setup_saved_ms += found->second->second.setup_ms;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return &entries_.front().second;
+}
+
+void SessionCache::insert(const std::string &key, CachedSession entry) {
+    if (capacity_ == 0) {
+        return;
+    }
+    const auto found = index_.find(key);
+    if (found != index_.end()) {
+        stats_.resident_kb -= found->second->second.resident_kb;
+        entries_.erase(found->second);
+        index_.erase(found);
+    }
+    stats_.resident_kb += entry.resident_kb;
+    entries_.emplace_front(key, std::move(entry));
+    index_[key] = entries_.begin();
+    while (entries_.size() > 1 &&
+           (entries_.size() > capacity_ || (budget_kb_ > 0 && stats_.resident_kb > budget_kb_))) {
+        evict_last();
+    }
+    stats_.entries = entries_.size();
+}
+
+void SessionCache::evict_last() {
+    stats_.resident_kb -= entries_.back().second.resident_kb;
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++stats_.evictions;
+}
+
+void SessionCache::clear() {
+    index_.clear();
+    entries_.clear();
+    stats_.entries = 0;
+    stats_.resident_kb = 0;
+}
+
+std::string session_cache_key(const std::string &model_path, const SessionConfig &config,
+                              const InputConfig &inputs) {
+    // A re-pushed model gets a new modification time, and so a new session
+    std::error_code ec;
+    const auto model_time = fs::last_write_time(model_path, ec);
+
+    std::ostringstream key;
+    key << model_path << "|" << (ec ? 0 : model_time.time_since_epoch().count())
+        << "|" << describe_session_config(config)
+        << "|xnnpack " << config.xnnpack_threads << "|nnapi " << nnapi_flags_name(config)
+        << "|" << describe_input_config(inputs);
+    return key.str();
+}
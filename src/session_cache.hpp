@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "inference_session.hpp"
+#include "model_inputs.hpp"
+#include "session_config.hpp"
+
+// A session kept warm, with what it cost to build
+struct CachedSession {
+    std::shared_ptr<InferenceSession> session;
+    int64_t resident_kb = 0;  // VmRSS growth while it was built (estimate of what it holds)
+    double setup_ms = 0.0;    // Time it took to build, saved by every reuse
+};
+
+// Cache activity since construction
+struct SessionCacheStats {
+    size_t entries = 0;
+    int64_t resident_kb = 0;  // Sum over the entries
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    double setup_saved_ms = 0.0;  // Build time of the sessions that hits reused
+};
+
+// Recently used sessions, so that a window for a model and configuration that
+// ran before skips loading and initialization (server jobs, batches and sweeps
+// where several windows share a session). Sessions stay warm together, which
+// is what an app that keeps several models loaded sees. The least recently used
+// sessions are released once more than capacity are held or their resident
+// memory exceeds the budget; the newest session is always kept.
+class SessionCache {
+public:
+    // budget_kb = 0: no memory limit
+    SessionCache(size_t capacity, int64_t budget_kb) : capacity_(capacity), budget_kb_(budget_kb) {}
+
+    SessionCache(const SessionCache &) = delete;
+    SessionCache &operator=(const SessionCache &) = delete;
+
+    // The cached session for key (now the most recently used), or null. Counts a
+    // hit or a miss; the pointer is valid until the next insert().
+    const CachedSession *find(const std::string &key);
+
+    // Add or replace the session for key, then evict down to capacity and budget
+    void insert(const std::string &key, CachedSession entry);
+
+    const SessionCacheStats &stats() const { return stats_; }
+    size_t capacity() const { return capacity_; }
+    int64_t budget_kb() const { return budget_kb_; }
+    void clear();
+
+private:
+    using Entry = std::pair<std::string, CachedSession>;
+
+    void evict_last();
+
+    size_t capacity_;
+    int64_t budget_kb_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    SessionCacheStats stats_;
+};
+
+// Cache key of a session: the model file (path and modification time), every
+// session option and everything that shapes the inputs
+std::string session_cache_key(const std::string &model_path, const SessionConfig &config,
+                              const InputConfig &inputs);
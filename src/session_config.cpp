@@ -0,0 +1,221 @@
+#include "session_config.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include "cpu_affinity.hpp"
+
+#ifdef __ANDROID__
+#include "nnapi_provider_factory.h"
+#endif
+
+namespace {
+    void append_execution_provider(Ort::SessionOptions &session_options, const SessionConfig &config) {
+        switch (config.execution_provider) {
+            case ExecutionProvider::Cpu:
+                break;
+            case ExecutionProvider::Xnnpack: {
+                const int threads = config.xnnpack_threads > 0 ? config.xnnpack_threads : config.intra_op_threads;
+                session_options.AppendExecutionProvider(
+                    "XNNPACK", {{"intra_op_num_threads", std::to_string(threads)}});
+                break;
+            }
+            case ExecutionProvider::Nnapi: {
+#ifdef __ANDROID__
+                uint32_t nnapi_flags = NNAPI_FLAG_USE_NONE;
+                if (config.nnapi_fp16) {
+                    nnapi_flags |= NNAPI_FLAG_USE_FP16;
+                }
+                if (config.nnapi_nchw) {
+                    nnapi_flags |= NNAPI_FLAG_USE_NCHW;
+                }
+                if (config.nnapi_cpu_disabled) {
+                    nnapi_flags |= NNAPI_FLAG_CPU_DISABLED;
+                }
+                if (config.nnapi_cpu_only) {
+                    nnapi_flags |= NNAPI_FLAG_CPU_ONLY;
+                }
+                Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nnapi(session_options, nnapi_flags));
+#else
+                throw std::runtime_error("NNAPI execution provider is only available on Android");
+#endif
+                break;
+            }
+        }
+    }
+}
+
+Ort::SessionOptions make_session_options(const SessionConfig &config) {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(config.intra_op_threads);
+    session_options.SetInterOpNumThreads(config.inter_op_threads);
+    session_options.SetExecutionMode(config.execution_mode);
+    session_options.SetGraphOptimizationLevel(config.graph_optimization_level);
+    if (config.mem_pattern) {
+        session_options.EnableMemPattern();
+    } else {
+        session_options.DisableMemPattern();
+    }
+    if (config.cpu_arena) {
+        session_options.EnableCpuMemArena();
+    } else {
+        session_options.DisableCpuMemArena();
+    }
+    if (config.shared_arena) {
+        session_options.AddConfigEntry("session.use_env_allocators", "1");
+    }
+
+    const char *spinning = config.allow_spinning ? "1" : "0";
+    session_options.AddConfigEntry("session.intra_op.allow_spinning", spinning);
+    session_options.AddConfigEntry("session.inter_op.allow_spinning", spinning);
+    for (const auto &entry: config.config_entries) {
+        session_options.AddConfigEntry(entry.first.c_str(), entry.second.c_str());
+    }
+
+    if (!config.optimized_model_path.empty()) {
+        session_options.SetOptimizedModelFilePath(config.optimized_model_path.c_str());
+    }
+
+    append_execution_provider(session_options, config);
+    return session_options;
+}
+
+const char *execution_mode_name(ExecutionMode mode) {
+    return mode == ORT_PARALLEL ? "parallel" : "sequential";
+}
+
+std::string cpu_mask_name(uint64_t cpu_mask) {
+    return cpu_mask != 0 ? format_cpu_mask(cpu_mask) : "all";
+}
+
+const char *execution_provider_name(ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::Xnnpack:
+            return "xnnpack";
+        case ExecutionProvider::Nnapi:
+            return "nnapi";
+        case ExecutionProvider::Cpu:
+        default:
+            return "cpu";
+    }
+}
+
+std::string nnapi_flags_name(const SessionConfig &config) {
+    std::string flags;
+    const auto add = [&flags](bool enabled, const char *name) {
+        if (enabled) {
+            flags += flags.empty() ? name : std::string("+") + name;
+        }
+    };
+    add(config.nnapi_fp16, "fp16");
+    add(config.nnapi_nchw, "nchw");
+    add(config.nnapi_cpu_disabled, "cpu_disabled");
+    add(config.nnapi_cpu_only, "cpu_only");
+    return flags.empty() ? "none" : flags;
+}
+
+const char *load_mode_name(ModelLoadMode mode) {
+    switch (mode) {
+        case ModelLoadMode::Buffer:
+            return "buffer";
+        case ModelLoadMode::Mmap:
+            return "mmap";
+        case ModelLoadMode::File:
+        default:
+            return "file";
+    }
+}
+
+const char *graph_optimization_level_name(GraphOptimizationLevel level) {
+    switch (level) {
+        case ORT_DISABLE_ALL:
+            return "disabled";
+        case ORT_ENABLE_BASIC:
+            return "basic";
+        case ORT_ENABLE_EXTENDED:
+            return "extended";
+        case ORT_ENABLE_ALL:
+        default:
+            return "all";
+    }
+}
+
+std::string config_entries_name(const SessionConfig &config) {
+    std::string text;
+    for (const auto &entry: config.config_entries) {
+        text += (text.empty() ? "" : ";") + entry.first + "=" + entry.second;
+    }
+    return text;
+}
+
+bool parse_execution_mode(const std::string &text, ExecutionMode &mode) {
+    if (text == "sequential") {
+        mode = ORT_SEQUENTIAL;
+    } else if (text == "parallel") {
+        mode = ORT_PARALLEL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_graph_optimization_level(const std::string &text, GraphOptimizationLevel &level) {
+    if (text == "disabled") {
+        level = ORT_DISABLE_ALL;
+    } else if (text == "basic") {
+        level = ORT_ENABLE_BASIC;
+    } else if (text == "extended") {
+        level = ORT_ENABLE_EXTENDED;
+    } else if (text == "all") {
+        level = ORT_ENABLE_ALL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_load_mode(const std::string &text, ModelLoadMode &mode) {
+    if (text == "file") {
+        mode = ModelLoadMode::File;
+    } else if (text == "buffer") {
+        mode = ModelLoadMode::Buffer;
+    } else if (text == "mmap") {
+        mode = ModelLoadMode::Mmap;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_execution_provider(const std::string &text, ExecutionProvider &provider) {
+    if (text == "cpu") {
+        provider = ExecutionProvider::Cpu;
+    } else if (text == "xnnpack") {
+        provider = ExecutionProvider::Xnnpack;
+    } else if (text == "nnapi") {
+        provider = ExecutionProvider::Nnapi;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string describe_session_config(const SessionConfig &config) {
+    std::ostringstream oss;
+    oss << "intra-op " << config.intra_op_threads
+        << ", inter-op " << config.inter_op_threads
+        << " (" << execution_mode_name(config.execution_mode)
+        << ", spinning " << (config.allow_spinning ? "on" : "off") << ")"
+        << ", graph opt " << graph_optimization_level_name(config.graph_optimization_level)
+        << ", mem pattern " << (config.mem_pattern ? "on" : "off")
+        << ", arena " << (config.cpu_arena ? (config.shared_arena ? "shared" : "on") : "off")
+        << ", CPU mask " << cpu_mask_name(config.cpu_mask)
+        << ", EP " << execution_provider_name(config.execution_provider)
+        << ", load " << load_mode_name(config.load_mode);
+    if (!config.config_entries.empty()) {
+        oss << ", config " << config_entries_name(config);
+    }
+    if (config.execution_provider == ExecutionProvider::Nnapi) {
+        oss << " (flags " << nnapi_flags_name(config) << ")";
+    }
+    return oss.str();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "config.hpp"
+
+// Execution providers the runner can register
+enum class ExecutionProvider {
+    Cpu,
+    Xnnpack,
+    Nnapi
+};
+
+// How the model file reaches ONNX Runtime
+enum class ModelLoadMode {
+    File,    // ONNX Runtime opens and reads the path itself
+    Buffer,  // Read into memory, then the bytes constructor
+    Mmap     // Memory-mapped, then the bytes constructor
+};
+
+// Session-level settings that affect how ONNX Runtime executes a model
+struct SessionConfig {
+    int intra_op_threads = Config::INTRA_OP_NUM_THREADS;
+    int inter_op_threads = Config::INTER_OP_NUM_THREADS;
+    ExecutionMode execution_mode = ORT_SEQUENTIAL;
+    bool allow_spinning = true;
+
+    // Graph and memory settings (ONNX Runtime's defaults)
+    GraphOptimizationLevel graph_optimization_level = ORT_ENABLE_ALL;
+    bool mem_pattern = true;
+    bool cpu_arena = true;
+
+    // Allocate from the CPU arena registered with the shared environment (see
+    // shared_ort_env) instead of a per-session one, so that cached sessions share it
+    bool shared_arena = false;
+
+    // Extra AddConfigEntry() key/value pairs, applied after the settings above
+    std::vector<std::pair<std::string, std::string> > config_entries;
+
+    // CPUs the driver thread (and therefore ORT's worker threads) run on; 0 = unrestricted
+    uint64_t cpu_mask = 0;
+
+    // Execution provider; nodes it cannot take fall back to the CPU provider
+    ExecutionProvider execution_provider = ExecutionProvider::Cpu;
+
+    // XNNPACK thread pool size; 0 = use intra_op_threads
+    int xnnpack_threads = 0;
+
+    // NNAPI flags (see nnapi_provider_factory.h)
+    bool nnapi_fp16 = false;          // Relax fp32 to fp16
+    bool nnapi_nchw = false;          // Use NCHW layout
+    bool nnapi_cpu_disabled = false;  // Do not let NNAPI use its reference CPU device
+    bool nnapi_cpu_only = false;      // Only use NNAPI's CPU device (for debugging)
+
+    ModelLoadMode load_mode = ModelLoadMode::File;
+
+    // Save the optimized graph here while creating the session (SetOptimizedModelFilePath);
+    // a ".ort" extension writes ORT format. Empty = do not save.
+    std::string optimized_model_path;
+};
+
+// Build ONNX Runtime session options from a session configuration
+Ort::SessionOptions make_session_options(const SessionConfig &config);
+
+// Human-readable names used in output and CSV columns
+const char *execution_mode_name(ExecutionMode mode);
+std::string cpu_mask_name(uint64_t cpu_mask);
+const char *execution_provider_name(ExecutionProvider provider);
+std::string nnapi_flags_name(const SessionConfig &config);
+const char *load_mode_name(ModelLoadMode mode);
+const char *graph_optimization_level_name(GraphOptimizationLevel level);
+
+// "key=value;..." summary of the extra config entries (empty if none)
+std::string config_entries_name(const SessionConfig &config);
+
+// Parse "sequential" or "parallel"
+bool parse_execution_mode(const std::string &text, ExecutionMode &mode);
+
+// Parse "disabled", "basic", "extended" or "all"
+bool parse_graph_optimization_level(const std::string &text, GraphOptimizationLevel &level);
+
+// Parse "file", "buffer" or "mmap"
+bool parse_load_mode(const std::string &text, ModelLoadMode &mode);
+
+// Parse "cpu", "xnnpack" or "nnapi"
+bool parse_execution_provider(const std::string &text, ExecutionProvider &provider);
+
+// One-line summary of the configuration for console output
+std::string describe_session_config(const SessionConfig &config);
@@ -0,0 +1,211 @@
+#include "tensor_file.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    constexpr char NPY_MAGIC[] = "\x93NUMPY";
+    constexpr size_t NPY_MAGIC_SIZE = 6;
+
+    bool ends_with(const std::string &text, const std::string &suffix) {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Map a NumPy dtype string such as "<f4" to an ONNX element type
+    bool npy_element_type(const std::string &descr, ONNXTensorElementDataType &type) {
+        if (descr.size() < 3 || (descr[0] != '<' && descr[0] != '|')) {
+            return false;  // Big-endian data is not supported
+        }
+        const std::string kind = descr.substr(1);
+        if (kind == "f4") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+        else if (kind == "f8") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE;
+        else if (kind == "f2") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+        else if (kind == "i1") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8;
+        else if (kind == "i2") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16;
+        else if (kind == "i4") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32;
+        else if (kind == "i8") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64;
+        else if (kind == "u1") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+        else if (kind == "u2") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16;
+        else if (kind == "u4") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32;
+        else if (kind == "u8") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64;
+        else if (kind == "b1") type = ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL;
+        else return false;
+        return true;
+    }
+
+    // Value of a quoted or bare key in the header dict, e.g. 'descr': '<f4'
+    bool header_value(const std::string &header, const std::string &key, std::string &value) {
+        const size_t key_pos = header.find("'" + key + "'");
+        if (key_pos == std::string::npos) {
+            return false;
+        }
+        size_t pos = header.find(':', key_pos);
+        if (pos == std::string::npos) {
+            return false;
+        }
+        pos = header.find_first_not_of(' ', pos + 1);
+        if (pos == std::string::npos) {
+            return false;
+        }
+
+        size_t end;
+        if (header[pos] == '\'') {
+            end = header.find('\'', pos + 1);
+            ++pos;
+        } else if (header[pos] == '(') {
+            end = header.find(')', pos) + 1;
+        } else {
+            end = header.find_first_of(",}", pos);
+        }
+        if (end == std::string::npos || end < pos) {
+            return false;
+        }
+        value = header.substr(pos, end - pos);
+        return true;
+    }
+
+    // Parse a shape tuple such as "(16, 3, 224, 224)" or "(8,)"
+    bool parse_shape_tuple(const std::string &text, std::vector<int64_t> &shape) {
+        shape.clear();
+        if (text.size() < 2 || text.front() != '(' || text.back() != ')') {
+            return false;
+        }
+        const char *cursor = text.c_str() + 1;
+        while (true) {
+            while (*cursor == ' ' || *cursor == ',') {
+                ++cursor;
+            }
+            if (*cursor == ')') {
+                return true;
+            }
+            char *end = nullptr;
+            const long long dim = std::strtoll(cursor, &end, 10);
+            if (end == cursor || dim < 0) {
+                return false;
+            }
+            shape.push_back(dim);
+            cursor = end;
+        }
+    }
+
+    bool parse_npy_header(TensorFile &file, std::string &error) {
+        const uint8_t *data = file.mapping->data();
+        const size_t size = file.mapping->size();
+        if (size < NPY_MAGIC_SIZE + 4 || std::memcmp(data, NPY_MAGIC, NPY_MAGIC_SIZE) != 0) {
+            error = "Not a .npy file";
+            return false;
+        }
+
+        // Version 1.0 has a 2-byte header length, 2.0 and 3.0 a 4-byte one
+        const uint8_t major_version = data[6];
+        size_t header_len;
+        size_t header_start;
+        if (major_version == 1) {
+            header_len = data[8] | (static_cast<size_t>(data[9]) << 8);
+            header_start = 10;
+        } else if (major_version == 2 || major_version == 3) {
+            if (size < 12) {
+                error = "Truncated .npy header";
+                return false;
+            }
+            header_len = data[8] | (static_cast<size_t>(data[9]) << 8) |
+                         (static_cast<size_t>(data[10]) << 16) | (static_cast<size_t>(data[11]) << 24);
+            header_start = 12;
+        } else {
+            error = "Unsupported .npy version " + std::to_string(major_version);
+            return false;
+        }
+        if (header_start + header_len > size) {
+            error = "Truncated .npy header";
+            return false;
+        }
+
+        const std::string header(reinterpret_cast<const char *>(data + header_start), header_len);
+        std::string descr;
+        std::string fortran_order;
+        std::string shape;
+        if (!header_value(header, "descr", descr) ||
+            !header_value(header, "fortran_order", fortran_order) ||
+            !header_value(header, "shape", shape)) {
+            error = "Malformed .npy header: " + header;
+            return false;
+        }
+        if (!npy_element_type(descr, file.element_type)) {
+            error = "Unsupported .npy dtype '" + descr + "'";
+            return false;
+        }
+        if (fortran_order != "False") {
+            error = "Fortran-order .npy arrays are not supported";
+            return false;
+        }
+        if (!parse_shape_tuple(shape, file.shape)) {
+            error = "Malformed .npy shape " + shape;
+            return false;
+        }
+
+        file.data_offset = header_start + header_len;
+        file.data_size = size - file.data_offset;
+        return true;
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        munmap(data_, size_);
+    }
+}
+
+bool MappedFile::open(const std::string &path, std::string &error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        error = "Cannot map empty or unreadable file " + path;
+        close(fd);
+        return false;
+    }
+
+    // Prefault the pages so that the first pass over a dataset does not take
+    // page faults inside the measured runs
+    void *mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                        MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        error = "Cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    data_ = static_cast<uint8_t *>(mapped);
+    size_ = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+bool open_tensor_file(const std::string &path, TensorFile &file, std::string &error) {
+    file = TensorFile();
+    file.mapping = std::make_shared<MappedFile>();
+    if (!file.mapping->open(path, error)) {
+        return false;
+    }
+
+    if (ends_with(path, ".npy")) {
+        file.is_npy = true;
+        if (!parse_npy_header(file, error)) {
+            error = path + ": " + error;
+            return false;
+        }
+    } else {
+        file.data_offset = 0;
+        file.data_size = file.mapping->size();
+    }
+    return true;
+}
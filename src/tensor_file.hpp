@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <onnxruntime_c_api.h>
+
+// Read-only, prefaulted memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Map the file. On failure returns false and sets error.
+    bool open(const std::string &path, std::string &error);
+
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Tensor data in a .npy file or a raw binary file, as a view into its mapping
+struct TensorFile {
+    std::shared_ptr<MappedFile> mapping;
+
+    // From the .npy header; raw files have no metadata (UNDEFINED type, empty shape)
+    bool is_npy = false;
+    ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape;
+
+    // Tensor bytes within the mapping
+    size_t data_offset = 0;
+    size_t data_size = 0;
+};
+
+// Map a tensor file. Files ending in ".npy" are parsed as NumPy arrays (little-endian,
+// C order); anything else is raw element data in the model's input type.
+bool open_tensor_file(const std::string &path, TensorFile &file, std::string &error);
@@ -0,0 +1,55 @@
+#include "warmup_monitor.hpp"
+
+#include <cmath>
+
+WarmupMonitor::WarmupMonitor(size_t window, double cv_threshold, std::chrono::nanoseconds min_duration,
+                             clock::time_point start)
+    : window_(window > 1 ? window : 2),
+      cv_threshold_(cv_threshold),
+      earliest_end_(start + std::chrono::duration_cast<clock::duration>(min_duration)),
+      latencies_us_(window_, 0.0) {
+}
+
+void WarmupMonitor::record(clock::time_point end, uint64_t latency_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_us_[recorded_ % window_] = static_cast<double>(latency_ns) / 1000.0;
+    ++recorded_;
+    if (recorded_ < window_) {
+        return;
+    }
+
+    // Recomputed from the buffer each run: a window is a few dozen values, and
+    // running sums would drift over long warmups
+    last_cv_ = window_cv();
+    stable_runs_ = last_cv_ < cv_threshold_ ? stable_runs_ + 1 : 0;
+    if (!converged_.load(std::memory_order_relaxed) && stable_runs_ >= window_ && end >= earliest_end_) {
+        converged_iterations_ = recorded_;
+        converged_.store(true, std::memory_order_release);
+    }
+}
+
+uint64_t WarmupMonitor::converged_iterations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return converged_iterations_;
+}
+
+double WarmupMonitor::cv() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_cv_;
+}
+
+double WarmupMonitor::window_cv() const {
+    double sum = 0.0;
+    for (const double value: latencies_us_) {
+        sum += value;
+    }
+    const double mean = sum / static_cast<double>(window_);
+    if (mean <= 0.0) {
+        return 0.0;
+    }
+    double squares = 0.0;
+    for (const double value: latencies_us_) {
+        squares += (value - mean) * (value - mean);
+    }
+    return std::sqrt(squares / static_cast<double>(window_ - 1)) / mean;
+}
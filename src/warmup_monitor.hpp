@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Adaptive warmup (--adaptive-warmup): keeps the latencies of the last `window`
+// runs and reports convergence once their coefficient of variation (stddev /
+// mean) has stayed below the threshold for another full window of runs, and the
+// phase has lasted at least min_duration. Caches, the DVFS governor and the arena
+// settle at very different speeds per model and device, so a fixed warmup either
+// wastes time or starts measuring while latency still drifts.
+//
+// record() takes a mutex so that pool workers can share one monitor; warmup runs
+// are not measured, so the uncontended lock does not matter.
+class WarmupMonitor {
+public:
+    using clock = std::chrono::steady_clock;
+
+    WarmupMonitor(size_t window, double cv_threshold, std::chrono::nanoseconds min_duration,
+                  clock::time_point start);
+
+    // One finished warmup run
+    void record(clock::time_point end, uint64_t latency_ns);
+
+    bool converged() const { return converged_.load(std::memory_order_acquire); }
+
+    // Runs recorded when it converged
+    uint64_t converged_iterations() const;
+
+    // Coefficient of variation of the last full window; -1 before the window is full
+    double cv() const;
+
+private:
+    double window_cv() const;
+
+    const size_t window_;
+    const double cv_threshold_;
+    const clock::time_point earliest_end_;
+
+    mutable std::mutex mutex_;
+    std::vector<double> latencies_us_;  // Ring buffer of the last window_ runs
+    uint64_t recorded_ = 0;
+    size_t stable_runs_ = 0;            // Consecutive runs with the window below the threshold
+    uint64_t converged_iterations_ = 0;
+    double last_cv_ = -1.0;
+    std::atomic<bool> converged_{false};
+};
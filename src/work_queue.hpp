@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded lock-free multi-producer/multi-consumer queue (Vyukov's array queue).
+// Every slot carries a sequence number that tells producers and consumers
+// whether it is free or filled for their ticket, so push and pop each take a
+// single CAS on the shared position in the uncontended case.
+template<typename T>
+class WorkQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit WorkQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    WorkQueue(const WorkQueue &) = delete;
+    WorkQueue &operator=(const WorkQueue &) = delete;
+
+    // Returns false if the queue is full
+    bool try_push(const T &value) {
+        size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[position & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false if the queue is empty
+    bool try_pop(T &value) {
+        size_t position = dequeue_position_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[position & mask_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (diff == 0) {
+                if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = slot.value;
+                    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = dequeue_position_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    // Producers and consumers update different positions; keep them on separate cache lines
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(CACHE_LINE) std::atomic<size_t> enqueue_position_{0};
+    alignas(CACHE_LINE) std::atomic<size_t> dequeue_position_{0};
+};
@@ -0,0 +1,159 @@
+#include "worker_pool.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "config.hpp"
+#include "rate_pacer.hpp"
+#include "work_queue.hpp"
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    // Spin briefly, then yield, then sleep, so idle threads do not burn a core
+    // (and skew the power measurement) while waiting on the queue
+    class Backoff {
+    public:
+        void reset() {
+            attempts_ = 0;
+        }
+
+        void pause() {
+            if (attempts_ < Config::WORKER_SPIN_ATTEMPTS) {
+                ++attempts_;
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(Config::WORKER_IDLE_SLEEP_US));
+            }
+        }
+
+    private:
+        int attempts_ = 0;
+    };
+}
+
+WorkerPool::WorkerPool(std::vector<RunFunction> run_functions)
+    : run_functions_(std::move(run_functions)) {
+}
+
+bool WorkerPool::run_for(std::chrono::nanoseconds duration, double target_rate_hz,
+                         const WorkerRecording &recording, WorkerPhaseStats &stats, std::string &error) {
+    // A couple of tickets per worker keeps every worker busy while bounding the
+    // work left to drain after the deadline
+    WorkQueue<WorkItem> queue(Config::WORKER_QUEUE_SLOTS_PER_WORKER * size());
+    std::atomic<bool> producing{true};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::vector<uint64_t> iterations(size(), 0);
+    std::atomic<uint64_t> missed_deadlines{0};
+
+    const auto start = clock::now();
+    std::unique_ptr<RatePacer> pacer;
+    if (target_rate_hz > 0.0) {
+        pacer = std::make_unique<RatePacer>(target_rate_hz, start);
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(size());
+    for (size_t worker = 0; worker < size(); ++worker) {
+        threads.emplace_back([&, worker]() {
+            LatencyHistogram *own_latency = recording.latency ? recording.worker_latency[worker] : nullptr;
+            uint64_t count = 0;
+            WorkItem item;
+            Backoff backoff;
+            while (!failed.load(std::memory_order_relaxed)) {
+                if (!queue.try_pop(item)) {
+                    if (!producing.load(std::memory_order_acquire)) {
+                        break;  // Drained after the deadline
+                    }
+                    backoff.pause();
+                    continue;
+                }
+                backoff.reset();
+
+                const auto run_start = clock::now();
+                try {
+                    run_functions_[worker]();
+                } catch (const std::exception &e) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!failed.exchange(true)) {
+                        error = e.what();
+                    }
+                    break;
+                }
+                const auto run_end = clock::now();
+                const auto latency_ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(run_end - run_start).count());
+                if (recording.latency) {
+                    recording.latency->record(latency_ns);
+                    own_latency->record(latency_ns);
+                }
+                if (recording.progress) {
+                    recording.progress->record_run(latency_ns);
+                }
+                if (recording.warmup) {
+                    recording.warmup->record(run_end, latency_ns);
+                }
+                const bool missed = pacer && pacer->missed(item.scheduled, run_end);
+                if (pacer) {
+                    if (recording.queue_delay) {
+                        recording.queue_delay->record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(run_start - item.scheduled).count()));
+                    }
+                    if (missed) {
+                        missed_deadlines.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (recording.iteration_log) {
+                    recording.iteration_log->record(worker, run_start, run_end,
+                                                    missed ? IterationLog::MISSED_DEADLINE : 0);
+                }
+                ++count;
+            }
+            iterations[worker] = count;
+        });
+    }
+
+    // Produce tickets until the deadline
+    const auto deadline = start + duration;
+    const auto stop_early = [&]() { return recording.stop_early && recording.stop_early(); };
+    WorkItem item;
+    Backoff backoff;
+    if (pacer) {
+        // A request that finds the queue full waits for a free slot; its delay
+        // shows up in the queue delay of the run
+        while (!failed.load(std::memory_order_relaxed) && !stop_early() && pacer->next() < deadline) {
+            item.scheduled = pacer->wait();
+            while (!queue.try_push(item) && !failed.load(std::memory_order_relaxed)) {
+                backoff.pause();
+            }
+            backoff.reset();
+            ++item.sequence;
+        }
+        // Idle time until the deadline belongs to the phase
+        if (!failed.load(std::memory_order_relaxed) && !stop_early() && clock::now() < deadline) {
+            sleep_until_absolute(deadline);
+        }
+    } else {
+        while (!failed.load(std::memory_order_relaxed) && !stop_early() && clock::now() < deadline) {
+            if (queue.try_push(item)) {
+                ++item.sequence;
+                backoff.reset();
+            } else {
+                backoff.pause();
+            }
+        }
+    }
+    producing.store(false, std::memory_order_release);
+
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    stats.elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    stats.iterations = 0;
+    for (const uint64_t count: iterations) {
+        stats.iterations += count;
+    }
+    stats.missed_deadlines = missed_deadlines.load();
+    return !failed.load();
+}
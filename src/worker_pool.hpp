@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "device_telemetry.hpp"
+#include "latency_histogram.hpp"
+#include "results_sink.hpp"
+#include "warmup_monitor.hpp"
+
+// Ticket handed from the producer to a worker
+struct WorkItem {
+    uint64_t sequence = 0;
+    std::chrono::steady_clock::time_point scheduled;  // When the request was due (paced phases)
+};
+
+// Iterations and wall time of one run_for() phase
+struct WorkerPhaseStats {
+    uint64_t iterations = 0;
+    double elapsed_ms = 0.0;
+    uint64_t missed_deadlines = 0;  // Paced phases only
+};
+
+// Histograms one run_for() phase records into; the default records nothing (warmup)
+struct WorkerRecording {
+    LatencyHistogram *latency = nullptr;            // Every run, all workers
+    std::vector<LatencyHistogram *> worker_latency; // Each worker's own runs (required with latency)
+    LatencyHistogram *queue_delay = nullptr;        // Due time to start of each run (paced phases)
+    RunProgress *progress = nullptr;                // Every run, for the telemetry sampler (any phase)
+    IterationLog *iteration_log = nullptr;          // Every run, one producer per worker
+    WarmupMonitor *warmup = nullptr;                // Every run (adaptive warmup)
+    std::function<bool()> stop_early;               // Polled by the producer; true ends the phase
+};
+
+// Worker threads that each run inferences pulled from a shared lock-free queue.
+// The calling thread is the producer. By default it keeps the queue topped up
+// (closed loop), so the workers are never starved and the pool measures
+// saturation throughput. With a target rate it issues requests on a fixed
+// schedule instead (open loop).
+class WorkerPool {
+public:
+    using RunFunction = std::function<void()>;
+
+    // One run function per worker; each is only called from its own worker thread
+    explicit WorkerPool(std::vector<RunFunction> run_functions);
+
+    size_t size() const { return run_functions_.size(); }
+
+    // Issue requests for the given duration (or until recording.stop_early), then
+    // let the workers drain the queue. target_rate_hz > 0 paces the requests (the
+    // phase then lasts at least the duration unless stopped early); 0 keeps every
+    // worker busy. Returns false (setting error) if a run throws.
+    bool run_for(std::chrono::nanoseconds duration, double target_rate_hz, const WorkerRecording &recording,
+                 WorkerPhaseStats &stats, std::string &error);
+
+private:
+    std::vector<RunFunction> run_functions_;
+};